@@ -0,0 +1,94 @@
+#ifndef BASIC_BLOCK_HPP
+#define BASIC_BLOCK_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "encoding.hpp"
+#include "isim.hpp"
+#include "instruction.hpp"
+
+namespace rv32i_sim {
+
+constexpr std::size_t MAX_BLOCK_INSNS = 64; // decoded insns per block at most
+
+/// @brief how control leaves a basic block
+enum class BlockExit : uint8_t {
+  FALLTHROUGH = 0, //< block was cut by MAX_BLOCK_INSNS
+  BRANCH = 1, //< conditional branch
+  JUMP = 2, //< jal/jalr which is neither call nor return
+  CALL = 3, //< jal/jalr linking into ra
+  RETURN = 4, //< jalr x0, 0(ra)
+  SYSTEM = 5, //< ecall, ebreak, csr access
+  UNDEF = 6, //< undefined insn, it traps or execution stops on it
+  TRAP = 7, //< an insn trapped, block holds only the insns retired before it
+};
+
+/// @brief straight-line sequence of decoded insns with a single entry
+/// @brief and a single exit (its last insn)
+struct BasicBlock {
+  addr_t start_pc = 0; ///< address of the first insn
+  addr_t end_pc = 0; ///< address right after the last insn
+  BlockExit exit = BlockExit::FALLTHROUGH;
+  std::vector<std::unique_ptr<IInsn>> insns;
+
+  std::size_t size() const { return insns.size(); }
+
+  // undefined insn can only be the last one and it does not retire
+  std::size_t retired() const { return insns.size() - (exit == BlockExit::UNDEF); }
+
+  // insns are 2 or 4 bytes long, blocks are short enough to walk them
+  addr_t insnPC(std::size_t idx) const {
+    addr_t pc = start_pc;
+    for (std::size_t i = 0; i != idx; ++i) pc += insns[i]->getSize();
+
+    return pc;
+  }
+
+  /// @return index of insn at pc, size() if pc is not in the block
+  std::size_t insnIndex(addr_t pc) const {
+    std::size_t idx = 0;
+    for (addr_t insn_pc = start_pc; idx != size() && insn_pc != pc; ++idx)
+      insn_pc += insns[idx]->getSize();
+
+    return idx;
+  }
+};
+
+/// @brief find out whether an insn ends a basic block and how
+/// @return FALLTHROUGH if insn does not end a block
+inline BlockExit classifyInsn(const IInsn& insn) {
+  addr_t code = insn.getCode();
+  addr_t opcode = code & DEFAULT_OPCODE_MASK;
+  addr_t rd = (code & DEFAULT_RD_MASK) >> 7;
+  addr_t rs1 = (code & DEFAULT_RS1_MASK) >> 15;
+
+  constexpr addr_t RA = static_cast<addr_t>(Register::X1);
+
+  if (insn.getType() == RVInsnType::UNDEF_TYPE_INSN) return BlockExit::UNDEF;
+
+  switch (opcode)
+  {
+  case RV_B_TYPE_OPCODE:
+    return BlockExit::BRANCH;
+
+  case RV_JAL_OPCODE:
+    return rd == RA ? BlockExit::CALL : BlockExit::JUMP;
+
+  case RV_IJALR_TYPE_OPCODE:
+    if (rd == RA) return BlockExit::CALL;
+    if (rd == 0 && rs1 == RA) return BlockExit::RETURN;
+    return BlockExit::JUMP;
+
+  case RV_SYSTEM_I_OPCODE:
+    return BlockExit::SYSTEM;
+
+  default:
+    return BlockExit::FALLTHROUGH;
+  }
+}
+
+} // rv32i_sim
+
+#endif // BASIC_BLOCK_HPP
@@ -0,0 +1,112 @@
+#ifndef BPRED_HPP
+#define BPRED_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "basic_block.hpp"
+#include "encoding.hpp"
+#include "exec_observer.hpp"
+#include "symbols.hpp"
+
+namespace rv32i_sim {
+
+constexpr unsigned DEFAULT_BPRED_TABLE_BITS = 12; // log2 of counters in table
+constexpr unsigned DEFAULT_BTB_BITS = 9; // log2 of BTB entries
+constexpr unsigned DEFAULT_RAS_DEPTH = 16;
+constexpr unsigned DEFAULT_BPRED_TOP = 10; // branches in report
+
+enum class BPredKind : uint8_t {
+  STATIC = 0, //< backward taken, forward not taken
+  BIMODAL = 1, //< 2-bit counters indexed by pc
+  GSHARE = 2, //< 2-bit counters indexed by pc xor global history
+};
+
+struct BPredConfig {
+  BPredKind kind = BPredKind::GSHARE;
+  unsigned table_bits = DEFAULT_BPRED_TABLE_BITS; ///< also history length for gshare
+  unsigned btb_bits = DEFAULT_BTB_BITS;
+  unsigned ras_depth = DEFAULT_RAS_DEPTH;
+
+  /// @brief parse "static", "bimodal" or "gshare"
+  static std::optional<BPredKind> parseKind(const std::string& str);
+};
+
+/// @brief branch predictor driven by outcomes of executed blocks
+///
+/// every block ends with at most one control transfer, so the predictor
+/// looks only at the last insn of a block:
+/// conditional branches go to direction predictor (and BTB when taken),
+/// jumps and calls to BTB, returns to return address stack.
+class BranchPredictor final : public IExecObserver {
+public:
+  struct BranchStats {
+    uint64_t executed = 0;
+    uint64_t taken = 0;
+    uint64_t mispredicted = 0;
+  };
+
+private:
+  struct BTBEntry {
+    addr_t pc = 0;
+    addr_t target = 0;
+    bool valid = false;
+  };
+
+  BPredConfig config_;
+  addr_t table_mask_ = 0;
+  addr_t btb_mask_ = 0;
+
+  std::vector<uint8_t> counters_; ///< 2-bit saturating, >= 2 means taken
+  addr_t history_ = 0; ///< global, newest outcome in bit 0
+  std::vector<BTBEntry> btb_;
+  std::vector<addr_t> ras_; ///< circular, overflow overwrites the oldest
+  std::size_t ras_top_ = 0;
+  std::size_t ras_size_ = 0;
+
+  std::unordered_map<addr_t, BranchStats> branches_; ///< by branch pc
+
+  uint64_t btb_lookups_ = 0;
+  uint64_t btb_misses_ = 0; ///< no entry or wrong target
+  uint64_t returns_ = 0;
+  uint64_t ras_misses_ = 0;
+
+  std::size_t counterIdx(addr_t pc) const;
+  bool predictDirection(addr_t pc, addr_t code) const;
+  void updateDirection(addr_t pc, bool taken);
+
+  // @return true if BTB had the right target
+  bool lookupBTB(addr_t pc, addr_t target);
+
+  void pushRAS(addr_t ret_addr);
+  std::optional<addr_t> popRAS();
+
+public:
+  BranchPredictor(const BPredConfig& config = BPredConfig {});
+
+  void onBlock(const BasicBlock& block, addr_t next_pc, uint64_t instret) override;
+
+  // add up statistics, predictor state is left as is
+  void merge(const BranchPredictor& other);
+
+  const std::unordered_map<addr_t, BranchStats>& getBranches() const;
+
+  uint64_t nBranches() const;
+  uint64_t nMispredicted() const;
+  uint64_t nBTBLookups() const { return btb_lookups_; }
+  uint64_t nBTBMisses() const { return btb_misses_; }
+  uint64_t nReturns() const { return returns_; }
+  uint64_t nRASMisses() const { return ras_misses_; }
+
+  /// @brief print aggregate accuracy and top_n branches by mispredictions
+  std::ostream& report(std::ostream& out, const SymbolTable& symbols,
+                       unsigned top_n = DEFAULT_BPRED_TOP) const;
+};
+
+} // rv32i_sim
+
+#endif // BPRED_HPP
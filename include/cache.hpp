@@ -0,0 +1,116 @@
+#ifndef CACHE_HPP
+#define CACHE_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "basic_block.hpp"
+#include "encoding.hpp"
+#include "exec_observer.hpp"
+#include "memory.hpp"
+
+namespace rv32i_sim {
+
+enum class ReplacePolicy : uint8_t {
+  LRU = 0,
+  RANDOM = 1,
+};
+
+struct CacheConfig {
+  uint32_t size = 32 * 1024; ///< bytes
+  uint32_t ways = 4;
+  uint32_t line_size = 64; ///< bytes
+  ReplacePolicy policy = ReplacePolicy::LRU;
+
+  uint32_t nSets() const { return size / (ways * line_size); }
+
+  /// @brief geometry is power of 2 and fits the size
+  bool isValid() const;
+
+  /// @brief parse "size:ways:line[:lru|random]", size may end with K or M
+  static std::optional<CacheConfig> parse(const std::string& str);
+};
+
+std::ostream& operator<<(std::ostream& out, const CacheConfig& config);
+
+/// @brief set associative cache, only tags are modeled
+class CacheModel final {
+  struct Line {
+    addr_t tag = 0;
+    uint64_t last_use = 0; ///< for LRU
+    bool valid = false;
+  };
+
+  CacheConfig config_;
+  unsigned line_shift_ = 0;
+  addr_t set_mask_ = 0;
+
+  std::vector<Line> lines_; ///< nSets() * ways, ways of one set are contiguous
+  uint64_t tick_ = 0;
+  std::minstd_rand rand_; ///< default seed, so runs are reproducible
+
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+
+public:
+  CacheModel(const CacheConfig& config);
+
+  /// @brief access the line holding addr
+  /// @return true on hit
+  bool access(addr_t addr);
+
+  // account accesses to the line which is known to be most recently used
+  void addHits(uint64_t n) { hits_ += n; }
+
+  addr_t lineOf(addr_t addr) const { return addr >> line_shift_; }
+
+  const CacheConfig& getConfig() const { return config_; }
+  uint64_t nAccesses() const { return hits_ + misses_; }
+  uint64_t nHits() const { return hits_; }
+  uint64_t nMisses() const { return misses_; }
+
+  // add up statistics of caches of the same geometry, e.g. from separate intervals
+  void mergeStats(const CacheModel& other);
+
+  /// @brief misses per thousand insns
+  double mpki(uint64_t instret) const;
+
+  std::ostream& report(std::ostream& out, const std::string& name, uint64_t instret) const;
+};
+
+/// @brief insn cache, fed by fetches of executed blocks
+///
+/// block insns are sequential, so only the first fetch from each line
+/// goes to the cache, the rest of the line is a guaranteed hit
+class ICacheObserver final : public IExecObserver {
+  CacheModel cache_;
+
+public:
+  ICacheObserver(const CacheConfig& config) : cache_(config) {}
+
+  void onBlock(const BasicBlock& block, addr_t next_pc, uint64_t instret) override;
+
+  void merge(const ICacheObserver& other) { cache_.mergeStats(other.cache_); }
+  const CacheModel& getCache() const { return cache_; }
+};
+
+/// @brief data cache, fed by loads and stores of MemoryModel
+class DCacheObserver final : public IMemObserver {
+  CacheModel cache_;
+
+public:
+  DCacheObserver(const CacheConfig& config) : cache_(config) {}
+
+  void onAccess(addr_t addr, unsigned size, MemAccess type) override;
+
+  void merge(const DCacheObserver& other) { cache_.mergeStats(other.cache_); }
+  const CacheModel& getCache() const { return cache_; }
+};
+
+} // rv32i_sim
+
+#endif // CACHE_HPP
@@ -0,0 +1,85 @@
+#ifndef CALLSTACK_HPP
+#define CALLSTACK_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "basic_block.hpp"
+#include "encoding.hpp"
+#include "exec_observer.hpp"
+#include "symbols.hpp"
+
+namespace rv32i_sim {
+
+/// @brief function profiler based on shadow call stack
+///
+/// calls and returns are recognized by the standard link convention:
+/// jal/jalr writing ra is a call, jalr x0, 0(ra) is a return.
+/// Everything is accounted once per block: retired insns of a block go
+/// to the function on top of the shadow stack.
+class CallStackProfiler final : public IExecObserver {
+public:
+  struct FuncStats {
+    uint64_t calls = 0;
+    uint64_t inclusive = 0; ///< insns retired in function and its callees
+    uint64_t exclusive = 0; ///< insns retired in function itself
+    unsigned active = 0; ///< frames of function on stack (recursion)
+  };
+
+  struct CallEdge {
+    uint64_t calls = 0;
+    uint64_t inclusive = 0;
+  };
+
+private:
+  // caller, callee, call site
+  using EdgeKey = std::tuple<addr_t, addr_t, addr_t>;
+
+  struct Frame {
+    addr_t func;
+    uint64_t enter_instret;
+    FuncStats* stats; ///< pointers are stable in unordered_map
+    CallEdge* edge; ///< nullptr for root frames
+  };
+
+  const SymbolTable& symbols_;
+
+  std::unordered_map<addr_t, FuncStats> funcs_;
+  std::map<EdgeKey, CallEdge> edges_;
+  std::vector<Frame> stack_;
+
+  std::size_t max_depth_ = 0;
+  uint64_t instret_ = 0; ///< last seen
+
+  addr_t funcOf(addr_t pc) const;
+  void push(addr_t func, uint64_t instret, CallEdge* edge);
+  void pop(uint64_t instret);
+
+  // stats with frames which are still on stack closed at current instret
+  std::unordered_map<addr_t, FuncStats> closedFuncs() const;
+  std::map<EdgeKey, CallEdge> closedEdges() const;
+
+  std::string nameOf(addr_t func) const;
+
+public:
+  CallStackProfiler(const SymbolTable& symbols) : symbols_(symbols) {}
+
+  void onBlock(const BasicBlock& block, addr_t next_pc, uint64_t instret) override;
+
+  std::size_t maxDepth() const;
+  std::size_t depth() const;
+  const std::unordered_map<addr_t, FuncStats>& getFuncs() const;
+
+  std::ostream& report(std::ostream& out) const;
+
+  /// @brief dump profile in callgrind format (open with kcachegrind)
+  std::ostream& dumpCallgrind(std::ostream& out) const;
+};
+
+} // rv32i_sim
+
+#endif // CALLSTACK_HPP
@@ -0,0 +1,28 @@
+#ifndef COMPRESSED_HPP
+#define COMPRESSED_HPP
+
+#include <cstdint>
+#include <optional>
+
+#include "encoding.hpp"
+
+namespace rv32i_sim {
+
+constexpr half_t RVC_QUADRANT_MASK = 0b11; // quadrant 0b11 holds 32-bit insns
+
+/// @brief true if 16-bit parcel at insn address starts a compressed insn
+inline bool isCompressed(half_t parcel) {
+  return (parcel & RVC_QUADRANT_MASK) != RVC_QUADRANT_MASK;
+}
+
+/// @brief expand RV32C (RV64C on RV64) insn to the equivalent 32-bit one
+///
+/// every compressed insn is an alias of a base one, so they are decoded
+/// and executed as such, only insn size differs
+/// @return nullopt for illegal and reserved encodings,
+/// @return and for the ones of extensions not supported (c.fld, c.fsd...)
+std::optional<word_t> expandCompressed(half_t code);
+
+} // rv32i_sim
+
+#endif // COMPRESSED_HPP
@@ -0,0 +1,101 @@
+#ifndef CSR_HPP
+#define CSR_HPP
+
+#include <cstdint>
+
+#include "encoding.hpp"
+
+namespace rv32i_sim {
+
+using csr_t = uint16_t; // 12-bit CSR address
+
+// floating point (F extension)
+constexpr csr_t CSR_FFLAGS = 0x001;
+constexpr csr_t CSR_FRM    = 0x002;
+constexpr csr_t CSR_FCSR   = 0x003;
+
+// vector (V extension), vl, vtype and vlenb are read-only
+constexpr csr_t CSR_VSTART = 0x008;
+constexpr csr_t CSR_VL     = 0xC20;
+constexpr csr_t CSR_VTYPE  = 0xC21;
+constexpr csr_t CSR_VLENB  = 0xC22;
+
+// unprivileged counters/timers (read-only)
+constexpr csr_t CSR_CYCLE    = 0xC00;
+constexpr csr_t CSR_TIME     = 0xC01;
+constexpr csr_t CSR_INSTRET  = 0xC02;
+constexpr csr_t CSR_CYCLEH   = 0xC80;
+constexpr csr_t CSR_TIMEH    = 0xC81;
+constexpr csr_t CSR_INSTRETH = 0xC82;
+
+// machine counters (read-write)
+constexpr csr_t CSR_MCYCLE    = 0xB00;
+constexpr csr_t CSR_MINSTRET  = 0xB02;
+constexpr csr_t CSR_MCYCLEH   = 0xB80;
+constexpr csr_t CSR_MINSTRETH = 0xB82;
+
+// machine trap setup and handling, the only privileged CSRs of the core
+constexpr csr_t CSR_MSTATUS  = 0x300;
+constexpr csr_t CSR_MIE      = 0x304;
+constexpr csr_t CSR_MTVEC    = 0x305;
+constexpr csr_t CSR_MSCRATCH = 0x340;
+constexpr csr_t CSR_MEPC     = 0x341;
+constexpr csr_t CSR_MCAUSE   = 0x342;
+constexpr csr_t CSR_MTVAL    = 0x343;
+constexpr csr_t CSR_MIP      = 0x344;
+constexpr csr_t CSR_MHARTID  = 0xF14;
+
+constexpr csr_t CSR_ADDR_MASK = 0xFFF;
+
+// mstatus fields, there is M-mode only, so MPP always reads as M
+constexpr reg_t MSTATUS_MIE  = 1 << 3;
+constexpr reg_t MSTATUS_MPIE = 1 << 7;
+constexpr reg_t MSTATUS_MPP  = 3 << 11;
+
+// mip and mie bits of interrupts from CLINT, mip ones are read-only
+constexpr reg_t MIP_MSIP = 1 << 3;
+constexpr reg_t MIP_MTIP = 1 << 7;
+
+constexpr reg_t MTVEC_MODE_MASK = 0b11;
+constexpr reg_t MTVEC_VECTORED  = 0b01; //< interrupts jump to base + 4 * cause
+
+/// @brief mcause of exceptions, interrupts have MCAUSE_INTERRUPT set
+enum class TrapCause : reg_t {
+  INSN_MISALIGNED = 0,
+  INSN_ACCESS_FAULT = 1,
+  ILLEGAL_INSN = 2,
+  BREAKPOINT = 3,
+  LOAD_MISALIGNED = 4,
+  LOAD_ACCESS_FAULT = 5,
+  STORE_MISALIGNED = 6,
+  STORE_ACCESS_FAULT = 7,
+  ECALL_M = 11,
+};
+
+constexpr reg_t MCAUSE_INTERRUPT = reg_t(1) << (XLEN - 1);
+constexpr reg_t IRQ_M_SOFTWARE = 3; //< cause code is the bit of mip
+constexpr reg_t IRQ_M_TIMER = 7;
+
+/// @brief M-mode trap CSRs of the model
+struct TrapCSRs {
+  reg_t mstatus = 0; ///< MIE and MPIE only
+  reg_t mie = 0;
+  reg_t mip = 0;
+  reg_t mtvec = 0; ///< 0 means there is no trap handler
+  reg_t mscratch = 0;
+  reg_t mepc = 0;
+  reg_t mcause = 0;
+  reg_t mtval = 0;
+
+  bool operator==(const TrapCSRs& other) const = default;
+};
+
+// csr[11:10] == 0b11 means the CSR is read-only
+constexpr bool isCSRReadOnly(csr_t csr) { return (csr >> 10) == 0b11; }
+
+constexpr word_t lo32(uint64_t val) { return static_cast<word_t>(val); }
+constexpr word_t hi32(uint64_t val) { return static_cast<word_t>(val >> 32); }
+
+} // rv32i_sim
+
+#endif // CSR_HPP
@@ -0,0 +1,69 @@
+#ifndef DEVICE_HPP
+#define DEVICE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "encoding.hpp"
+
+namespace rv32i_sim {
+
+constexpr unsigned DEVICE_PAGE_BITS = 12;
+constexpr addr_t DEVICE_PAGE_SIZE = addr_t(1) << DEVICE_PAGE_BITS; ///< granule of device ranges
+
+/// @brief memory-mapped device: guest loads and stores in its range go to it
+///
+/// offset is from the start of the range, size is 1, 2, 4 or 8 bytes,
+/// value is little endian as it is in memory
+class IDevice {
+public:
+  virtual dword_t read(addr_t offset, unsigned size) = 0;
+  virtual void write(addr_t offset, unsigned size, dword_t val) = 0;
+
+  virtual ~IDevice() = default;
+};
+
+/// @brief routes guest accesses of device pages to devices
+///
+/// every page of guest address space has an entry telling which device it
+/// belongs to (0 for memory), so memory accesses pay a single table lookup,
+/// not a search over device ranges
+class DeviceBus final {
+  struct Mapping {
+    addr_t base;
+    addr_t size;
+    IDevice* device; ///< not owned
+  };
+
+  std::vector<Mapping> devices_;
+  std::vector<uint8_t> pages_; ///< index in devices_ + 1, up to the last device page
+
+  const Mapping* find(addr_t addr) const {
+    std::size_t page = addr >> DEVICE_PAGE_BITS;
+    if (page >= pages_.size() || !pages_[page]) return nullptr;
+
+    return &devices_[pages_[page] - 1];
+  }
+
+public:
+  /// @brief map device to [base, base + size), base and size are rounded to pages
+  /// @return false if range overlaps another device, or there are too many of them
+  bool attach(addr_t base, addr_t size, IDevice* device);
+
+  bool empty() const { return devices_.empty(); }
+
+  /// @brief true if addr lies in a page of some device
+  bool isDevicePage(addr_t addr) const {
+    std::size_t page = addr >> DEVICE_PAGE_BITS;
+    return page < pages_.size() && pages_[page];
+  }
+
+  /// @brief access of a device page, offset is from the base rounded down to page
+  dword_t read(addr_t addr, unsigned size) const;
+  void write(addr_t addr, unsigned size, dword_t val) const;
+};
+
+} // rv32i_sim
+
+#endif // DEVICE_HPP
@@ -0,0 +1,118 @@
+#ifndef DEVICES_HPP
+#define DEVICES_HPP
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+#include "device.hpp"
+#include "encoding.hpp"
+#include "exec_env.hpp"
+#include "scheduler.hpp"
+
+namespace rv32i_sim {
+
+// the same places as on QEMU virt machine, so firmware built for it runs as is
+constexpr addr_t SYSCON_BASE = 0x00100000;
+constexpr addr_t SYSCON_SIZE = 0x1000;
+constexpr addr_t CLINT_BASE  = 0x02000000;
+constexpr addr_t CLINT_SIZE  = 0x10000;
+constexpr addr_t UART_BASE   = 0x10000000;
+constexpr addr_t UART_SIZE   = 0x100;
+
+// 16550 registers, offsets of byte registers
+constexpr addr_t UART_THR = 0; ///< transmit holding (write), receive buffer (read)
+constexpr addr_t UART_IIR = 2; ///< interrupt identification (read)
+constexpr addr_t UART_LCR = 3; ///< line control
+constexpr addr_t UART_LSR = 5; ///< line status
+
+constexpr byte_t UART_LCR_DLAB = 0x80; ///< THR and IER are divisor latch
+constexpr byte_t UART_LSR_IDLE = 0x60; ///< THR empty, transmitter empty
+constexpr byte_t UART_IIR_NONE = 0x01; ///< no interrupt pending
+
+// CLINT registers of hart 0
+constexpr addr_t CLINT_MSIP     = 0x0;
+constexpr addr_t CLINT_MTIMECMP = 0x4000;
+constexpr addr_t CLINT_MTIME    = 0xbff8;
+
+// values written to syscon (SiFive test finisher), status of fail is in high half
+constexpr word_t SYSCON_FAIL  = 0x3333;
+constexpr word_t SYSCON_PASS  = 0x5555;
+constexpr word_t SYSCON_RESET = 0x7777;
+
+/// @brief 16550 UART, transmitted bytes go to guest console
+///
+/// there is no input: receive buffer is always empty, transmitter never busy,
+/// so polling firmware does not wait, other registers keep what is written
+class Uart final : public IDevice {
+  ExecEnv& env_;
+  std::array<byte_t, 8> regs_ {};
+  std::array<byte_t, 2> divisor_ {}; ///< divisor latch, THR and IER when DLAB is set
+
+public:
+  explicit Uart(ExecEnv& env) : env_(env) {}
+
+  dword_t read(addr_t offset, unsigned size) override;
+  void write(addr_t offset, unsigned size, dword_t val) override;
+};
+
+/// @brief core local interruptor of a single hart: msip, mtimecmp and mtime
+///
+/// mtime is read from the time source (e.g. retired insn count) and only
+/// offset by writes, so it never has to be ticked. When connected to events,
+/// mtimecmp is an event: on_timer is told when timer interrupt becomes
+/// pending at it, or stops being pending when mtimecmp or mtime is written,
+/// on_software is told about writes to msip
+class Clint final : public IDevice {
+public:
+  using IrqCallback = std::function<void(bool pending)>;
+
+private:
+  std::function<uint64_t()> time_;
+  uint64_t time_offset_ = 0; ///< mtime - time source
+  uint64_t mtimecmp_ = UINT64_MAX;
+  word_t msip_ = 0;
+
+  EventScheduler* events_ = nullptr; ///< not owned
+  EventScheduler::EventId timer_event_ = 0;
+  IrqCallback on_timer_;
+  IrqCallback on_software_;
+
+  void scheduleTimer();
+
+public:
+  explicit Clint(std::function<uint64_t()> time) : time_(std::move(time)) {}
+
+  /// @param events clock of events must be the time source
+  void connect(EventScheduler* events, IrqCallback on_timer, IrqCallback on_software = {});
+
+  dword_t read(addr_t offset, unsigned size) override;
+  void write(addr_t offset, unsigned size, dword_t val) override;
+
+  uint64_t getMtime() const { return time_() + time_offset_; }
+  uint64_t getMtimecmp() const { return mtimecmp_; }
+
+  bool timerPending() const { return getMtime() >= mtimecmp_; }
+  bool softwarePending() const { return msip_ & 1; }
+};
+
+/// @brief poweroff device: writes of PASS or FAIL stop the model with exit status,
+/// @brief reset is not supported, it stops the model with no status
+class Syscon final : public IDevice {
+public:
+  using PowerOff = std::function<void(std::optional<word_t> status)>;
+
+private:
+  PowerOff power_off_;
+
+public:
+  explicit Syscon(PowerOff power_off) : power_off_(std::move(power_off)) {}
+
+  dword_t read(addr_t, unsigned) override { return 0; }
+  void write(addr_t offset, unsigned size, dword_t val) override;
+};
+
+} // rv32i_sim
+
+#endif // DEVICES_HPP
@@ -4,9 +4,75 @@
 #include <cstdint>
 #include <bitset>
 
+// XLEN is fixed at compile time: the same sources build RV32 (default)
+// and RV64 (-DRVSIM_XLEN=64) models, so neither checks XLEN at run time
+#ifndef RVSIM_XLEN
+#define RVSIM_XLEN 32
+#endif
+
+// extensions of the modelled core are fixed at compile time as well
+// (all of them by default): decoders and execute handlers of disabled
+// ones are compiled out and their insns are illegal as on that core
+#ifndef RVSIM_EXT_M
+#define RVSIM_EXT_M 1
+#endif
+#ifndef RVSIM_EXT_C
+#define RVSIM_EXT_C 1
+#endif
+#ifndef RVSIM_EXT_F
+#define RVSIM_EXT_F 1
+#endif
+#ifndef RVSIM_EXT_V
+#define RVSIM_EXT_V 1
+#endif
+#ifndef RVSIM_EXT_ZBA
+#define RVSIM_EXT_ZBA 1
+#endif
+#ifndef RVSIM_EXT_ZBB
+#define RVSIM_EXT_ZBB 1
+#endif
+#ifndef RVSIM_EXT_ZICSR
+#define RVSIM_EXT_ZICSR 1
+#endif
+
 namespace rv32i_sim {
 
-using addr_t = uint32_t;
+constexpr unsigned XLEN = RVSIM_XLEN; // bits in x register
+
+constexpr bool EXT_M = RVSIM_EXT_M;
+constexpr bool EXT_C = RVSIM_EXT_C;
+constexpr bool EXT_F = RVSIM_EXT_F;
+constexpr bool EXT_V = RVSIM_EXT_V; //< integer subset of Zve32x
+constexpr bool EXT_ZBA = RVSIM_EXT_ZBA;
+constexpr bool EXT_ZBB = RVSIM_EXT_ZBB;
+constexpr bool EXT_ZICSR = RVSIM_EXT_ZICSR;
+
+static_assert(!EXT_F || EXT_ZICSR, "F depends on Zicsr (fcsr)");
+static_assert(!EXT_V || EXT_ZICSR, "V depends on Zicsr (vl, vtype)");
+
+/// @brief integer types of x registers for the given XLEN
+template <unsigned Xlen> struct XlenTypes;
+
+template <> struct XlenTypes<32> {
+  using reg_t = uint32_t;
+  using sreg_t = int32_t;
+  using dreg_t = uint64_t; //< double width, for high part of product
+  using sdreg_t = int64_t;
+};
+
+template <> struct XlenTypes<64> {
+  using reg_t = uint64_t;
+  using sreg_t = int64_t;
+  using dreg_t = unsigned __int128;
+  using sdreg_t = __int128;
+};
+
+using reg_t = XlenTypes<XLEN>::reg_t;
+using sreg_t = XlenTypes<XLEN>::sreg_t;
+using dreg_t = XlenTypes<XLEN>::dreg_t;
+using sdreg_t = XlenTypes<XLEN>::sdreg_t;
+
+using addr_t = reg_t;
 
 using byte_t = uint8_t;
 using half_t = uint16_t;
@@ -14,9 +80,11 @@ using word_t = uint32_t;
 using sbyte_t = int8_t;
 using shalf_t = int16_t;
 using sword_t = int32_t;
+using dword_t = uint64_t;
+using sdword_t = int64_t;
 
 constexpr unsigned BITS_BYTE = 8; // n bits in byte
-constexpr unsigned IALIGN = 4; // bytes, insn address alignment
+constexpr unsigned IALIGN = EXT_C ? 2 : 4; // bytes, insn address alignment
 
 enum class RVInsnType : uint8_t {
   UNDEF_TYPE_INSN = 0,
@@ -27,6 +95,8 @@ enum class RVInsnType : uint8_t {
   U_TYPE_INSN = 5,
   J_TYPE_INSN = 6,
   NO_TYPE_INSN = 7, //< self sufficient instruction
+  R4_TYPE_INSN = 8, //< fused multiply-add, three sources
+  V_TYPE_INSN = 9, //< vector, OP-V and vector loads/stores
 };
 
 constexpr uint32_t MASK_31_25 = 0xFE000000;
@@ -38,6 +108,7 @@ constexpr uint32_t MASK_11_7  = 0x00000F80;
 constexpr uint32_t MASK_10_1  = 0x000007FE;
 constexpr uint32_t MASK_6_0   = 0x0000007F;
 constexpr uint32_t MASK_4_0   = 0x0000001F;
+constexpr uint32_t MASK_5_0   = 0x0000003F;
 
 constexpr uint32_t MASK_31_20 = 0xFFF00000;
 constexpr uint32_t MASK_31_12 = 0xFFFFF000;
@@ -49,7 +120,9 @@ constexpr uint32_t DEFAULT_RS1_MASK = MASK_19_15;
 constexpr uint32_t DEFAULT_RS2_MASK = MASK_24_20;
 constexpr uint32_t DEFAULT_FUNC7_MASK = MASK_31_25;
 
-enum class RV32i_ISA : addr_t {
+constexpr uint32_t SHAMT_MASK = XLEN - 1; // shift amount of XLEN-wide shifts
+
+enum class RV32i_ISA : word_t {
 
   // R-Type
   ADD = 0x00000033,
@@ -63,6 +136,47 @@ enum class RV32i_ISA : addr_t {
   OR = 0x00006033,
   AND = 0x00007033,
 
+  // RV32M (R-Type, func7 = 1)
+  MUL = 0x02000033,
+  MULH = 0x02001033,
+  MULHSU = 0x02002033,
+  MULHU = 0x02003033,
+  DIV = 0x02004033,
+  DIVU = 0x02005033,
+  REM = 0x02006033,
+  REMU = 0x02007033,
+
+  // Zba (R-Type)
+  SH1ADD = 0x20002033,
+  SH2ADD = 0x20004033,
+  SH3ADD = 0x20006033,
+
+  // Zbb (R-Type)
+  ANDN = 0x40007033,
+  ORN = 0x40006033,
+  XNOR = 0x40004033,
+  MIN = 0x0A004033,
+  MINU = 0x0A005033,
+  MAX = 0x0A006033,
+  MAXU = 0x0A007033,
+  ROL = 0x60001033,
+  ROR = 0x60005033,
+  ZEXT_H = XLEN == 64 ? 0x0800403B : 0x08004033, // rs2 = x0, OP-32 on RV64
+
+  // RV64I (R-Type, 32-bit ops on OP-32)
+  ADDW = 0x0000003B,
+  SUBW = 0x4000003B,
+  SLLW = 0x0000103B,
+  SRLW = 0x0000503B,
+  SRAW = 0x4000503B,
+
+  // RV64M (R-Type, OP-32)
+  MULW = 0x0200003B,
+  DIVW = 0x0200403B,
+  DIVUW = 0x0200503B,
+  REMW = 0x0200603B,
+  REMUW = 0x0200703B,
+
   // I-Type
   JALR = 0x00000067,
   LB = 0x00000003,
@@ -80,10 +194,106 @@ enum class RV32i_ISA : addr_t {
   SRLI = 0x00005013,
   SRAI = 0x40005013, // poor creature... how should i decode you?
 
+  // Zbb (I-Type), unary ones are told apart by imm[11:0]
+  CLZ = 0x60001013,
+  CTZ = 0x60101013,
+  CPOP = 0x60201013,
+  SEXT_B = 0x60401013,
+  SEXT_H = 0x60501013,
+  RORI = 0x60005013,
+  ORC_B = 0x28705013,
+  REV8 = XLEN == 64 ? 0x6B805013 : 0x69805013, // shamt is XLEN - 8
+
+  // RV64I (I-Type, loads and 32-bit ops on OP-IMM-32)
+  LD = 0x00003003,
+  LWU = 0x00006003,
+  ADDIW = 0x0000001B,
+  SLLIW = 0x0000101B,
+  SRLIW = 0x0000501B,
+  SRAIW = 0x4000501B,
+
+  // RV32F loads and stores (I-Type and S-Type)
+  FLW = 0x00002007,
+  FSW = 0x00002027,
+
+  // RV32F (R-Type, rm in func3 where rounding applies)
+  FADD_S = 0x00000053,
+  FSUB_S = 0x08000053,
+  FMUL_S = 0x10000053,
+  FDIV_S = 0x18000053,
+  FSQRT_S = 0x58000053,
+  FSGNJ_S = 0x20000053,
+  FSGNJN_S = 0x20001053,
+  FSGNJX_S = 0x20002053,
+  FMIN_S = 0x28000053,
+  FMAX_S = 0x28001053,
+  FCVT_W_S = 0xC0000053,
+  FCVT_WU_S = 0xC0100053,
+  FMV_X_W = 0xE0000053,
+  FCLASS_S = 0xE0001053,
+  FEQ_S = 0xA0002053,
+  FLT_S = 0xA0001053,
+  FLE_S = 0xA0000053,
+  FCVT_S_W = 0xD0000053,
+  FCVT_S_WU = 0xD0100053,
+  FMV_W_X = 0xF0000053,
+
+  // RV32F (R4-Type)
+  FMADD_S = 0x00000043,
+  FMSUB_S = 0x00000047,
+  FNMSUB_S = 0x0000004B,
+  FNMADD_S = 0x0000004F,
+
+  // RVV configuration (OP-V, func3 = 111)
+  VSETVLI = 0x00007057,
+  VSETIVLI = 0xC0007057,
+  VSETVL = 0x80007057,
+
+  // RVV unit-stride loads and stores (width in func3)
+  VLE8_V = 0x00000007,
+  VLE16_V = 0x00005007,
+  VLE32_V = 0x00006007,
+  VSE8_V = 0x00000027,
+  VSE16_V = 0x00005027,
+  VSE32_V = 0x00006027,
+
+  // RVV integer (OP-V, func6 and operand kind in func3)
+  VADD_VV = 0x00000057,
+  VADD_VX = 0x00004057,
+  VADD_VI = 0x00003057,
+  VSUB_VV = 0x08000057,
+  VSUB_VX = 0x08004057,
+  VAND_VV = 0x24000057,
+  VAND_VX = 0x24004057,
+  VAND_VI = 0x24003057,
+  VOR_VV = 0x28000057,
+  VOR_VX = 0x28004057,
+  VOR_VI = 0x28003057,
+  VXOR_VV = 0x2C000057,
+  VXOR_VX = 0x2C004057,
+  VXOR_VI = 0x2C003057,
+  VMUL_VV = 0x94002057,
+  VMUL_VX = 0x94006057,
+  VMV_V_V = 0x5C000057, // vs2 = v0, unmasked
+  VMV_V_X = 0x5C004057,
+  VMV_V_I = 0x5C003057,
+  VMV_X_S = 0x40002057, // vs1 = v0
+
+  // RVV reductions (OP-V, OPMVV)
+  VREDSUM_VS = 0x00002057,
+  VREDAND_VS = 0x04002057,
+  VREDOR_VS = 0x08002057,
+  VREDXOR_VS = 0x0C002057,
+  VREDMINU_VS = 0x10002057,
+  VREDMIN_VS = 0x14002057,
+  VREDMAXU_VS = 0x18002057,
+  VREDMAX_VS = 0x1C002057,
+
   // S-Type
   SB = 0x00000023,
   SH = 0x00001023,
   SW = 0x00002023,
+  SD = 0x00003023, // RV64I
 
   // B-Type
   BEQ = 0x00000063,
@@ -103,11 +313,26 @@ enum class RV32i_ISA : addr_t {
   // System I Type
   EBREAK = 0x00100073,
   ECALL = 0x00000073,
+
+  // machine mode (System I Type)
+  MRET = 0x30200073,
+  WFI = 0x10500073,
+
+  // Zicsr (System I Type)
+  CSRRW = 0x00001073,
+  CSRRS = 0x00002073,
+  CSRRC = 0x00003073,
+  CSRRWI = 0x00005073,
+  CSRRSI = 0x00006073,
+  CSRRCI = 0x00007073,
 };
 
 constexpr uint8_t RV_R_TYPE_OPCODE = 0b011'0011;
 
+constexpr uint8_t RV_R32_TYPE_OPCODE = 0b011'1011; // OP-32 of RV64
+
 constexpr uint8_t RV_I_TYPE_OPCODE     = 0b001'0011;
+constexpr uint8_t RV_I32_TYPE_OPCODE   = 0b001'1011; // OP-IMM-32 of RV64
 constexpr uint8_t RV_ILOAD_TYPE_OPCODE = 0b000'0011;
 constexpr uint8_t RV_IJALR_TYPE_OPCODE = 0b110'0111;
 constexpr uint8_t RV_SYSTEM_I_OPCODE   = 0b111'0011;
@@ -121,6 +346,24 @@ constexpr uint8_t RV_U2_TYPE_OPCODE = 0b001'0111;
 
 constexpr uint8_t RV_JAL_OPCODE = 0b110'1111;
 
+constexpr uint8_t RV_FLOAD_OPCODE  = 0b000'0111;
+constexpr uint8_t RV_FSTORE_OPCODE = 0b010'0111;
+constexpr uint8_t RV_FP_OPCODE     = 0b101'0011;
+constexpr uint8_t RV_FMADD_OPCODE  = 0b100'0011;
+constexpr uint8_t RV_FMSUB_OPCODE  = 0b100'0111;
+constexpr uint8_t RV_FNMSUB_OPCODE = 0b100'1011;
+constexpr uint8_t RV_FNMADD_OPCODE = 0b100'1111;
+
+constexpr uint32_t MASK_31_27 = 0xF8000000; // rs3 of R4-Type
+constexpr uint32_t MASK_26_25 = 0x06000000; // fmt of R4-Type
+
+constexpr uint8_t RV_V_OPCODE = 0b101'0111;
+
+constexpr uint32_t MASK_31_26 = 0xFC000000; // func6 of OP-V, nf/mew/mop of vector memory
+constexpr uint32_t MASK_31_30 = 0xC0000000;
+constexpr uint32_t MASK_25    = 0x02000000; // vm, 1 is unmasked
+constexpr uint32_t VF3_OPCFG  = 0x00007000; // func3 of vset{i}vl{i}
+
 } // rv32i_sim
 
 #endif // ENCODING_HPP
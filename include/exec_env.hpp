@@ -1,12 +1,177 @@
 #ifndef EXEC_ENV_HPP
 #define EXEC_ENV_HPP
 
+#include <array>
 #include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <unordered_map>
 
+#include "encoding.hpp"
+
+// numbers are the same as in riscv-pk and libgloss (asm-generic/unistd.h)
 enum class EESyscall : uint32_t {
-  READ  = 63,
-  WRITE = 64,
-  EXIT  = 93,
+  OPENAT       = 56,
+  CLOSE        = 57,
+  LSEEK        = 62,
+  READ         = 63,
+  WRITE        = 64,
+  FSTAT        = 80,
+  EXIT         = 93,
+  GETTIMEOFDAY = 169,
+  BRK          = 214,
+};
+
+namespace rv32i_sim {
+
+class IRVModel;
+
+// open flags used by newlib (sys/_default_fcntl.h), access mode bits match the host
+constexpr word_t GUEST_O_ACCMODE = 0x0003;
+constexpr word_t GUEST_O_APPEND  = 0x0008;
+constexpr word_t GUEST_O_CREAT   = 0x0200;
+constexpr word_t GUEST_O_TRUNC   = 0x0400;
+constexpr word_t GUEST_O_EXCL    = 0x0800;
+
+constexpr sword_t GUEST_AT_FDCWD = -100;
+
+constexpr addr_t GUEST_STAT_SIZE = 128; ///< struct kernel_stat of libgloss
+constexpr addr_t GUEST_TIMEVAL_SIZE = 16; ///< 64-bit time_t, 32-bit suseconds_t
+
+constexpr std::size_t DEFAULT_OUTPUT_BUFFER = 1 << 16;
+
+enum class FlushPolicy : uint8_t {
+  UNBUFFERED = 0, //< every write goes to host at once
+  LINE = 1, //< flush when a write contains newline or buffer is full
+  FULL = 2, //< flush when buffer is full
+  EXIT = 3, //< flush only when guest stops or on explicit flush
+};
+
+struct OutputConfig {
+  FlushPolicy policy = FlushPolicy::FULL;
+  std::size_t buffer_size = DEFAULT_OUTPUT_BUFFER; ///< flush threshold
+
+  /// @brief parse "unbuffered", "line", "full" or "exit"
+  static std::optional<FlushPolicy> parsePolicy(const std::string& str);
+};
+
+/// @brief buffered guest stdout or stderr
+///
+/// goes to a host fd (the simulator's own stream or a file)
+/// or is captured in memory, e.g. to keep outputs of parallel jobs apart
+class GuestOutput final {
+  int host_fd_ = -1; ///< -1 if output is captured in memory
+  bool owned_ = false; ///< host_fd_ was opened for this output and is closed by it
+  OutputConfig config_;
+
+  std::string buf_; ///< written by guest, not flushed yet
+  std::string captured_;
+
+  bool writeHost(const char* data, std::size_t size);
+  void release();
+
+public:
+  explicit GuestOutput(int host_fd = -1, const OutputConfig& config = OutputConfig {}) :
+                       host_fd_(host_fd), config_(config) {}
+  GuestOutput(const GuestOutput&) = delete;
+  GuestOutput& operator=(const GuestOutput&) = delete;
+  GuestOutput(GuestOutput&& other) noexcept;
+  GuestOutput& operator=(GuestOutput&& other) noexcept;
+  ~GuestOutput() { release(); }
+
+  static GuestOutput capture(const OutputConfig& config = OutputConfig {});
+
+  /// @brief output to a new file, it is truncated
+  /// @return nullopt if file cannot be opened
+  static std::optional<GuestOutput> toFile(const std::filesystem::path& path,
+                                           const OutputConfig& config = OutputConfig {});
+
+  /// @return bytes accepted, -errno on failure of host write
+  sreg_t write(const byte_t* data, std::size_t size);
+
+  /// @return false if host write failed, unflushed data is dropped then
+  bool flush();
+
+  void setConfig(const OutputConfig& config);
+  const OutputConfig& getConfig() const { return config_; }
+
+  bool isCaptured() const { return host_fd_ < 0; }
+
+  /// @brief flushed data of output captured in memory
+  const std::string& getCaptured() const { return captured_; }
 };
 
+/// @brief execution environment of a user program: services ecalls
+///
+/// newlib/pk calling convention: a7 holds syscall number, a0-a5 arguments,
+/// result goes to a0, errors are returned as -errno.
+/// Guest file descriptors are mapped to host ones, 0-2 are shared with the
+/// simulator and never closed, the rest are owned by the environment.
+/// Writes to stdout and stderr are buffered, so chatty guests do not
+/// make a host write per printf.
+class ExecEnv final {
+  std::unordered_map<reg_t, int> fds_; ///< guest fd -> host fd
+  reg_t next_fd_ = 3;
+
+  std::optional<word_t> exit_code_;
+
+  std::array<GuestOutput, 2> outputs_; ///< guest stdout and stderr
+
+  std::optional<int> hostFd(reg_t guest_fd) const;
+  GuestOutput* outputOf(reg_t guest_fd);
+  void closeOwned();
+
+  sreg_t sysOpenat(IRVModel& model, sreg_t dirfd, addr_t path, reg_t flags, reg_t mode);
+  sreg_t sysClose(reg_t fd);
+  sreg_t sysLseek(reg_t fd, sreg_t offset, reg_t whence);
+  sreg_t sysRead(IRVModel& model, reg_t fd, addr_t buf, reg_t count);
+  sreg_t sysWrite(IRVModel& model, reg_t fd, addr_t buf, reg_t count);
+  sreg_t sysFstat(IRVModel& model, reg_t fd, addr_t statbuf);
+  sreg_t sysGettimeofday(IRVModel& model, addr_t tv);
+  sreg_t sysBrk(IRVModel& model, addr_t brk);
+
+public:
+  ExecEnv();
+  ExecEnv(const ExecEnv&) = delete;
+  ExecEnv& operator=(const ExecEnv&) = delete;
+  ExecEnv(ExecEnv&& other) noexcept;
+  ExecEnv& operator=(ExecEnv&& other) noexcept;
+  ~ExecEnv();
+
+  /// @brief close files opened by guest and forget exit status,
+  /// @brief outputs are flushed and kept
+  void reset();
+
+  /// @brief handle ecall of the model: arguments and result are in its registers
+  void syscall(IRVModel& model);
+
+  /// @brief status passed to exit, nullopt if guest has not exited
+  std::optional<word_t> getExitCode() const { return exit_code_; }
+
+  /// @brief guest has opened or closed files, host fds cannot be checkpointed
+  bool hasFileState() const { return next_fd_ != 3 || fds_.size() != 3; }
+
+  /// @brief stop the model with exit status, as exit syscall or poweroff device does
+  void exit(IRVModel& model, word_t code);
+
+  /// @brief bytes sent by guest to its console (e.g. UART) go to its stdout
+  /// @return bytes accepted, -errno on failure of host write
+  sreg_t writeConsole(const byte_t* data, std::size_t size);
+
+  /// @param guest_fd 1 for stdout, 2 for stderr
+  void setOutput(word_t guest_fd, GuestOutput&& output);
+  const GuestOutput& getOutput(word_t guest_fd) const;
+
+  /// @brief same flush policy for stdout and stderr
+  void setOutputConfig(const OutputConfig& config);
+
+  /// @brief capture both stdout and stderr in memory
+  void captureOutputs();
+
+  void flush();
+};
+
+} // rv32i_sim
+
 #endif // EXEC_ENV_HPP
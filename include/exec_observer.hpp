@@ -0,0 +1,25 @@
+#ifndef EXEC_OBSERVER_HPP
+#define EXEC_OBSERVER_HPP
+
+#include <cstdint>
+
+#include "basic_block.hpp"
+#include "encoding.hpp"
+
+namespace rv32i_sim {
+
+/// @brief something watching the execution (profilers, models of caches etc.)
+/// @brief it is notified once per executed block, so it costs nothing per insn
+class IExecObserver {
+public:
+  /// @param block block which has just been executed
+  /// @param next_pc pc right after the block (trap handler if block exit is TRAP)
+  /// @param instret number of insns retired including the block
+  virtual void onBlock(const BasicBlock& block, addr_t next_pc, uint64_t instret) = 0;
+
+  virtual ~IExecObserver() = default;
+};
+
+} // rv32i_sim
+
+#endif // EXEC_OBSERVER_HPP
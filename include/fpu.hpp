@@ -0,0 +1,73 @@
+#ifndef FPU_HPP
+#define FPU_HPP
+
+#include <cstdint>
+
+#include "encoding.hpp"
+
+namespace rv32i_sim {
+
+/// @brief rm field of F insns and frm of fcsr
+enum class RoundingMode : uint8_t {
+  RNE = 0, //< to nearest, ties to even
+  RTZ = 1, //< towards zero
+  RDN = 2, //< down
+  RUP = 3, //< up
+  RMM = 4, //< to nearest, ties to max magnitude
+  DYN = 7, //< insn field only: take mode from frm
+};
+
+// fflags bits (accrued exceptions)
+constexpr uint8_t FFLAG_NX = 0x01; // inexact
+constexpr uint8_t FFLAG_UF = 0x02; // underflow
+constexpr uint8_t FFLAG_OF = 0x04; // overflow
+constexpr uint8_t FFLAG_DZ = 0x08; // divide by zero
+constexpr uint8_t FFLAG_NV = 0x10; // invalid operation
+
+constexpr word_t FFLAGS_MASK = 0x1F;
+constexpr word_t FRM_MASK = 0x7;
+constexpr unsigned FRM_SHIFT = 5; // position of frm in fcsr
+
+constexpr word_t FP_SIGN_MASK = 0x80000000;
+constexpr word_t CANONICAL_NAN = 0x7FC00000;
+
+/// @brief value (raw bits of float or integer) and exceptions raised by F op
+struct FPResult {
+  word_t value = 0;
+  uint8_t flags = 0;
+};
+
+bool isNaN(word_t bits);
+bool isSignalingNaN(word_t bits);
+
+// arithmetic runs on host FPU, results and flags follow IEEE 754,
+// any NaN result is replaced with canonical one as riscv requires
+FPResult fpAdd(word_t a, word_t b, RoundingMode rm);
+FPResult fpSub(word_t a, word_t b, RoundingMode rm);
+FPResult fpMul(word_t a, word_t b, RoundingMode rm);
+FPResult fpDiv(word_t a, word_t b, RoundingMode rm);
+FPResult fpSqrt(word_t a, RoundingMode rm);
+
+/// @brief a * b + c with a single rounding, negated forms flip signs of a and c
+FPResult fpFma(word_t a, word_t b, word_t c, RoundingMode rm);
+
+FPResult fpMin(word_t a, word_t b);
+FPResult fpMax(word_t a, word_t b);
+
+// value is 0 or 1
+FPResult fpEq(word_t a, word_t b);
+FPResult fpLt(word_t a, word_t b);
+FPResult fpLe(word_t a, word_t b);
+
+// float to integer saturate on overflow and NaN, raising only NV then
+FPResult fpCvtWS(word_t a, RoundingMode rm);
+FPResult fpCvtWUS(word_t a, RoundingMode rm);
+FPResult fpCvtSW(word_t a, RoundingMode rm);
+FPResult fpCvtSWU(word_t a, RoundingMode rm);
+
+/// @brief one-hot class mask of fclass.s
+word_t fpClass(word_t a);
+
+} // rv32i_sim
+
+#endif // FPU_HPP
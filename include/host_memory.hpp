@@ -0,0 +1,108 @@
+#ifndef HOST_MEMORY_HPP
+#define HOST_MEMORY_HPP
+
+#include <csetjmp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <signal.h>
+
+#include "encoding.hpp"
+
+namespace rv32i_sim {
+
+/// @brief byte array of guest memory in host anonymous pages
+///
+/// it works as std::vector<byte_t> does (growth zeroes new bytes), but pages
+/// are mapped by the host lazily, so untouched memory (.bss, stack, heap)
+/// costs nothing, and parts of files can be mapped in place copy-on-write
+class HostMemory final {
+  byte_t* data_ = nullptr;
+  std::size_t size_ = 0;
+  std::size_t capacity_ = 0; ///< bytes mapped, multiple of host page size
+  std::size_t touched_ = 0; ///< bytes past the largest size ever are still zero
+
+  void release();
+
+public:
+  HostMemory() = default;
+  explicit HostMemory(std::size_t size) { resize(size); }
+
+  HostMemory(const HostMemory& other);
+  HostMemory(HostMemory&& other) noexcept;
+  HostMemory& operator=(const HostMemory& other);
+  HostMemory& operator=(HostMemory&& other) noexcept;
+  ~HostMemory() { release(); }
+
+  byte_t* data() { return data_; }
+  const byte_t* data() const { return data_; }
+
+  byte_t& operator[](std::size_t idx) { return data_[idx]; }
+  const byte_t& operator[](std::size_t idx) const { return data_[idx]; }
+
+  const byte_t* begin() const { return data_; }
+  const byte_t* end() const { return data_ + size_; }
+
+  std::size_t size() const { return size_; }
+  std::size_t capacity() const { return capacity_; }
+
+  /// @brief new bytes are zero, memory is moved only if capacity is exceeded
+  void resize(std::size_t size);
+  void reserve(std::size_t capacity);
+
+  /// @brief place size bytes of file at offset to [addr, addr + size) copy-on-write
+  ///
+  /// whole host pages are mapped from the file, so they are shared with
+  /// all the other processes which map it until written, partial ones at
+  /// the ends are read, as is everything if file offset and addr are not
+  /// congruent modulo page size
+  /// @return false if file cannot be read, memory must already hold the range
+  bool mapFile(int fd, std::size_t offset, std::size_t addr, std::size_t size);
+
+  /// @brief set host protection (PROT_* flags) of all pages [addr, addr + size) touches
+  /// @return false if range is out of capacity or host refused
+  bool protect(std::size_t addr, std::size_t size, int prot);
+
+  /// @brief true if host address lies in mapped pages
+  bool contains(const void* ptr) const {
+    const byte_t* byte = static_cast<const byte_t*>(ptr);
+    return data_ <= byte && byte < data_ + capacity_;
+  }
+
+  static std::size_t pageSize();
+
+  bool operator==(const HostMemory& other) const;
+};
+
+/// @brief where SIGSEGV at protected guest pages returns to
+///
+/// env is set by sigsetjmp(env, 0) in the frame which runs guest code,
+/// the handler jumps there with the faulting host address stored
+struct HostFault {
+  sigjmp_buf env;
+  const byte_t* volatile addr = nullptr;
+};
+
+/// @brief while alive, SIGSEGV of this thread at pages of memory jumps to fault.env
+///
+/// faults elsewhere are left to the handler installed before, so simulator
+/// bugs still crash it, scopes of several models may be nested
+class HostFaultScope final {
+  HostFault& fault_;
+  const HostMemory& memory_;
+  HostFaultScope* prev_;
+
+  friend void onHostFault(int sig, siginfo_t* info, void* context);
+
+public:
+  HostFaultScope(HostFault& fault, const HostMemory& memory);
+  ~HostFaultScope();
+
+  HostFaultScope(const HostFaultScope&) = delete;
+  HostFaultScope& operator=(const HostFaultScope&) = delete;
+};
+
+} // rv32i_sim
+
+#endif // HOST_MEMORY_HPP
@@ -9,8 +9,6 @@
 
 namespace rv32i_sim {
 
-class RVModel;
-
 class Operand {
   enum class OpType : uint8_t {
     INVALID = 0,
@@ -36,7 +34,7 @@ public:
   }
 
   addr_t getImm() const {
-    assert(std::holds_alternative<uint32_t>(op_) && "Variant holds another alternative");
+    assert(std::holds_alternative<addr_t>(op_) && "Variant holds another alternative");
     assert(isImm() && "Type mismatch");
     return std::get<addr_t>(op_);
   }
@@ -54,7 +52,7 @@ public:
   }
 
   void setImm(addr_t imm) {
-    assert(std::holds_alternative<uint32_t>(op_) && "Variant holds another alternative");
+    assert(std::holds_alternative<addr_t>(op_) && "Variant holds another alternative");
     assert(isImm() && "Type mismatch");
     op_ = imm;
   }
@@ -117,6 +115,9 @@ public:
   virtual addr_t getOpcode() const = 0;
   virtual RVInsnType getType() const = 0;
 
+  virtual unsigned getSize() const = 0;
+  virtual void setSize(unsigned size) = 0;
+
   virtual void execute(IRVModel& model) const = 0;
 
   virtual void print(std::ostream& out) const = 0;
@@ -131,6 +132,7 @@ protected:
   addr_t opcode_; //< unique code used to determine operation
   RVInsnType type_ = RVInsnType::UNDEF_TYPE_INSN; //< instruction type
   std::string name_ = "???"; //< instruction name (undef by default)
+  uint8_t size_ = sizeof(word_t); //< bytes, 2 for compressed insn (code_ is expanded then)
 
 public:
   RVInsn(RVInsnType type = RVInsnType::UNDEF_TYPE_INSN, std::string name = "???") :
@@ -154,8 +156,11 @@ public:
   addr_t getOpcode() const override { return opcode_; }
   RVInsnType getType() const override { return type_; }
 
+  unsigned getSize() const override { return size_; }
+  void setSize(unsigned size) override { size_ = size; }
+
   void print(std::ostream& out) const override {
-    out << std::bitset<sizeof(addr_t) * BITS_BYTE>(getCode());
+    out << std::bitset<sizeof(word_t) * BITS_BYTE>(getCode());
   }
 
   virtual ~RVInsn() = default;
@@ -163,12 +168,12 @@ public:
   static std::unique_ptr<RVInsn> decode(addr_t code);
 };
 
-std::ostream& operator<< (std::ostream& out, const IInsn& insn) {
+inline std::ostream& operator<< (std::ostream& out, const IInsn& insn) {
   insn.print(out);
   return out;
 }
 
-std::ostream& operator<< (std::ostream& out, const Operand& op) {
+inline std::ostream& operator<< (std::ostream& out, const Operand& op) {
   op.print(out);
   return out;
 }
@@ -180,7 +185,7 @@ public:
   void execute(IRVModel& model) const override;
 
   void print(std::ostream& out) const override {
-    out << std::bitset<sizeof(addr_t) * BITS_BYTE>{getCode()} << " (?)";
+    out << std::bitset<sizeof(word_t) * BITS_BYTE>{getCode()} << " (?)";
   }
 };
 
@@ -5,7 +5,9 @@
 #include <iostream>
 #include <memory>
 
+#include "csr.hpp"
 #include "instruction.hpp"
+#include "vector.hpp"
 
 /**
  * RISCV ISA MANUAL:
@@ -14,6 +16,16 @@
 
 namespace rv32i_sim {
 
+/// @brief insn of extension E, or illegal insn if the core is built without E
+///
+/// disabled insn is not instantiated at all, so neither its class nor
+/// its execute handler gets into the binary
+template <bool Enabled, typename Insn>
+std::unique_ptr<RVInsn> makeExtInsn(addr_t code) {
+  if constexpr (Enabled) return std::make_unique<Insn>(code);
+  else return std::make_unique<GeneralUndefInsn>(code);
+}
+
 class RTypeInsn : public RVInsn {
 protected:
   Register dst_ = Register::INVALID;
@@ -83,7 +95,7 @@ public:
     return func_7 | func_3 | opcode_7_0;
   }
 
-  static std::unique_ptr<RTypeInsn> decode(addr_t code);
+  static std::unique_ptr<RVInsn> decode(addr_t code);
 
   virtual ~RTypeInsn() = default;
 };
@@ -158,6 +170,224 @@ public:
   void execute(IRVModel& model) const override;
 };
 
+class rvMUL final : public RTypeInsn {
+public:
+  rvMUL(addr_t code) : RTypeInsn(code, "mul") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvMULH final : public RTypeInsn {
+public:
+  rvMULH(addr_t code) : RTypeInsn(code, "mulh") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvMULHSU final : public RTypeInsn {
+public:
+  rvMULHSU(addr_t code) : RTypeInsn(code, "mulhsu") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvMULHU final : public RTypeInsn {
+public:
+  rvMULHU(addr_t code) : RTypeInsn(code, "mulhu") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvDIV final : public RTypeInsn {
+public:
+  rvDIV(addr_t code) : RTypeInsn(code, "div") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvDIVU final : public RTypeInsn {
+public:
+  rvDIVU(addr_t code) : RTypeInsn(code, "divu") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvREM final : public RTypeInsn {
+public:
+  rvREM(addr_t code) : RTypeInsn(code, "rem") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvREMU final : public RTypeInsn {
+public:
+  rvREMU(addr_t code) : RTypeInsn(code, "remu") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvSH1ADD final : public RTypeInsn {
+public:
+  rvSH1ADD(addr_t code) : RTypeInsn(code, "sh1add") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvSH2ADD final : public RTypeInsn {
+public:
+  rvSH2ADD(addr_t code) : RTypeInsn(code, "sh2add") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvSH3ADD final : public RTypeInsn {
+public:
+  rvSH3ADD(addr_t code) : RTypeInsn(code, "sh3add") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvANDN final : public RTypeInsn {
+public:
+  rvANDN(addr_t code) : RTypeInsn(code, "andn") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvORN final : public RTypeInsn {
+public:
+  rvORN(addr_t code) : RTypeInsn(code, "orn") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvXNOR final : public RTypeInsn {
+public:
+  rvXNOR(addr_t code) : RTypeInsn(code, "xnor") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvMIN final : public RTypeInsn {
+public:
+  rvMIN(addr_t code) : RTypeInsn(code, "min") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvMINU final : public RTypeInsn {
+public:
+  rvMINU(addr_t code) : RTypeInsn(code, "minu") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvMAX final : public RTypeInsn {
+public:
+  rvMAX(addr_t code) : RTypeInsn(code, "max") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvMAXU final : public RTypeInsn {
+public:
+  rvMAXU(addr_t code) : RTypeInsn(code, "maxu") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvROL final : public RTypeInsn {
+public:
+  rvROL(addr_t code) : RTypeInsn(code, "rol") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvROR final : public RTypeInsn {
+public:
+  rvROR(addr_t code) : RTypeInsn(code, "ror") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvZEXT_H final : public RTypeInsn {
+public:
+  rvZEXT_H(addr_t code) : RTypeInsn(code, "zext.h") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+// RV64I and RV64M: 32-bit ops, results are sign extended to 64 bits
+class rvADDW final : public RTypeInsn {
+public:
+  rvADDW(addr_t code) : RTypeInsn(code, "addw") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvSUBW final : public RTypeInsn {
+public:
+  rvSUBW(addr_t code) : RTypeInsn(code, "subw") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvSLLW final : public RTypeInsn {
+public:
+  rvSLLW(addr_t code) : RTypeInsn(code, "sllw") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvSRLW final : public RTypeInsn {
+public:
+  rvSRLW(addr_t code) : RTypeInsn(code, "srlw") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvSRAW final : public RTypeInsn {
+public:
+  rvSRAW(addr_t code) : RTypeInsn(code, "sraw") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvMULW final : public RTypeInsn {
+public:
+  rvMULW(addr_t code) : RTypeInsn(code, "mulw") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvDIVW final : public RTypeInsn {
+public:
+  rvDIVW(addr_t code) : RTypeInsn(code, "divw") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvDIVUW final : public RTypeInsn {
+public:
+  rvDIVUW(addr_t code) : RTypeInsn(code, "divuw") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvREMW final : public RTypeInsn {
+public:
+  rvREMW(addr_t code) : RTypeInsn(code, "remw") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvREMUW final : public RTypeInsn {
+public:
+  rvREMUW(addr_t code) : RTypeInsn(code, "remuw") {}
+
+  void execute(IRVModel& model) const override;
+};
+
 class rvUNDEF_R final : public RTypeInsn {
 public:
   rvUNDEF_R(addr_t code) : RTypeInsn{code} {}
@@ -165,7 +395,7 @@ public:
   void execute(IRVModel& model) const override;
 };
 
-std::unique_ptr<RTypeInsn> RTypeInsn::decode(addr_t code) {
+std::unique_ptr<RVInsn> RTypeInsn::decode(addr_t code) {
   switch (static_cast<RV32i_ISA>(RTypeInsn::getOpcode(code)))
   {
   case RV32i_ISA::ADD: return std::make_unique<rvADD>(code);
@@ -178,6 +408,40 @@ std::unique_ptr<RTypeInsn> RTypeInsn::decode(addr_t code) {
   case RV32i_ISA::SRA: return std::make_unique<rvSRA>(code);
   case RV32i_ISA::OR: return std::make_unique<rvOR>(code);
   case RV32i_ISA::AND: return std::make_unique<rvAND>(code);
+  case RV32i_ISA::MUL: return makeExtInsn<EXT_M, rvMUL>(code);
+  case RV32i_ISA::MULH: return makeExtInsn<EXT_M, rvMULH>(code);
+  case RV32i_ISA::MULHSU: return makeExtInsn<EXT_M, rvMULHSU>(code);
+  case RV32i_ISA::MULHU: return makeExtInsn<EXT_M, rvMULHU>(code);
+  case RV32i_ISA::DIV: return makeExtInsn<EXT_M, rvDIV>(code);
+  case RV32i_ISA::DIVU: return makeExtInsn<EXT_M, rvDIVU>(code);
+  case RV32i_ISA::REM: return makeExtInsn<EXT_M, rvREM>(code);
+  case RV32i_ISA::REMU: return makeExtInsn<EXT_M, rvREMU>(code);
+  case RV32i_ISA::SH1ADD: return makeExtInsn<EXT_ZBA, rvSH1ADD>(code);
+  case RV32i_ISA::SH2ADD: return makeExtInsn<EXT_ZBA, rvSH2ADD>(code);
+  case RV32i_ISA::SH3ADD: return makeExtInsn<EXT_ZBA, rvSH3ADD>(code);
+  case RV32i_ISA::ANDN: return makeExtInsn<EXT_ZBB, rvANDN>(code);
+  case RV32i_ISA::ORN: return makeExtInsn<EXT_ZBB, rvORN>(code);
+  case RV32i_ISA::XNOR: return makeExtInsn<EXT_ZBB, rvXNOR>(code);
+  case RV32i_ISA::MIN: return makeExtInsn<EXT_ZBB, rvMIN>(code);
+  case RV32i_ISA::MINU: return makeExtInsn<EXT_ZBB, rvMINU>(code);
+  case RV32i_ISA::MAX: return makeExtInsn<EXT_ZBB, rvMAX>(code);
+  case RV32i_ISA::MAXU: return makeExtInsn<EXT_ZBB, rvMAXU>(code);
+  case RV32i_ISA::ROL: return makeExtInsn<EXT_ZBB, rvROL>(code);
+  case RV32i_ISA::ROR: return makeExtInsn<EXT_ZBB, rvROR>(code);
+  case RV32i_ISA::ZEXT_H:
+    // the same encoding with rs2 != x0 is pack of Zbkb
+    if (code & DEFAULT_RS2_MASK) return std::make_unique<rvUNDEF_R>(code);
+    return makeExtInsn<EXT_ZBB, rvZEXT_H>(code);
+  case RV32i_ISA::ADDW: return std::make_unique<rvADDW>(code);
+  case RV32i_ISA::SUBW: return std::make_unique<rvSUBW>(code);
+  case RV32i_ISA::SLLW: return std::make_unique<rvSLLW>(code);
+  case RV32i_ISA::SRLW: return std::make_unique<rvSRLW>(code);
+  case RV32i_ISA::SRAW: return std::make_unique<rvSRAW>(code);
+  case RV32i_ISA::MULW: return makeExtInsn<EXT_M, rvMULW>(code);
+  case RV32i_ISA::DIVW: return makeExtInsn<EXT_M, rvDIVW>(code);
+  case RV32i_ISA::DIVUW: return makeExtInsn<EXT_M, rvDIVUW>(code);
+  case RV32i_ISA::REMW: return makeExtInsn<EXT_M, rvREMW>(code);
+  case RV32i_ISA::REMUW: return makeExtInsn<EXT_M, rvREMUW>(code);
   default: return std::make_unique<rvUNDEF_R>(code);
   }
 }
@@ -239,20 +503,43 @@ public:
   static addr_t getOpcode(addr_t code) {
     addr_t opcode_7_0 = code & DEFAULT_OPCODE_MASK;
     addr_t func_3 = code & DEFAULT_FUNC3_MASK;
-    addr_t srai_specific = code & MASK_31_25;
-
-    if ((srai_specific | func_3 | opcode_7_0) == static_cast<addr_t>(RV32i_ISA::SRAI))
-      return static_cast<addr_t>(RV32i_ISA::SRAI);
-
-    addr_t func_12 = code & MASK_31_20; // system insns specific
-
-    if ((func_12 | func_3 | opcode_7_0) == static_cast<addr_t>(RV32i_ISA::EBREAK))
-      return static_cast<addr_t>(RV32i_ISA::EBREAK);
+    addr_t func_12 = code & MASK_31_20; // system and Zbb unary insns specific
+
+    // shifts by immediate: imm[11:5] selects slli/srli/srai/rori,
+    // unless the whole imm[11:0] is one of Zbb unary insns
+    if (opcode_7_0 == RV_I_TYPE_OPCODE &&
+        (func_3 == (static_cast<addr_t>(RV32i_ISA::SLLI) & DEFAULT_FUNC3_MASK) ||
+         func_3 == (static_cast<addr_t>(RV32i_ISA::SRLI) & DEFAULT_FUNC3_MASK))) {
+      switch (static_cast<RV32i_ISA>(func_12 | func_3 | opcode_7_0))
+      {
+      case RV32i_ISA::CLZ:
+      case RV32i_ISA::CTZ:
+      case RV32i_ISA::CPOP:
+      case RV32i_ISA::SEXT_B:
+      case RV32i_ISA::SEXT_H:
+      case RV32i_ISA::ORC_B:
+      case RV32i_ISA::REV8:
+        return func_12 | func_3 | opcode_7_0;
+
+      default: // shamt is 6 bits wide on RV64
+        return (code & (XLEN == 64 ? MASK_31_26 : MASK_31_25)) | func_3 | opcode_7_0;
+      }
+    }
+
+    // 32-bit shifts of RV64 keep 5-bit shamt
+    if (opcode_7_0 == RV_I32_TYPE_OPCODE &&
+        (func_3 == (static_cast<addr_t>(RV32i_ISA::SLLIW) & DEFAULT_FUNC3_MASK) ||
+         func_3 == (static_cast<addr_t>(RV32i_ISA::SRLIW) & DEFAULT_FUNC3_MASK)))
+      return (code & MASK_31_25) | func_3 | opcode_7_0;
+
+    // system insns with func3 = 0 differ in imm[11:0] only, other fields are 0,
+    // so the whole code is matched and anything else is illegal
+    if (opcode_7_0 == RV_SYSTEM_I_OPCODE && func_3 == 0) return code;
 
     return func_3 | opcode_7_0;
   }
 
-  static std::unique_ptr<ITypeInsn> decode(addr_t code);
+  static std::unique_ptr<RVInsn> decode(addr_t code);
 
   virtual ~ITypeInsn() = default;
 };
@@ -362,6 +649,112 @@ public:
   void execute(IRVModel& model) const override;
 };
 
+// RV64I
+class rvLD final : public ITypeInsn {
+public:
+  rvLD(addr_t code) : ITypeInsn(code, "ld") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvLWU final : public ITypeInsn {
+public:
+  rvLWU(addr_t code) : ITypeInsn(code, "lwu") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvADDIW final : public ITypeInsn {
+public:
+  rvADDIW(addr_t code) : ITypeInsn(code, "addiw") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvSLLIW final : public ITypeInsn {
+public:
+  rvSLLIW(addr_t code) : ITypeInsn(code, "slliw") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvSRLIW final : public ITypeInsn {
+public:
+  rvSRLIW(addr_t code) : ITypeInsn(code, "srliw") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvSRAIW final : public ITypeInsn {
+public:
+  rvSRAIW(addr_t code) : ITypeInsn(code, "sraiw") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvCLZ final : public ITypeInsn {
+public:
+  rvCLZ(addr_t code) : ITypeInsn(code, "clz") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvCTZ final : public ITypeInsn {
+public:
+  rvCTZ(addr_t code) : ITypeInsn(code, "ctz") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvCPOP final : public ITypeInsn {
+public:
+  rvCPOP(addr_t code) : ITypeInsn(code, "cpop") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvSEXT_B final : public ITypeInsn {
+public:
+  rvSEXT_B(addr_t code) : ITypeInsn(code, "sext.b") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvSEXT_H final : public ITypeInsn {
+public:
+  rvSEXT_H(addr_t code) : ITypeInsn(code, "sext.h") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvRORI final : public ITypeInsn {
+public:
+  rvRORI(addr_t code) : ITypeInsn(code, "rori") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvORC_B final : public ITypeInsn {
+public:
+  rvORC_B(addr_t code) : ITypeInsn(code, "orc.b") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvREV8 final : public ITypeInsn {
+public:
+  rvREV8(addr_t code) : ITypeInsn(code, "rev8") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFLW final : public ITypeInsn {
+public:
+  rvFLW(addr_t code) : ITypeInsn(code, "flw") {}
+
+  void execute(IRVModel& model) const override;
+};
+
 class rvEBREAK final : public ITypeInsn {
 public:
   rvEBREAK() {
@@ -400,33 +793,131 @@ public:
   void execute(IRVModel& model) const override;
 };
 
-class rvUNDEF_I final : public ITypeInsn {
+class rvMRET final : public ITypeInsn {
 public:
-  rvUNDEF_I(addr_t code) : ITypeInsn(code) {}
+  rvMRET(addr_t code) : ITypeInsn(code, "mret") {}
 
   void execute(IRVModel& model) const override;
 };
 
-std::unique_ptr<ITypeInsn> ITypeInsn::decode(addr_t code) {
-  switch (static_cast<RV32i_ISA>(ITypeInsn::getOpcode(code)))
-  {
-  case RV32i_ISA::JALR: return std::make_unique<rvJALR>(code);
-  case RV32i_ISA::LB: return std::make_unique<rvLB>(code);
-  case RV32i_ISA::LH: return std::make_unique<rvLH>(code);
-  case RV32i_ISA::LW: return std::make_unique<rvLW>(code);
-  case RV32i_ISA::LBU: return std::make_unique<rvLBU>(code);
-  case RV32i_ISA::LHU: return std::make_unique<rvLHU>(code);
-  case RV32i_ISA::ADDI: return std::make_unique<rvADDI>(code);
-  case RV32i_ISA::SLTI: return std::make_unique<rvSLTI>(code);
-  case RV32i_ISA::SLTIU: return std::make_unique<rvSLTIU>(code);
-  case RV32i_ISA::XORI: return std::make_unique<rvXORI>(code);
-  case RV32i_ISA::ORI: return std::make_unique<rvORI>(code);
-  case RV32i_ISA::ANDI: return std::make_unique<rvANDI>(code);
-  case RV32i_ISA::SLLI: return std::make_unique<rvSLLI>(code);
-  case RV32i_ISA::SRLI: return std::make_unique<rvSRLI>(code);
-  case RV32i_ISA::SRAI: return std::make_unique<rvSRAI>(code);
-  case RV32i_ISA::EBREAK: return std::make_unique<rvEBREAK>(code);
-  case RV32i_ISA::ECALL: return std::make_unique<rvECALL>(code);
+class rvWFI final : public ITypeInsn {
+public:
+  rvWFI(addr_t code) : ITypeInsn(code, "wfi") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+/// @brief common base of Zicsr insns, imm[11:0] holds CSR address
+/// @brief and rs1 field holds uimm for immediate forms
+class CSRTypeInsn : public ITypeInsn {
+public:
+  CSRTypeInsn(addr_t code, std::string name = "???") : ITypeInsn(code, name) {}
+
+  csr_t getCSR() const { return static_cast<csr_t>(imm_ & CSR_ADDR_MASK); }
+  word_t getUimm() const { return static_cast<word_t>(rs1_); }
+
+  virtual ~CSRTypeInsn() = default;
+};
+
+class rvCSRRW final : public CSRTypeInsn {
+public:
+  rvCSRRW(addr_t code) : CSRTypeInsn(code, "csrrw") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvCSRRS final : public CSRTypeInsn {
+public:
+  rvCSRRS(addr_t code) : CSRTypeInsn(code, "csrrs") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvCSRRC final : public CSRTypeInsn {
+public:
+  rvCSRRC(addr_t code) : CSRTypeInsn(code, "csrrc") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvCSRRWI final : public CSRTypeInsn {
+public:
+  rvCSRRWI(addr_t code) : CSRTypeInsn(code, "csrrwi") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvCSRRSI final : public CSRTypeInsn {
+public:
+  rvCSRRSI(addr_t code) : CSRTypeInsn(code, "csrrsi") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvCSRRCI final : public CSRTypeInsn {
+public:
+  rvCSRRCI(addr_t code) : CSRTypeInsn(code, "csrrci") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvUNDEF_I final : public ITypeInsn {
+public:
+  rvUNDEF_I(addr_t code) : ITypeInsn(code) {}
+
+  void execute(IRVModel& model) const override;
+};
+
+std::unique_ptr<RVInsn> ITypeInsn::decode(addr_t code) {
+  switch (static_cast<RV32i_ISA>(ITypeInsn::getOpcode(code)))
+  {
+  case RV32i_ISA::JALR: return std::make_unique<rvJALR>(code);
+  case RV32i_ISA::LB: return std::make_unique<rvLB>(code);
+  case RV32i_ISA::LH: return std::make_unique<rvLH>(code);
+  case RV32i_ISA::LW: return std::make_unique<rvLW>(code);
+  case RV32i_ISA::LBU: return std::make_unique<rvLBU>(code);
+  case RV32i_ISA::LHU: return std::make_unique<rvLHU>(code);
+  case RV32i_ISA::ADDI: return std::make_unique<rvADDI>(code);
+  case RV32i_ISA::SLTI: return std::make_unique<rvSLTI>(code);
+  case RV32i_ISA::SLTIU: return std::make_unique<rvSLTIU>(code);
+  case RV32i_ISA::XORI: return std::make_unique<rvXORI>(code);
+  case RV32i_ISA::ORI: return std::make_unique<rvORI>(code);
+  case RV32i_ISA::ANDI: return std::make_unique<rvANDI>(code);
+  case RV32i_ISA::SLLI: return std::make_unique<rvSLLI>(code);
+  case RV32i_ISA::SRLI: return std::make_unique<rvSRLI>(code);
+  case RV32i_ISA::SRAI: return std::make_unique<rvSRAI>(code);
+  case RV32i_ISA::CLZ: return makeExtInsn<EXT_ZBB, rvCLZ>(code);
+  case RV32i_ISA::CTZ: return makeExtInsn<EXT_ZBB, rvCTZ>(code);
+  case RV32i_ISA::CPOP: return makeExtInsn<EXT_ZBB, rvCPOP>(code);
+  case RV32i_ISA::SEXT_B: return makeExtInsn<EXT_ZBB, rvSEXT_B>(code);
+  case RV32i_ISA::SEXT_H: return makeExtInsn<EXT_ZBB, rvSEXT_H>(code);
+  case RV32i_ISA::RORI: return makeExtInsn<EXT_ZBB, rvRORI>(code);
+  case RV32i_ISA::ORC_B: return makeExtInsn<EXT_ZBB, rvORC_B>(code);
+  case RV32i_ISA::REV8: return makeExtInsn<EXT_ZBB, rvREV8>(code);
+  case RV32i_ISA::FLW: return makeExtInsn<EXT_F, rvFLW>(code);
+  case RV32i_ISA::EBREAK: return std::make_unique<rvEBREAK>(code);
+  case RV32i_ISA::ECALL: return std::make_unique<rvECALL>(code);
+  case RV32i_ISA::MRET: return std::make_unique<rvMRET>(code);
+  case RV32i_ISA::WFI: return std::make_unique<rvWFI>(code);
+  case RV32i_ISA::CSRRW: return makeExtInsn<EXT_ZICSR, rvCSRRW>(code);
+  case RV32i_ISA::CSRRS: return makeExtInsn<EXT_ZICSR, rvCSRRS>(code);
+  case RV32i_ISA::CSRRC: return makeExtInsn<EXT_ZICSR, rvCSRRC>(code);
+  case RV32i_ISA::CSRRWI: return makeExtInsn<EXT_ZICSR, rvCSRRWI>(code);
+  case RV32i_ISA::CSRRSI: return makeExtInsn<EXT_ZICSR, rvCSRRSI>(code);
+  case RV32i_ISA::CSRRCI: return makeExtInsn<EXT_ZICSR, rvCSRRCI>(code);
+  case RV32i_ISA::ADDIW: return std::make_unique<rvADDIW>(code);
+  case RV32i_ISA::SLLIW: return std::make_unique<rvSLLIW>(code);
+  case RV32i_ISA::SRLIW: return std::make_unique<rvSRLIW>(code);
+  case RV32i_ISA::SRAIW: return std::make_unique<rvSRAIW>(code);
+
+  // the same opcode as of RV32 loads, reserved there
+  case RV32i_ISA::LD:
+    if constexpr (XLEN == 64) return std::make_unique<rvLD>(code);
+    return std::make_unique<rvUNDEF_I>(code);
+  case RV32i_ISA::LWU:
+    if constexpr (XLEN == 64) return std::make_unique<rvLWU>(code);
+    return std::make_unique<rvUNDEF_I>(code);
+
   default: return std::make_unique<rvUNDEF_I>(code);
   }
 }
@@ -499,7 +990,7 @@ public:
     return func_3 | opcode_7_0;
   }
 
-  static std::unique_ptr<STypeInsn> decode(addr_t code);
+  static std::unique_ptr<RVInsn> decode(addr_t code);
 
   virtual ~STypeInsn() = default;
 };
@@ -525,6 +1016,20 @@ public:
   void execute(IRVModel& model) const override;
 };
 
+class rvSD final : public STypeInsn {
+public:
+  rvSD(addr_t code) : STypeInsn(code, "sd") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFSW final : public STypeInsn {
+public:
+  rvFSW(addr_t code) : STypeInsn(code, "fsw") {}
+
+  void execute(IRVModel& model) const override;
+};
+
 class rvUNDEF_S final : public STypeInsn {
 public:
   rvUNDEF_S(addr_t code) : STypeInsn(code) {}
@@ -532,12 +1037,16 @@ public:
   void execute(IRVModel& model) const override;
 };
 
-std::unique_ptr<STypeInsn> STypeInsn::decode(addr_t code) {
+std::unique_ptr<RVInsn> STypeInsn::decode(addr_t code) {
   switch (static_cast<RV32i_ISA>(STypeInsn::getOpcode(code)))
   {
   case RV32i_ISA::SB: return std::make_unique<rvSB>(code);
   case RV32i_ISA::SH: return std::make_unique<rvSH>(code);
   case RV32i_ISA::SW: return std::make_unique<rvSW>(code);
+  case RV32i_ISA::FSW: return makeExtInsn<EXT_F, rvFSW>(code);
+  case RV32i_ISA::SD:
+    if constexpr (XLEN == 64) return std::make_unique<rvSD>(code);
+    return std::make_unique<rvUNDEF_S>(code);
   default: return std::make_unique<rvUNDEF_S>(code);
   }
 }
@@ -565,7 +1074,7 @@ public:
 
     addOperand(
       Operand::createImm("imm[4:1]",
-        static_cast<addr_t>((code_ >> 7) & ((1 << 4) - 1))
+        static_cast<addr_t>((code_ >> 8) & ((1 << 4) - 1))
       )
     );
 
@@ -589,7 +1098,7 @@ public:
 
     addOperand(
       Operand::createImm("imm[10:5]",
-        static_cast<addr_t>((code_ >> 25) & ((1 << 7) - 1))
+        static_cast<addr_t>((code_ >> 25) & ((1 << 6) - 1))
       )
     );
 
@@ -846,7 +1355,7 @@ public:
   // todo refactor + implement for other classes
   addr_t encode(Register reg, sword_t imm) {
     rd_ = reg;
-    imm_ = std::bit_cast<addr_t>(imm);
+    imm_ = std::bit_cast<word_t>(imm);
 
     addr_t bit_20     = (imm_ & (1 << 20))  >> 20;
     addr_t bits_19_12 = (imm_ & MASK_19_12) >> 12;
@@ -895,21 +1404,847 @@ public:
   }
 };
 
-std::unique_ptr<RVInsn> RVInsn::decode(addr_t code) {
-  addr_t opcode = code & DEFAULT_OPCODE_MASK;
-  switch (opcode)
+/// @brief OP-FP insns of F extension: R-Type with rounding mode in func3,
+/// @brief unary ones are told apart by rs2 field
+class FPTypeInsn : public RTypeInsn {
+public:
+  FPTypeInsn(addr_t code, std::string name = "???") : RTypeInsn(code, name) {
+    opcode_ = FPTypeInsn::getOpcode(code_);
+  }
+
+  uint8_t getRM() const { return static_cast<uint8_t>(getOperand(2).getEnc()); }
+
+  static addr_t getOpcode(addr_t code) {
+    addr_t func_7 = code & DEFAULT_FUNC7_MASK;
+    addr_t func_3 = code & DEFAULT_FUNC3_MASK;
+    addr_t rs2 = code & DEFAULT_RS2_MASK;
+    addr_t opcode_7_0 = code & DEFAULT_OPCODE_MASK;
+
+    // labels are func7 of insn groups
+    switch (static_cast<RV32i_ISA>(func_7 | opcode_7_0))
+    {
+    case RV32i_ISA::FADD_S:
+    case RV32i_ISA::FSUB_S:
+    case RV32i_ISA::FMUL_S:
+    case RV32i_ISA::FDIV_S:
+      return func_7 | opcode_7_0;
+
+    case RV32i_ISA::FSQRT_S:
+    case RV32i_ISA::FCVT_W_S:
+    case RV32i_ISA::FCVT_S_W:
+      return func_7 | rs2 | opcode_7_0;
+
+    case RV32i_ISA::FSGNJ_S:
+    case RV32i_ISA::FMIN_S:
+    case RV32i_ISA::FLE_S:
+      return func_7 | func_3 | opcode_7_0;
+
+    case RV32i_ISA::FMV_X_W:
+    case RV32i_ISA::FMV_W_X:
+      return func_7 | rs2 | func_3 | opcode_7_0;
+
+    default:
+      return code;
+    }
+  }
+
+  static std::unique_ptr<RVInsn> decode(addr_t code);
+
+  virtual ~FPTypeInsn() = default;
+};
+
+class rvFADD_S final : public FPTypeInsn {
+public:
+  rvFADD_S(addr_t code) : FPTypeInsn(code, "fadd.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFSUB_S final : public FPTypeInsn {
+public:
+  rvFSUB_S(addr_t code) : FPTypeInsn(code, "fsub.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFMUL_S final : public FPTypeInsn {
+public:
+  rvFMUL_S(addr_t code) : FPTypeInsn(code, "fmul.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFDIV_S final : public FPTypeInsn {
+public:
+  rvFDIV_S(addr_t code) : FPTypeInsn(code, "fdiv.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFSQRT_S final : public FPTypeInsn {
+public:
+  rvFSQRT_S(addr_t code) : FPTypeInsn(code, "fsqrt.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFSGNJ_S final : public FPTypeInsn {
+public:
+  rvFSGNJ_S(addr_t code) : FPTypeInsn(code, "fsgnj.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFSGNJN_S final : public FPTypeInsn {
+public:
+  rvFSGNJN_S(addr_t code) : FPTypeInsn(code, "fsgnjn.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFSGNJX_S final : public FPTypeInsn {
+public:
+  rvFSGNJX_S(addr_t code) : FPTypeInsn(code, "fsgnjx.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFMIN_S final : public FPTypeInsn {
+public:
+  rvFMIN_S(addr_t code) : FPTypeInsn(code, "fmin.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFMAX_S final : public FPTypeInsn {
+public:
+  rvFMAX_S(addr_t code) : FPTypeInsn(code, "fmax.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFCVT_W_S final : public FPTypeInsn {
+public:
+  rvFCVT_W_S(addr_t code) : FPTypeInsn(code, "fcvt.w.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFCVT_WU_S final : public FPTypeInsn {
+public:
+  rvFCVT_WU_S(addr_t code) : FPTypeInsn(code, "fcvt.wu.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFMV_X_W final : public FPTypeInsn {
+public:
+  rvFMV_X_W(addr_t code) : FPTypeInsn(code, "fmv.x.w") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFCLASS_S final : public FPTypeInsn {
+public:
+  rvFCLASS_S(addr_t code) : FPTypeInsn(code, "fclass.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFEQ_S final : public FPTypeInsn {
+public:
+  rvFEQ_S(addr_t code) : FPTypeInsn(code, "feq.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFLT_S final : public FPTypeInsn {
+public:
+  rvFLT_S(addr_t code) : FPTypeInsn(code, "flt.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFLE_S final : public FPTypeInsn {
+public:
+  rvFLE_S(addr_t code) : FPTypeInsn(code, "fle.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFCVT_S_W final : public FPTypeInsn {
+public:
+  rvFCVT_S_W(addr_t code) : FPTypeInsn(code, "fcvt.s.w") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFCVT_S_WU final : public FPTypeInsn {
+public:
+  rvFCVT_S_WU(addr_t code) : FPTypeInsn(code, "fcvt.s.wu") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFMV_W_X final : public FPTypeInsn {
+public:
+  rvFMV_W_X(addr_t code) : FPTypeInsn(code, "fmv.w.x") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+#if RVSIM_EXT_F
+std::unique_ptr<RVInsn> FPTypeInsn::decode(addr_t code) {
+  switch (static_cast<RV32i_ISA>(FPTypeInsn::getOpcode(code)))
   {
-  case RV_R_TYPE_OPCODE:
-    return RTypeInsn::decode(code);
+  case RV32i_ISA::FADD_S: return std::make_unique<rvFADD_S>(code);
+  case RV32i_ISA::FSUB_S: return std::make_unique<rvFSUB_S>(code);
+  case RV32i_ISA::FMUL_S: return std::make_unique<rvFMUL_S>(code);
+  case RV32i_ISA::FDIV_S: return std::make_unique<rvFDIV_S>(code);
+  case RV32i_ISA::FSQRT_S: return std::make_unique<rvFSQRT_S>(code);
+  case RV32i_ISA::FSGNJ_S: return std::make_unique<rvFSGNJ_S>(code);
+  case RV32i_ISA::FSGNJN_S: return std::make_unique<rvFSGNJN_S>(code);
+  case RV32i_ISA::FSGNJX_S: return std::make_unique<rvFSGNJX_S>(code);
+  case RV32i_ISA::FMIN_S: return std::make_unique<rvFMIN_S>(code);
+  case RV32i_ISA::FMAX_S: return std::make_unique<rvFMAX_S>(code);
+  case RV32i_ISA::FCVT_W_S: return std::make_unique<rvFCVT_W_S>(code);
+  case RV32i_ISA::FCVT_WU_S: return std::make_unique<rvFCVT_WU_S>(code);
+  case RV32i_ISA::FMV_X_W: return std::make_unique<rvFMV_X_W>(code);
+  case RV32i_ISA::FCLASS_S: return std::make_unique<rvFCLASS_S>(code);
+  case RV32i_ISA::FEQ_S: return std::make_unique<rvFEQ_S>(code);
+  case RV32i_ISA::FLT_S: return std::make_unique<rvFLT_S>(code);
+  case RV32i_ISA::FLE_S: return std::make_unique<rvFLE_S>(code);
+  case RV32i_ISA::FCVT_S_W: return std::make_unique<rvFCVT_S_W>(code);
+  case RV32i_ISA::FCVT_S_WU: return std::make_unique<rvFCVT_S_WU>(code);
+  case RV32i_ISA::FMV_W_X: return std::make_unique<rvFMV_W_X>(code);
+  default: return std::make_unique<GeneralUndefInsn>(code);
+  }
+}
+#endif
 
-  case RV_I_TYPE_OPCODE:
-  case RV_IJALR_TYPE_OPCODE:
-  case RV_ILOAD_TYPE_OPCODE:
-  case RV_SYSTEM_I_OPCODE:
-    return ITypeInsn::decode(code);
+/// @brief fused multiply-add insns of F extension, rs3 is in place of func7
+class R4TypeInsn : public RVInsn {
+protected:
+  Register dst_ = Register::INVALID;
+  Register rs1_ = Register::INVALID;
+  Register rs2_ = Register::INVALID;
+  Register rs3_ = Register::INVALID;
 
-  case RV_S_TYPE_OPCODE:
-    return STypeInsn::decode(code);
+public:
+  R4TypeInsn(addr_t code, std::string name = "???") :
+                                    RVInsn{code, RVInsnType::R4_TYPE_INSN, name} {
+    addOperand(
+      Operand::createEnc("opcode",
+        static_cast<addr_t>(code & DEFAULT_OPCODE_MASK)
+      )
+    );
+
+    addOperand(
+      Operand::createReg("rd",
+        static_cast<Register>((code_ >> 7) & ((1 << 5) - 1))
+      )
+    );
+
+    addOperand(
+      Operand::createEnc("rm",
+        static_cast<addr_t>((code_ >> 12) & ((1 << 3) - 1))
+      )
+    );
+
+    addOperand(
+      Operand::createReg("rs1",
+        static_cast<Register>((code_ >> 15) & ((1 << 5) - 1))
+      )
+    );
+
+    addOperand(
+      Operand::createReg("rs2",
+        static_cast<Register>((code_ >> 20) & ((1 << 5) - 1))
+      )
+    );
+
+    addOperand(
+      Operand::createEnc("fmt",
+        static_cast<addr_t>((code_ >> 25) & ((1 << 2) - 1))
+      )
+    );
+
+    addOperand(
+      Operand::createReg("rs3",
+        static_cast<Register>((code_ >> 27) & ((1 << 5) - 1))
+      )
+    );
+
+    opcode_ = R4TypeInsn::getOpcode(code_);
+
+    dst_ = getOperand(1).getReg();
+    rs1_ = getOperand(3).getReg();
+    rs2_ = getOperand(4).getReg();
+    rs3_ = getOperand(6).getReg();
+  }
+
+  uint8_t getRM() const { return static_cast<uint8_t>(getOperand(2).getEnc()); }
+
+  void print(std::ostream& out) const override {
+    out << std::bitset<5>{static_cast<uint8_t>(getOperand(6).getReg())} << "'"
+        << std::bitset<2>{static_cast<uint8_t>(getOperand(5).getEnc())} << "'"
+        << std::bitset<5>{static_cast<uint8_t>(getOperand(4).getReg())} << "'"
+        << std::bitset<5>{static_cast<uint8_t>(getOperand(3).getReg())} << "'"
+        << std::bitset<3>{static_cast<uint8_t>(getOperand(2).getEnc())} << "'"
+        << std::bitset<5>{static_cast<uint8_t>(getOperand(1).getReg())} << "'"
+        << std::bitset<7>{static_cast<uint8_t>(getOperand(0).getEnc())} << " (R4)";
+  }
+
+  static addr_t getOpcode(addr_t code) {
+    return (code & MASK_26_25) | (code & DEFAULT_OPCODE_MASK);
+  }
+
+  static std::unique_ptr<RVInsn> decode(addr_t code);
+
+  virtual ~R4TypeInsn() = default;
+};
+
+class rvFMADD_S final : public R4TypeInsn {
+public:
+  rvFMADD_S(addr_t code) : R4TypeInsn(code, "fmadd.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFMSUB_S final : public R4TypeInsn {
+public:
+  rvFMSUB_S(addr_t code) : R4TypeInsn(code, "fmsub.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFNMSUB_S final : public R4TypeInsn {
+public:
+  rvFNMSUB_S(addr_t code) : R4TypeInsn(code, "fnmsub.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvFNMADD_S final : public R4TypeInsn {
+public:
+  rvFNMADD_S(addr_t code) : R4TypeInsn(code, "fnmadd.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+#if RVSIM_EXT_F
+std::unique_ptr<RVInsn> R4TypeInsn::decode(addr_t code) {
+  switch (static_cast<RV32i_ISA>(R4TypeInsn::getOpcode(code)))
+  {
+  case RV32i_ISA::FMADD_S: return std::make_unique<rvFMADD_S>(code);
+  case RV32i_ISA::FMSUB_S: return std::make_unique<rvFMSUB_S>(code);
+  case RV32i_ISA::FNMSUB_S: return std::make_unique<rvFNMSUB_S>(code);
+  case RV32i_ISA::FNMADD_S: return std::make_unique<rvFNMADD_S>(code);
+  default: return std::make_unique<GeneralUndefInsn>(code); // fmt other than S
+  }
+}
+#endif
+
+/// @brief vector insns: OP-V arithmetic and configuration, unit-stride loads/stores
+///
+/// fields are kept raw, src1 is vs1, rs1 or simm5 depending on func3,
+/// dst is vs3 of stores and rd of vset{i}vl{i} and vmv.x.s
+class VTypeInsn : public RVInsn {
+protected:
+  Register dst_ = Register::INVALID;
+  Register src1_ = Register::INVALID;
+  Register src2_ = Register::INVALID;
+
+  enum class Src : uint8_t {
+    VV = 0, //< vs1
+    VX = 1, //< x[rs1]
+    VI = 2, //< simm5
+  };
+
+  // execution helpers shared by similar insns, they stop the model on
+  // vtype not set, masked insns (v0.t is not supported) or misaligned groups
+  void illegal(IRVModel& model, const char* reason) const;
+  bool checkGroups(IRVModel& model, std::initializer_list<Register> groups) const;
+  void setConfig(IRVModel& model, word_t vtype) const;
+  void executeBinary(IRVModel& model, VecOp op, Src src) const;
+  void executeMove(IRVModel& model, Src src) const;
+  void executeReduce(IRVModel& model, VecRed op) const;
+  void executeLoad(IRVModel& model, unsigned eew) const;
+  void executeStore(IRVModel& model, unsigned eew) const;
+
+public:
+  VTypeInsn(addr_t code, std::string name = "???") :
+                                    RVInsn{code, RVInsnType::V_TYPE_INSN, name} {
+    addOperand(
+      Operand::createEnc("opcode",
+        static_cast<addr_t>(code & DEFAULT_OPCODE_MASK)
+      )
+    );
+
+    addOperand(
+      Operand::createReg("vd",
+        static_cast<Register>((code_ >> 7) & ((1 << 5) - 1))
+      )
+    );
+
+    addOperand(
+      Operand::createEnc("func3",
+        static_cast<addr_t>((code_ >> 12) & ((1 << 3) - 1))
+      )
+    );
+
+    addOperand(
+      Operand::createReg("vs1",
+        static_cast<Register>((code_ >> 15) & ((1 << 5) - 1))
+      )
+    );
+
+    addOperand(
+      Operand::createReg("vs2",
+        static_cast<Register>((code_ >> 20) & ((1 << 5) - 1))
+      )
+    );
+
+    addOperand(
+      Operand::createEnc("vm",
+        static_cast<addr_t>((code_ >> 25) & 1)
+      )
+    );
+
+    addOperand(
+      Operand::createEnc("func6",
+        static_cast<addr_t>((code_ >> 26) & ((1 << 6) - 1))
+      )
+    );
+
+    opcode_ = VTypeInsn::getOpcode(code_);
+
+    dst_ = getOperand(1).getReg();
+    src1_ = getOperand(3).getReg();
+    src2_ = getOperand(4).getReg();
+  }
+
+  bool isMasked() const { return getOperand(5).getEnc() == 0; }
+
+  word_t getSimm5() const {
+    return std::bit_cast<sword_t>(getUimm5() << 27) >> 27;
+  }
+
+  word_t getUimm5() const { return static_cast<uint8_t>(src1_); }
+
+  // vtype immediate of vsetvli and vsetivli
+  word_t getZimm() const {
+    return (code_ >> 20) & ((code_ >> 31) ? 0x3FF : 0x7FF);
+  }
+
+  void print(std::ostream& out) const override {
+    out << std::bitset<6>{static_cast<uint8_t>(getOperand(6).getEnc())} << "'"
+        << std::bitset<1>{static_cast<uint8_t>(getOperand(5).getEnc())} << "'"
+        << std::bitset<5>{static_cast<uint8_t>(getOperand(4).getReg())} << "'"
+        << std::bitset<5>{static_cast<uint8_t>(getOperand(3).getReg())} << "'"
+        << std::bitset<3>{static_cast<uint8_t>(getOperand(2).getEnc())} << "'"
+        << std::bitset<5>{static_cast<uint8_t>(getOperand(1).getReg())} << "'"
+        << std::bitset<7>{static_cast<uint8_t>(getOperand(0).getEnc())} << " (V)";
+  }
+
+  static addr_t getOpcode(addr_t code) {
+    addr_t opcode = code & DEFAULT_OPCODE_MASK;
+    addr_t func3 = code & DEFAULT_FUNC3_MASK;
+
+    if (opcode != RV_V_OPCODE) // unit-stride has zero nf, mew, mop and lumop
+      return (code & (MASK_31_26 | MASK_24_20)) | func3 | opcode;
+
+    if (func3 != VF3_OPCFG) return (code & MASK_31_26) | func3 | opcode;
+
+    // vsetvli keeps zimm[10:0] in bits 30:20, vsetivli zimm[9:0] in 29:20
+    if ((code >> 31) == 0) return static_cast<addr_t>(RV32i_ISA::VSETVLI);
+    if ((code & MASK_31_30) == MASK_31_30) return static_cast<addr_t>(RV32i_ISA::VSETIVLI);
+    return (code & MASK_31_25) | func3 | opcode;
+  }
+
+  static std::unique_ptr<RVInsn> decode(addr_t code);
+
+  virtual ~VTypeInsn() = default;
+};
+
+class rvVSETVLI final : public VTypeInsn {
+public:
+  rvVSETVLI(addr_t code) : VTypeInsn(code, "vsetvli") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVSETIVLI final : public VTypeInsn {
+public:
+  rvVSETIVLI(addr_t code) : VTypeInsn(code, "vsetivli") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVSETVL final : public VTypeInsn {
+public:
+  rvVSETVL(addr_t code) : VTypeInsn(code, "vsetvl") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVLE8_V final : public VTypeInsn {
+public:
+  rvVLE8_V(addr_t code) : VTypeInsn(code, "vle8.v") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVLE16_V final : public VTypeInsn {
+public:
+  rvVLE16_V(addr_t code) : VTypeInsn(code, "vle16.v") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVLE32_V final : public VTypeInsn {
+public:
+  rvVLE32_V(addr_t code) : VTypeInsn(code, "vle32.v") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVSE8_V final : public VTypeInsn {
+public:
+  rvVSE8_V(addr_t code) : VTypeInsn(code, "vse8.v") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVSE16_V final : public VTypeInsn {
+public:
+  rvVSE16_V(addr_t code) : VTypeInsn(code, "vse16.v") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVSE32_V final : public VTypeInsn {
+public:
+  rvVSE32_V(addr_t code) : VTypeInsn(code, "vse32.v") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVADD_VV final : public VTypeInsn {
+public:
+  rvVADD_VV(addr_t code) : VTypeInsn(code, "vadd.vv") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVADD_VX final : public VTypeInsn {
+public:
+  rvVADD_VX(addr_t code) : VTypeInsn(code, "vadd.vx") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVADD_VI final : public VTypeInsn {
+public:
+  rvVADD_VI(addr_t code) : VTypeInsn(code, "vadd.vi") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVSUB_VV final : public VTypeInsn {
+public:
+  rvVSUB_VV(addr_t code) : VTypeInsn(code, "vsub.vv") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVSUB_VX final : public VTypeInsn {
+public:
+  rvVSUB_VX(addr_t code) : VTypeInsn(code, "vsub.vx") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVAND_VV final : public VTypeInsn {
+public:
+  rvVAND_VV(addr_t code) : VTypeInsn(code, "vand.vv") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVAND_VX final : public VTypeInsn {
+public:
+  rvVAND_VX(addr_t code) : VTypeInsn(code, "vand.vx") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVAND_VI final : public VTypeInsn {
+public:
+  rvVAND_VI(addr_t code) : VTypeInsn(code, "vand.vi") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVOR_VV final : public VTypeInsn {
+public:
+  rvVOR_VV(addr_t code) : VTypeInsn(code, "vor.vv") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVOR_VX final : public VTypeInsn {
+public:
+  rvVOR_VX(addr_t code) : VTypeInsn(code, "vor.vx") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVOR_VI final : public VTypeInsn {
+public:
+  rvVOR_VI(addr_t code) : VTypeInsn(code, "vor.vi") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVXOR_VV final : public VTypeInsn {
+public:
+  rvVXOR_VV(addr_t code) : VTypeInsn(code, "vxor.vv") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVXOR_VX final : public VTypeInsn {
+public:
+  rvVXOR_VX(addr_t code) : VTypeInsn(code, "vxor.vx") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVXOR_VI final : public VTypeInsn {
+public:
+  rvVXOR_VI(addr_t code) : VTypeInsn(code, "vxor.vi") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVMUL_VV final : public VTypeInsn {
+public:
+  rvVMUL_VV(addr_t code) : VTypeInsn(code, "vmul.vv") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVMUL_VX final : public VTypeInsn {
+public:
+  rvVMUL_VX(addr_t code) : VTypeInsn(code, "vmul.vx") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVMV_V_V final : public VTypeInsn {
+public:
+  rvVMV_V_V(addr_t code) : VTypeInsn(code, "vmv.v.v") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVMV_V_X final : public VTypeInsn {
+public:
+  rvVMV_V_X(addr_t code) : VTypeInsn(code, "vmv.v.x") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVMV_V_I final : public VTypeInsn {
+public:
+  rvVMV_V_I(addr_t code) : VTypeInsn(code, "vmv.v.i") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVMV_X_S final : public VTypeInsn {
+public:
+  rvVMV_X_S(addr_t code) : VTypeInsn(code, "vmv.x.s") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVREDSUM_VS final : public VTypeInsn {
+public:
+  rvVREDSUM_VS(addr_t code) : VTypeInsn(code, "vredsum.vs") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVREDAND_VS final : public VTypeInsn {
+public:
+  rvVREDAND_VS(addr_t code) : VTypeInsn(code, "vredand.vs") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVREDOR_VS final : public VTypeInsn {
+public:
+  rvVREDOR_VS(addr_t code) : VTypeInsn(code, "vredor.vs") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVREDXOR_VS final : public VTypeInsn {
+public:
+  rvVREDXOR_VS(addr_t code) : VTypeInsn(code, "vredxor.vs") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVREDMINU_VS final : public VTypeInsn {
+public:
+  rvVREDMINU_VS(addr_t code) : VTypeInsn(code, "vredminu.vs") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVREDMIN_VS final : public VTypeInsn {
+public:
+  rvVREDMIN_VS(addr_t code) : VTypeInsn(code, "vredmin.vs") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVREDMAXU_VS final : public VTypeInsn {
+public:
+  rvVREDMAXU_VS(addr_t code) : VTypeInsn(code, "vredmaxu.vs") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+class rvVREDMAX_VS final : public VTypeInsn {
+public:
+  rvVREDMAX_VS(addr_t code) : VTypeInsn(code, "vredmax.vs") {}
+
+  void execute(IRVModel& model) const override;
+};
+
+#if RVSIM_EXT_V
+std::unique_ptr<RVInsn> VTypeInsn::decode(addr_t code) {
+  bool unmasked = code & MASK_25;
+
+  switch (static_cast<RV32i_ISA>(VTypeInsn::getOpcode(code)))
+  {
+  case RV32i_ISA::VSETVLI: return std::make_unique<rvVSETVLI>(code);
+  case RV32i_ISA::VSETIVLI: return std::make_unique<rvVSETIVLI>(code);
+  case RV32i_ISA::VSETVL: return std::make_unique<rvVSETVL>(code);
+  case RV32i_ISA::VLE8_V: return std::make_unique<rvVLE8_V>(code);
+  case RV32i_ISA::VLE16_V: return std::make_unique<rvVLE16_V>(code);
+  case RV32i_ISA::VLE32_V: return std::make_unique<rvVLE32_V>(code);
+  case RV32i_ISA::VSE8_V: return std::make_unique<rvVSE8_V>(code);
+  case RV32i_ISA::VSE16_V: return std::make_unique<rvVSE16_V>(code);
+  case RV32i_ISA::VSE32_V: return std::make_unique<rvVSE32_V>(code);
+  case RV32i_ISA::VADD_VV: return std::make_unique<rvVADD_VV>(code);
+  case RV32i_ISA::VADD_VX: return std::make_unique<rvVADD_VX>(code);
+  case RV32i_ISA::VADD_VI: return std::make_unique<rvVADD_VI>(code);
+  case RV32i_ISA::VSUB_VV: return std::make_unique<rvVSUB_VV>(code);
+  case RV32i_ISA::VSUB_VX: return std::make_unique<rvVSUB_VX>(code);
+  case RV32i_ISA::VAND_VV: return std::make_unique<rvVAND_VV>(code);
+  case RV32i_ISA::VAND_VX: return std::make_unique<rvVAND_VX>(code);
+  case RV32i_ISA::VAND_VI: return std::make_unique<rvVAND_VI>(code);
+  case RV32i_ISA::VOR_VV: return std::make_unique<rvVOR_VV>(code);
+  case RV32i_ISA::VOR_VX: return std::make_unique<rvVOR_VX>(code);
+  case RV32i_ISA::VOR_VI: return std::make_unique<rvVOR_VI>(code);
+  case RV32i_ISA::VXOR_VV: return std::make_unique<rvVXOR_VV>(code);
+  case RV32i_ISA::VXOR_VX: return std::make_unique<rvVXOR_VX>(code);
+  case RV32i_ISA::VXOR_VI: return std::make_unique<rvVXOR_VI>(code);
+  case RV32i_ISA::VMUL_VV: return std::make_unique<rvVMUL_VV>(code);
+  case RV32i_ISA::VMUL_VX: return std::make_unique<rvVMUL_VX>(code);
+  case RV32i_ISA::VREDSUM_VS: return std::make_unique<rvVREDSUM_VS>(code);
+  case RV32i_ISA::VREDAND_VS: return std::make_unique<rvVREDAND_VS>(code);
+  case RV32i_ISA::VREDOR_VS: return std::make_unique<rvVREDOR_VS>(code);
+  case RV32i_ISA::VREDXOR_VS: return std::make_unique<rvVREDXOR_VS>(code);
+  case RV32i_ISA::VREDMINU_VS: return std::make_unique<rvVREDMINU_VS>(code);
+  case RV32i_ISA::VREDMIN_VS: return std::make_unique<rvVREDMIN_VS>(code);
+  case RV32i_ISA::VREDMAXU_VS: return std::make_unique<rvVREDMAXU_VS>(code);
+  case RV32i_ISA::VREDMAX_VS: return std::make_unique<rvVREDMAX_VS>(code);
+
+  // the same func6 with vm = 0 is vmerge
+  case RV32i_ISA::VMV_V_V:
+    if (!unmasked || (code & DEFAULT_RS2_MASK)) break;
+    return std::make_unique<rvVMV_V_V>(code);
+
+  case RV32i_ISA::VMV_V_X:
+    if (!unmasked || (code & DEFAULT_RS2_MASK)) break;
+    return std::make_unique<rvVMV_V_X>(code);
+
+  case RV32i_ISA::VMV_V_I:
+    if (!unmasked || (code & DEFAULT_RS2_MASK)) break;
+    return std::make_unique<rvVMV_V_I>(code);
+
+  // vs1 != 0 selects other unary ops
+  case RV32i_ISA::VMV_X_S:
+    if (!unmasked || (code & DEFAULT_RS1_MASK)) break;
+    return std::make_unique<rvVMV_X_S>(code);
+
+  default:
+    break;
+  }
+
+  return std::make_unique<GeneralUndefInsn>(code);
+}
+#endif
+
+std::unique_ptr<RVInsn> RVInsn::decode(addr_t code) {
+  addr_t opcode = code & DEFAULT_OPCODE_MASK;
+  switch (opcode)
+  {
+  case RV_R_TYPE_OPCODE:
+    return RTypeInsn::decode(code);
+
+  case RV_I_TYPE_OPCODE:
+  case RV_IJALR_TYPE_OPCODE:
+  case RV_ILOAD_TYPE_OPCODE:
+  case RV_SYSTEM_I_OPCODE:
+    return ITypeInsn::decode(code);
+
+  // LOAD-FP and STORE-FP are shared with vector ones, told apart by width
+  case RV_FLOAD_OPCODE:
+    if ((code & DEFAULT_FUNC3_MASK) == (static_cast<addr_t>(RV32i_ISA::FLW) & MASK_14_12))
+      return ITypeInsn::decode(code);
+    if constexpr (EXT_V) return VTypeInsn::decode(code);
+    return std::make_unique<GeneralUndefInsn>(code);
+
+  case RV_S_TYPE_OPCODE:
+    return STypeInsn::decode(code);
+
+  // 32-bit ops of RV64, not decoded at all by RV32 model
+  case RV_R32_TYPE_OPCODE:
+    if constexpr (XLEN == 64) return RTypeInsn::decode(code);
+    return std::make_unique<GeneralUndefInsn>(code);
+
+  case RV_I32_TYPE_OPCODE:
+    if constexpr (XLEN == 64) return ITypeInsn::decode(code);
+    return std::make_unique<GeneralUndefInsn>(code);
+
+  case RV_FSTORE_OPCODE:
+    if ((code & DEFAULT_FUNC3_MASK) == (static_cast<addr_t>(RV32i_ISA::FSW) & MASK_14_12))
+      return STypeInsn::decode(code);
+    if constexpr (EXT_V) return VTypeInsn::decode(code);
+    return std::make_unique<GeneralUndefInsn>(code);
+
+  // opcodes of F and V as a whole are illegal on the core without them
+  case RV_V_OPCODE:
+    if constexpr (EXT_V) return VTypeInsn::decode(code);
+    return std::make_unique<GeneralUndefInsn>(code);
+
+  case RV_FP_OPCODE:
+    if constexpr (EXT_F) return FPTypeInsn::decode(code);
+    return std::make_unique<GeneralUndefInsn>(code);
+
+  case RV_FMADD_OPCODE:
+  case RV_FMSUB_OPCODE:
+  case RV_FNMSUB_OPCODE:
+  case RV_FNMADD_OPCODE:
+    if constexpr (EXT_F) return R4TypeInsn::decode(code);
+    return std::make_unique<GeneralUndefInsn>(code);
 
   case RV_B_TYPE_OPCODE:
     return BTypeInsn::decode(code);
@@ -2,10 +2,15 @@
 #define ISIM_HPP
 
 #include <iostream>
+#include <optional>
+#include <string>
 
+#include "csr.hpp"
 #include "encoding.hpp"
+#include "fpu.hpp"
 #include "memory.hpp"
 #include "register_file.hpp"
+#include "vector.hpp"
 
 namespace rv32i_sim {
 
@@ -17,30 +22,80 @@ public:
   virtual void init(MemoryModel&& mem_init, RegisterFile&& regs_init, addr_t pc_init) = 0;
 
   virtual bool isValid() const = 0;
+
+  /// @brief false once an insn has stopped the model, e.g. by a fault with no handler
+  virtual bool isExecuting() const = 0;
+
   virtual addr_t getPC() const = 0;
   virtual void setPC(addr_t pc_new) = 0;
 
+  // control transfer of the insn being executed: pc is switched after it retires
+  virtual void setNextPC(addr_t pc_next) = 0;
+
   virtual byte_t readByte(addr_t addr) const = 0;
   virtual half_t readHalf(addr_t addr) const = 0;
   virtual word_t readWord(addr_t addr) const = 0;
+  virtual dword_t readDouble(addr_t addr) const = 0; //< ld of RV64
 
   virtual void writeByte(addr_t addr, byte_t val) = 0;
   virtual void writeHalf(addr_t addr, half_t val) = 0;
   virtual void writeWord(addr_t addr, word_t val) = 0;
+  virtual void writeDouble(addr_t addr, dword_t val) = 0; //< sd of RV64
+
+  /// @brief host view of guest memory for bulk transfers (e.g. by syscalls)
+  /// @return nullptr if [addr, addr + size) is not accessible with rights
+  /// @warning valid only until memory is resized
+  virtual byte_t* hostPtr(addr_t addr, addr_t size, uint8_t rights) = 0;
+
+  /// @brief read zero terminated string of at most max_len chars
+  /// @return false if string is not accessible or not terminated
+  virtual bool readString(addr_t addr, addr_t max_len, std::string& str) const = 0;
+
+  /// @brief move program break (end of heap)
+  /// @return new break, or the current one if request cannot be satisfied
+  virtual addr_t setBrk(addr_t brk) = 0;
+
+  // x registers are XLEN bits wide, narrower results are extended by insns
+  virtual reg_t getReg(Register reg) const = 0;
+  virtual void setReg(Register reg, reg_t val) = 0;
 
-  virtual addr_t getReg(Register reg) const = 0;
-  virtual void setReg(Register reg, word_t val) = 0;
+  // F extension: f registers hold raw bits of single precision values
+  virtual word_t getFReg(Register reg) const = 0;
+  virtual void setFReg(Register reg, word_t val) = 0;
+
+  /// @brief accrue exceptions raised by F insn in fflags
+  virtual void raiseFPFlags(uint8_t flags) = 0;
+
+  /// @brief rounding mode by rm field of F insn, DYN is taken from frm
+  /// @return nullopt if mode is reserved, model stops then as on illegal insn
+  virtual std::optional<RoundingMode> getRoundingMode(uint8_t rm) = 0;
+
+  /// @brief v registers with vl and vtype, changed by vset{i}vl{i} only
+  virtual VectorRegisterFile& getVRegs() = 0;
+
+  virtual reg_t readCSR(csr_t csr) = 0;
+  virtual void writeCSR(csr_t csr, reg_t val) = 0;
 
   virtual void execute() = 0;
+  virtual void ecall() = 0;
   virtual void exit() = 0;
 
+  // M-mode traps: with no handler (mtvec = 0) ebreak and faults stop the model,
+  // ecall is a syscall serviced by the execution environment
+  virtual void ebreak() = 0;
+  virtual void illegalInsn() = 0;
+  virtual void mret() = 0;
+
+  /// @brief wait for interrupt, the model stops if none can ever come
+  virtual void wfi() = 0;
+
   virtual std::ostream& print(std::ostream& out) = 0;
   virtual void binaryDump(std::ofstream& fout) = 0;
 
   virtual ~IRVModel() = default;
 };
 
-std::ostream& operator<<(std::ostream& out, IRVModel& model) {
+inline std::ostream& operator<<(std::ostream& out, IRVModel& model) {
   model.print(out);
   return out;
 }
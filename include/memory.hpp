@@ -4,12 +4,15 @@
 #include <fstream>
 #include <filesystem>
 #include <iostream>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include <elfio/elfio.hpp>
 
+#include "device.hpp"
 #include "encoding.hpp"
+#include "host_memory.hpp"
 #include "segment.hpp"
 
 namespace rv32i_sim {
@@ -17,14 +20,18 @@ namespace rv32i_sim {
 namespace elf = ELFIO;
 
 constexpr uint32_t DEFAULT_ADDR_SPACE = 1 << 16;
-constexpr uint32_t DEFAULT_STACK_SIZE = 1 << 12;
+constexpr uint32_t DEFAULT_STACK_SIZE = 1 << 16;
 constexpr uint32_t ENV_SEG_SIZE = 1 << 6;
 constexpr uint32_t DEFAULT_CANARY_SIZE = 1 << 8;
 
+// host-protected memory reserves it up front: every RV32 address and an access
+// of 8 bytes at it land in guest pages, so they fault instead of host memory
+constexpr std::size_t HOST_MMU_WINDOW = (std::size_t(1) << 32) + (1 << 16);
+
 constexpr uint8_t STACK_CANARY_BYTE = 0xcc; // to make canaries visible
 constexpr uint8_t ENV_CODE_BYTE = 0xee; // to make environment code visible
 
-const std::string RV32I_MEMORY_STATE_SIGNATURE = "RV32I_MEM_STATE";
+const std::string RV32I_MEMORY_STATE_SIGNATURE = "RV32I_MEM_STATE"; // the same on RV64
 
 enum class Endianness { LITTLE, BIG, }; // big endian have not been supported yet
 enum class ELFError : uint8_t {
@@ -34,6 +41,55 @@ enum class ELFError : uint8_t {
   FILE = 3, //< cannot open file
 };
 
+enum class MemAccess : uint8_t { READ, WRITE, };
+
+enum class MemCheck : uint8_t {
+  OK = 0,
+  ALIGN = 1, //< address is not a multiple of access size
+  BOUNDS = 2, //< access does not fit in a segment or loaded memory
+  RIGHTS = 3, //< segment forbids access of this kind
+};
+
+/// @brief how guest accesses are checked, a parameter of the model type
+///
+/// CheckedMem and DiagMem check bounds, alignment and rights of every access
+/// and stop the model on a bad one, DiagMem also tells what was wrong with it.
+/// UncheckedMem trusts the guest: accesses go straight to memory in any build.
+/// HostMem checks nothing in software either, segment rights are set as
+/// protection of host pages while guest runs, and SIGSEGV stops the model
+/// at the faulting insn, so it is exact up to a host page (and no alignment)
+struct UncheckedMem {
+  static constexpr bool CHECK = false;
+  static constexpr bool DIAG = false;
+  static constexpr bool HOST_MMU = false;
+};
+
+struct CheckedMem {
+  static constexpr bool CHECK = true;
+  static constexpr bool DIAG = false;
+  static constexpr bool HOST_MMU = false;
+};
+
+struct DiagMem {
+  static constexpr bool CHECK = true;
+  static constexpr bool DIAG = true;
+  static constexpr bool HOST_MMU = false;
+};
+
+struct HostMem {
+  static constexpr bool CHECK = false;
+  static constexpr bool DIAG = true;
+  static constexpr bool HOST_MMU = true;
+};
+
+/// @brief watches data accesses (e.g. model of a data cache)
+class IMemObserver {
+public:
+  virtual void onAccess(addr_t addr, unsigned size, MemAccess type) = 0;
+
+  virtual ~IMemObserver() = default;
+};
+
 ELFError checkELF(elf::elfio& elf_reader);
 ELFError checkELF(std::filesystem::path& elf_path);
 
@@ -42,28 +98,83 @@ ELFError checkELF(std::filesystem::path& elf_path);
  * endianness: little (default)
 */
 class MemoryModel final {
-  std::vector<byte_t> mem_ = std::vector<byte_t>(DEFAULT_ADDR_SPACE);
+  HostMemory mem_ = HostMemory(DEFAULT_ADDR_SPACE);
   std::vector<Segment> segments_;
 
   Endianness endian_ = Endianness::LITTLE;
   bool is_valid_ = false;
 
+  IMemObserver* observer_ = nullptr; ///< not owned, nullptr if no one watches
+
+  DeviceBus bus_; ///< accesses of device pages go there, not to memory
+
+  // heap is the last segment, [heap start, heap_limit_) is reserved for it:
+  // memory capacity covers the whole range, so brk never moves the image
+  std::optional<std::size_t> heap_seg_; ///< index in segments_, nullopt if no heap
+  addr_t heap_limit_ = 0; ///< end of reserved range
+  addr_t brk_ = 0; ///< current program break
+
+  bool protected_ = false; ///< segment rights are set on host pages
+
+  const Segment* findSegment(addr_t addr) const;
+  void applyProtection();
+
+  void notify(addr_t addr, unsigned size, MemAccess type) const {
+    if (observer_) [[unlikely]] observer_->onAccess(addr, size, type);
+  }
+
 public:
   MemoryModel(bool valid) : is_valid_(valid) {}
   MemoryModel(Endianness endian = Endianness::LITTLE) : endian_(endian) {}
-  MemoryModel(std::vector<byte_t> mem, std::vector<Segment> segments, bool valid = true) :
-      mem_(mem), segments_(segments), is_valid_(valid) {}
+  MemoryModel(HostMemory mem, std::vector<Segment> segments, bool valid = true) :
+      mem_(std::move(mem)), segments_(segments), is_valid_(valid) {}
 
   static MemoryModel fromELF(elf::elfio& elf_reader);
+
+  /// @brief the same, but data of segments is mapped from the file copy-on-write,
+  /// @brief so it is read only when touched and .bss is zeroed by host lazily
+  /// @param capacity address space reserved before mapping (e.g. HOST_MMU_WINDOW),
+  /// @param capacity so that growing memory later does not copy mapped pages
+  /// @param tail address space reserved past the image at least, see tailSize
+  static MemoryModel fromELF(elf::elfio& elf_reader, const std::filesystem::path& elf_path,
+                             std::size_t capacity = 0, std::size_t tail = 0);
   static MemoryModel fromELF(std::filesystem::path& elf_path);
   static MemoryModel fromBstate(std::filesystem::path& mem_path);
   static MemoryModel fromBstate(std::ifstream& mem_file);
 
   // sets up stack segment of size = stack_size with canary at the top
   // returns address where initial sp is placed - the bottom of the segment
-  addr_t setUpStack(uint32_t stack_size = DEFAULT_STACK_SIZE);
+  // page_canaries: canaries and stack take whole host pages, so that
+  // host protection catches overflow exactly
+  addr_t setUpStack(uint32_t stack_size = DEFAULT_STACK_SIZE, bool page_canaries = false);
+
+  /// @brief address space which setUpStack, setUpEnvironment and setUpHeap take past
+  /// @brief the image at most, reserved with it they never reallocate memory
+  static std::size_t tailSize(uint32_t stack_size = DEFAULT_STACK_SIZE,
+                              bool page_canaries = false, addr_t heap_size = MAX_HEAP_SIZE);
+
   addr_t setUpEnvironment(addr_t pc_main);
 
+  /// @brief set up empty RW heap segment at the end of memory
+  /// @brief and reserve max_size bytes after it, no segment can be pushed after heap
+  /// @return initial program break
+  addr_t setUpHeap(addr_t max_size = MAX_HEAP_SIZE);
+
+  /// @brief move program break inside the reserved range, memory is not reallocated
+  /// @return new break, or the current one if request cannot be satisfied
+  addr_t setBrk(addr_t brk);
+  addr_t getBrk() const { return brk_; }
+  addr_t getHeapLimit() const { return heap_limit_; }
+  bool hasHeap() const { return heap_seg_.has_value(); }
+
+  const std::vector<Segment>& getSegments() const { return segments_; }
+
+  /// @brief replace segments, e.g. of memory loaded from bstate which has a single one
+  /// @param heap_limit end of reserved heap range if the last segment is heap,
+  /// @param heap_limit memory ends where heap does then (the rest must be zero)
+  /// @return false if segments do not fit in memory
+  bool setLayout(std::vector<Segment> segments, std::optional<addr_t> heap_limit);
+
   /// @brief create a segment and push at the end of memory
   /// @param size size of segment requested (can be a little bigger due to alignment)
   /// @param rights RWX
@@ -79,6 +190,41 @@ public:
 
   bool checkRights(addr_t addr, uint8_t rights) const;
 
+  /// @brief check of a guest access of size bytes (power of 2) done by model policy,
+  /// @brief accessors below do not check anything themselves
+  MemCheck checkAccess(addr_t addr, addr_t size, uint8_t rights) const;
+
+  /// @brief check that whole [addr, addr + size) lies in one segment with rights
+  bool checkRange(addr_t addr, addr_t size, uint8_t rights) const;
+
+  /// @brief set segment rights as protection of host pages (or make all of them RW),
+  /// @brief pages shared by segments get the rights of both, the rest is not accessible
+  ///
+  /// memory must not be copied, dumped or printed while protected,
+  /// as canaries and unused pages fault on any access
+  void protect(bool on);
+
+  /// @brief guest address of host one, if it lies in memory pages
+  std::optional<addr_t> guestAddr(const void* host_ptr) const;
+
+  const HostMemory& hostMemory() const { return mem_; }
+
+  // bulk access for the execution environment, not reported to observer
+  byte_t* hostPtr(addr_t addr, addr_t size, uint8_t rights);
+  bool readString(addr_t addr, addr_t max_len, std::string& str) const;
+
+  /// @brief set observer of data accesses, fetches are not reported
+  /// @param observer nullptr to disable
+  void setObserver(IMemObserver* observer);
+
+  /// @brief route loads and stores of [base, base + size) to device (not owned),
+  /// @brief they are not reported to observer, code cannot be fetched there
+  /// @return false if range overlaps another device
+  bool attachDevice(addr_t base, addr_t size, IDevice* device) {
+    return bus_.attach(base, size, device);
+  }
+  bool hasDevices() const { return !bus_.empty(); }
+
   bool isValid() const;
 
   bool operator==(const MemoryModel& other) const;
@@ -88,10 +234,16 @@ public:
   byte_t readByte(addr_t addr) const;
   half_t readHalf(addr_t addr) const;
   word_t readWord(addr_t addr) const;
+  dword_t readDouble(addr_t addr) const;
+
+  // same as readHalf and readWord, but for insn fetch: not reported to observer
+  half_t fetchHalf(addr_t addr) const;
+  word_t fetchWord(addr_t addr) const;
 
   void writeByte(addr_t addr, byte_t val);
   void writeHalf(addr_t addr, half_t val);
   void writeWord(addr_t addr, word_t val);
+  void writeDouble(addr_t addr, dword_t val);
 
   void binaryDump(std::ofstream& fout) const;
   std::ostream& print(std::ostream& out) const;
@@ -101,6 +253,7 @@ public:
 };
 
 std::ostream& operator<<(std::ostream& out, MemoryModel& memory);
+std::ostream& operator<<(std::ostream& out, MemCheck check);
 
 } // rv32i_sim
 
@@ -0,0 +1,62 @@
+#ifndef PIPELINE_HPP
+#define PIPELINE_HPP
+
+#include <cstdint>
+#include <iostream>
+
+#include "basic_block.hpp"
+#include "encoding.hpp"
+#include "exec_observer.hpp"
+
+namespace rv32i_sim {
+
+constexpr unsigned PIPELINE_DEPTH = 5; // IF, ID, EX, MEM, WB
+
+struct PipelineConfig {
+  unsigned mem_latency = 1; ///< cycles a load or store spends in MEM
+  unsigned branch_penalty = 2; ///< bubbles after taken branch or jalr (resolved in EX)
+  unsigned jump_penalty = 1; ///< bubbles after jal (resolved in ID)
+};
+
+/// @brief cycle-approximate timing of classic 5-stage in-order pipeline
+///
+/// timing is derived from executed blocks and does not change functional
+/// state: forwarding is full, so the only data hazard is load-use
+/// (one bubble), control hazards cost a fixed penalty for every taken
+/// transfer (no prediction, fallthrough is fetched), memory accesses
+/// stall the pipeline for mem_latency - 1 cycles.
+class PipelineModel final : public IExecObserver {
+  PipelineConfig config_;
+
+  uint64_t insns_ = 0;
+  uint64_t load_use_stalls_ = 0;
+  uint64_t mem_stalls_ = 0;
+  uint64_t control_stalls_ = 0;
+
+  // rd of the last insn if it was a load, x0 otherwise
+  Register pending_load_ = Register::X0;
+
+public:
+  PipelineModel(const PipelineConfig& config = PipelineConfig {});
+
+  void onBlock(const BasicBlock& block, addr_t next_pc, uint64_t instret) override;
+
+  // add up statistics of separately simulated parts of a run,
+  // pipeline is considered to be filled only once
+  void merge(const PipelineModel& other);
+
+  uint64_t nInsns() const { return insns_; }
+  uint64_t nLoadUseStalls() const { return load_use_stalls_; }
+  uint64_t nMemStalls() const { return mem_stalls_; }
+  uint64_t nControlStalls() const { return control_stalls_; }
+
+  /// @brief estimated cycles, including pipeline fill
+  uint64_t nCycles() const;
+  double cpi() const;
+
+  std::ostream& report(std::ostream& out) const;
+};
+
+} // rv32i_sim
+
+#endif // PIPELINE_HPP
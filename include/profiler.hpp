@@ -0,0 +1,60 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+
+#include "basic_block.hpp"
+#include "encoding.hpp"
+#include "exec_observer.hpp"
+#include "symbols.hpp"
+
+namespace rv32i_sim {
+
+constexpr uint64_t DEFAULT_PROFILE_INSN_PERIOD = 1000; // insns between samples
+constexpr uint64_t DEFAULT_PROFILE_TIMER_PERIOD = 1000; // us of host cpu time
+constexpr unsigned DEFAULT_PROFILE_TOP = 20; // functions in report
+
+enum class ProfileMode : uint8_t {
+  INSN = 0, //< sample every n-th retired insn
+  TIMER = 1, //< sample on host SIGPROF timer
+};
+
+/// @brief statistical profiler of guest pc
+///
+/// insn mode is exact: pc of the n-th insn is recovered from the block,
+/// timer mode attributes the sample to the block executing when timer fired
+class SamplingProfiler final : public IExecObserver {
+  ProfileMode mode_ = ProfileMode::INSN;
+  uint64_t period_ = DEFAULT_PROFILE_INSN_PERIOD;
+  uint64_t next_sample_ = DEFAULT_PROFILE_INSN_PERIOD;
+  uint64_t n_samples_ = 0;
+
+  std::unordered_map<addr_t, uint64_t> samples_; ///< pc -> n samples
+
+  void record(addr_t pc);
+
+public:
+  // period is in insns for INSN mode and in microseconds for TIMER mode
+  SamplingProfiler(ProfileMode mode = ProfileMode::INSN,
+                   uint64_t period = DEFAULT_PROFILE_INSN_PERIOD);
+
+  SamplingProfiler(const SamplingProfiler&) = delete;
+  SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+  ~SamplingProfiler();
+
+  void onBlock(const BasicBlock& block, addr_t next_pc, uint64_t instret) override;
+
+  uint64_t nSamples() const;
+  const std::unordered_map<addr_t, uint64_t>& getSamples() const;
+
+  /// @brief print flat profile of top_n functions, sorted by samples
+  std::ostream& report(std::ostream& out, const SymbolTable& symbols,
+                       unsigned top_n = DEFAULT_PROFILE_TOP) const;
+};
+
+} // rv32i_sim
+
+#endif // PROFILER_HPP
@@ -8,19 +8,22 @@
 #include <vector>
 
 #include "encoding.hpp"
+#include "fpu.hpp"
 #include "registers.hpp"
 
 namespace rv32i_sim {
 
-const std::string RV32I_REGS_STATE_SIGNATURE = "RV32I_REG_STATE";
+// registers are XLEN bits wide in bstate as well
+const std::string RV32I_REGS_STATE_SIGNATURE = XLEN == 64 ? "RV64I_REG_STATE" :
+                                                            "RV32I_REG_STATE";
 
 class RegisterFile final {
-  std::vector<addr_t> regs_ = std::vector<addr_t>(N_REGS);
+  std::vector<reg_t> regs_ = std::vector<reg_t>(N_REGS);
   bool is_valid_ = false;
 
 public:
   RegisterFile(bool valid = true);
-  RegisterFile(std::vector<addr_t> regs, bool valid = true);
+  RegisterFile(std::vector<reg_t> regs, bool valid = true);
 
   // construct from bstate file format
   RegisterFile(std::ifstream& regs_bstate);
@@ -36,8 +39,8 @@ public:
 
   bool operator==(const RegisterFile& other) const;
 
-  void set(Register reg, sword_t val);
-  addr_t get(Register reg) const;
+  void set(Register reg, reg_t val);
+  reg_t get(Register reg) const;
 
   std::ostream& print(std::ostream& out);
   void binaryDump(std::ofstream& fout);
@@ -45,6 +48,35 @@ public:
 
 std::ostream& operator<<(std::ostream& out, RegisterFile& rf);
 
+/// @brief f registers and fcsr of F extension
+///
+/// registers hold raw bits of single precision values, f registers are
+/// numbered by the same Register values as x ones.
+/// fcsr is frm (dynamic rounding mode) and fflags (accrued exceptions)
+class FPRegisterFile final {
+  std::vector<word_t> regs_ = std::vector<word_t>(N_REGS);
+  uint8_t fflags_ = 0;
+  uint8_t frm_ = 0;
+
+public:
+  bool operator==(const FPRegisterFile& other) const;
+
+  void set(Register reg, word_t val);
+  word_t get(Register reg) const;
+
+  uint8_t getFlags() const { return fflags_; }
+  void setFlags(word_t flags);
+  void raiseFlags(uint8_t flags) { fflags_ |= flags; }
+
+  uint8_t getRM() const { return frm_; }
+  void setRM(word_t rm);
+
+  word_t getFCSR() const;
+  void setFCSR(word_t fcsr);
+
+  std::ostream& print(std::ostream& out);
+};
+
 bool isRegValid(Register reg);
 
 std::ostream& operator<< (std::ostream& out, Register reg);
@@ -0,0 +1,248 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bpred.hpp"
+#include "cache.hpp"
+#include "pipeline.hpp"
+#include "sim.hpp"
+#include "simpoint.hpp"
+
+namespace rv32i_sim {
+
+/// @brief detailed models to run on every interval, disabled ones are nullopt
+struct ReplayConfig {
+  std::optional<CacheConfig> icache;
+  std::optional<CacheConfig> dcache;
+  std::optional<BPredConfig> bpred;
+  std::optional<PipelineConfig> pipeline;
+};
+
+enum class IntervalCheck : uint8_t {
+  MATCH = 0, //< end state is the same as in the next checkpoint
+  MISMATCH = 1,
+  NO_NEXT = 2, //< next interval was not checkpointed, nothing to compare with
+  FAILED = 3, //< checkpoint could not be loaded or model became invalid
+};
+
+struct IntervalResult {
+  uint64_t interval = 0;
+  uint64_t insns = 0;
+  IntervalCheck check = IntervalCheck::NO_NEXT;
+
+  // guest output of the interval, captured so that jobs do not interleave
+  std::string guest_stdout;
+  std::string guest_stderr;
+
+  std::unique_ptr<ICacheObserver> icache;
+  std::unique_ptr<DCacheObserver> dcache;
+  std::unique_ptr<BranchPredictor> bpred;
+  std::unique_ptr<PipelineModel> pipeline;
+};
+
+/// @brief detailed simulation of checkpointed intervals in parallel
+///
+/// every interval is simulated by its own model on a pool of threads,
+/// models start with cold caches and predictors.
+/// Statistics are merged afterwards in interval order.
+class IntervalReplay final {
+  std::filesystem::path dir_;
+  CheckpointManifest manifest_;
+  ReplayConfig config_;
+
+  std::vector<IntervalResult> results_;
+
+  IntervalResult replayOne(std::size_t idx) const;
+
+public:
+  IntervalReplay(const std::filesystem::path& dir, const CheckpointManifest& manifest,
+                 const ReplayConfig& config) :
+                 dir_(dir), manifest_(manifest), config_(config) {}
+
+  /// @param jobs number of threads, 0 for number of host cpus
+  void run(unsigned jobs = 0);
+
+  const std::vector<IntervalResult>& getResults() const { return results_; }
+  bool allMatch() const;
+
+  uint64_t nInsns() const;
+
+  // merged statistics, nullptr if model was disabled
+  std::unique_ptr<ICacheObserver> mergedICache() const;
+  std::unique_ptr<DCacheObserver> mergedDCache() const;
+  std::unique_ptr<BranchPredictor> mergedBPred() const;
+  std::unique_ptr<PipelineModel> mergedPipeline() const;
+
+  std::ostream& report(std::ostream& out) const;
+};
+
+IntervalResult IntervalReplay::replayOne(std::size_t idx) const {
+  const Checkpoint& ckpt = manifest_.checkpoints[idx];
+
+  IntervalResult result;
+  result.interval = ckpt.interval;
+  result.check = IntervalCheck::FAILED;
+
+  std::filesystem::path ckpt_path = dir_ / ckpt.path;
+  RVModel model{};
+  model.initCheckpoint(ckpt_path);
+  if (!model.isValid()) return result;
+
+  model.setCounters(ckpt.instret, ckpt.cycle);
+  model.setTrace(false);
+  model.getEnv().captureOutputs();
+
+  if (config_.icache) {
+    result.icache = std::make_unique<ICacheObserver>(*config_.icache);
+    model.addObserver(result.icache.get());
+  }
+
+  if (config_.dcache) {
+    result.dcache = std::make_unique<DCacheObserver>(*config_.dcache);
+    model.setMemObserver(result.dcache.get());
+  }
+
+  if (config_.bpred) {
+    result.bpred = std::make_unique<BranchPredictor>(*config_.bpred);
+    model.addObserver(result.bpred.get());
+  }
+
+  if (config_.pipeline) {
+    result.pipeline = std::make_unique<PipelineModel>(*config_.pipeline);
+    model.addObserver(result.pipeline.get());
+  }
+
+  model.run(ckpt.instret + manifest_.interval_len);
+  model.setMemObserver(nullptr);
+
+  model.getEnv().flush();
+  result.guest_stdout = model.getEnv().getOutput(1).getCaptured();
+  result.guest_stderr = model.getEnv().getOutput(2).getCaptured();
+
+  result.insns = model.getInstret() - ckpt.instret;
+  if (!model.isValid()) return result;
+
+  // checkpoints are sorted, the next interval can only be right after this one
+  bool has_next = idx + 1 != manifest_.checkpoints.size() &&
+                  manifest_.checkpoints[idx + 1].interval == ckpt.interval + 1;
+  if (!has_next) {
+    result.check = IntervalCheck::NO_NEXT;
+    return result;
+  }
+
+  const Checkpoint& next = manifest_.checkpoints[idx + 1];
+  std::filesystem::path next_path = dir_ / next.path;
+  RVModel expected{};
+  expected.initCheckpoint(next_path);
+  if (!expected.isValid()) return result;
+
+  bool match = model == expected && model.getInstret() == next.instret;
+  result.check = match ? IntervalCheck::MATCH : IntervalCheck::MISMATCH;
+
+  return result;
+}
+
+void IntervalReplay::run(unsigned jobs) {
+  std::size_t n_intervals = manifest_.checkpoints.size();
+
+  if (jobs == 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+  jobs = std::min<std::size_t>(jobs, n_intervals);
+
+  results_.clear();
+  results_.resize(n_intervals);
+
+  // results are stored by index, so the order does not depend on scheduling
+  std::atomic<std::size_t> next_idx = 0;
+  auto worker = [this, &next_idx, n_intervals]() {
+    for (std::size_t idx = next_idx++; idx < n_intervals; idx = next_idx++)
+      results_[idx] = replayOne(idx);
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned i = 0; i != jobs; ++i) workers.emplace_back(worker);
+  for (auto&& thread : workers) thread.join();
+}
+
+bool IntervalReplay::allMatch() const {
+  return std::all_of(results_.begin(), results_.end(), [](const IntervalResult& result) {
+    return result.check == IntervalCheck::MATCH || result.check == IntervalCheck::NO_NEXT;
+  });
+}
+
+uint64_t IntervalReplay::nInsns() const {
+  uint64_t n = 0;
+  for (auto&& result : results_) n += result.insns;
+
+  return n;
+}
+
+std::unique_ptr<ICacheObserver> IntervalReplay::mergedICache() const {
+  if (!config_.icache) return nullptr;
+
+  auto merged = std::make_unique<ICacheObserver>(*config_.icache);
+  for (auto&& result : results_)
+    if (result.icache) merged->merge(*result.icache);
+
+  return merged;
+}
+
+std::unique_ptr<DCacheObserver> IntervalReplay::mergedDCache() const {
+  if (!config_.dcache) return nullptr;
+
+  auto merged = std::make_unique<DCacheObserver>(*config_.dcache);
+  for (auto&& result : results_)
+    if (result.dcache) merged->merge(*result.dcache);
+
+  return merged;
+}
+
+std::unique_ptr<BranchPredictor> IntervalReplay::mergedBPred() const {
+  if (!config_.bpred) return nullptr;
+
+  auto merged = std::make_unique<BranchPredictor>(*config_.bpred);
+  for (auto&& result : results_)
+    if (result.bpred) merged->merge(*result.bpred);
+
+  return merged;
+}
+
+std::unique_ptr<PipelineModel> IntervalReplay::mergedPipeline() const {
+  if (!config_.pipeline) return nullptr;
+
+  auto merged = std::make_unique<PipelineModel>(*config_.pipeline);
+  for (auto&& result : results_)
+    if (result.pipeline) merged->merge(*result.pipeline);
+
+  return merged;
+}
+
+std::ostream& IntervalReplay::report(std::ostream& out) const {
+  static const char* check_names[] = {"ok", "MISMATCH", "-", "FAILED"};
+
+  out << "Replayed " << results_.size() << " intervals of " << manifest_.interval_len
+      << " insns from " << dir_ << '\n';
+  out << "  interval       insns  end state\n";
+
+  for (auto&& result : results_) {
+    out << std::setw(10) << result.interval
+        << std::setw(12) << result.insns
+        << "  " << check_names[static_cast<int>(result.check)] << '\n';
+  }
+
+  return out;
+}
+
+} // rv32i_sim
+
+#endif // REPLAY_HPP
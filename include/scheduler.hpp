@@ -0,0 +1,81 @@
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace rv32i_sim {
+
+/// @brief events of devices (timers etc.) keyed on virtual time, retired insns of the model
+///
+/// hierarchical timer wheel: level L has 64 slots of 64^L ticks, an event
+/// sits at the level of the highest 6-bit group in which its time differs
+/// from the current one, so schedule and cancel cost O(1), and time jumps
+/// straight to the next event instead of being ticked. The model compares
+/// its instret with nextDeadline() once per block and cuts blocks at it,
+/// so devices cost nothing between their events
+class EventScheduler final {
+public:
+  using EventId = uint64_t;
+  using Callback = std::function<void(uint64_t now)>;
+
+  static constexpr uint64_t NEVER = UINT64_MAX;
+
+private:
+  static constexpr unsigned SLOT_BITS = 6;
+  static constexpr unsigned N_SLOTS = 1 << SLOT_BITS;
+  static constexpr unsigned N_LEVELS = (64 + SLOT_BITS - 1) / SLOT_BITS;
+
+  struct Event {
+    uint64_t when;
+    EventId id;
+    Callback callback;
+  };
+
+  struct Level {
+    std::array<std::vector<Event>, N_SLOTS> slots;
+    uint64_t occupied = 0; ///< bit per non-empty slot
+  };
+
+  std::array<Level, N_LEVELS> levels_;
+  std::unordered_map<EventId, uint64_t> pending_; ///< id -> time of event not fired yet
+
+  uint64_t now_ = 0; ///< wheel position, events are never earlier
+  uint64_t next_ = NEVER;
+  EventId next_id_ = 1;
+
+  static unsigned levelOf(uint64_t when, uint64_t now);
+  static unsigned slotOf(uint64_t when, unsigned level) {
+    return (when >> level * SLOT_BITS) & (N_SLOTS - 1);
+  }
+
+  void insert(Event&& event);
+  void moveTo(uint64_t now);
+  void updateNext();
+
+public:
+  /// @brief call back at time when, events of the past fire at the next advance
+  /// @return id to cancel event with, never 0
+  EventId schedule(uint64_t when, Callback callback);
+
+  /// @return false if event has already fired or been cancelled
+  bool cancel(EventId id);
+
+  /// @brief time of the earliest event, NEVER if there are none
+  uint64_t nextDeadline() const { return next_; }
+
+  bool empty() const { return pending_.empty(); }
+
+  /// @brief fire all events up to now in time order, callbacks may schedule more
+  void advance(uint64_t now);
+
+  /// @brief drop all events and start time from 0
+  void clear();
+};
+
+} // rv32i_sim
+
+#endif // SCHEDULER_HPP
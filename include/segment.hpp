@@ -8,9 +8,10 @@
 namespace rv32i_sim {
 
 constexpr std::size_t DEFAULT_SEG_SIZE = 1 << 16;
-constexpr std::size_t DEFAULT_ALIGN = 4; // 4 bytes
+constexpr std::size_t DEFAULT_ALIGN = sizeof(addr_t); // 4 bytes on RV32, 8 on RV64
 
 constexpr std::size_t MAX_STACK_SIZE = 1 << 20;
+constexpr std::size_t MAX_HEAP_SIZE = 1 << 24;
 
 constexpr uint8_t RIGHTS_R = 1;
 constexpr uint8_t RIGHTS_W = 2;
@@ -34,6 +35,7 @@ public:
 
   addr_t getVaddr() const;
   addr_t getSize() const;
+  void setSize(addr_t size);
   uint8_t getRights() const;
   uint8_t getAlign() const;
 
@@ -1,22 +1,38 @@
 #ifndef SIMULATOR_HPP
 #define SIMULATOR_HPP
 
+#include <algorithm>
 #include <array>
 #include <bit>
+#include <csetjmp>
 #include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <optional>
+#include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <elfio/elfio.hpp>
 
+#include "basic_block.hpp"
+#include "compressed.hpp"
+#include "csr.hpp"
 #include "isim.hpp"
 #include "instruction.hpp"
 #include "isa.hpp"
 #include "encoding.hpp"
+#include "exec_observer.hpp"
 #include "memory.hpp"
 #include "register_file.hpp"
+#include "scheduler.hpp"
 #include "exec_env.hpp"
+#include "symbols.hpp"
 
 namespace elf = ELFIO;
 
@@ -46,28 +62,74 @@ int32_t sign_extend_32_to_32(uint32_t val) {
 
 namespace rv32i_sim {
 
-const std::string RV32I_MODEL_STATE_SIGNATURE = "RV32I_MDL_STATE";
+// pc and registers in bstate are XLEN wide, so are the files of RV32 and RV64
+const std::string RV32I_MODEL_STATE_SIGNATURE = XLEN == 64 ? "RV64I_MDL_STATE" :
+                                                             "RV32I_MDL_STATE";
 
 // todo refactor mess
-class RVModel final : IRVModel {
+/// @brief the model, MemPolicy (UncheckedMem, CheckedMem, DiagMem or HostMem) sets how
+/// @brief guest memory accesses are checked, each of them is a separate engine
+template <typename MemPolicy>
+class BasicRVModel final : IRVModel {
   MemoryModel mem_;
   RegisterFile regs_;
+  FPRegisterFile fregs_;
+  VectorRegisterFile vregs_;
   addr_t pc_;
+  addr_t next_pc_ = 0; //< pc of the insn to be executed after the current one
 
-  bool execution = false;
+  ExecEnv env_;
+
+  // decoded blocks cache, keyed by start pc
+  std::unordered_map<addr_t, BasicBlock> blocks_;
+  const BasicBlock* curr_block_ = nullptr; //< block being executed (if any)
+  addr_t code_lo_ = std::numeric_limits<addr_t>::max(); //< bounds of decoded code
+  addr_t code_hi_ = 0;                                  //< used to catch SMC
+  bool blocks_dirty_ = false; //< code was overwritten, flush at block boundary
+
+  std::vector<IExecObserver*> observers_; //< not owned
+
+  SymbolTable symbols_; //< empty unless loaded from ELF
+
+  // events of devices keyed on instret, blocks are cut at the next one
+  EventScheduler events_;
+
+  // counters are updated once per block, not per insn
+  uint64_t instret_ = 0;
+  uint64_t cycle_ = 0;
+
+  // where protected pages fault to (HostMem only) and insns trap to
+  mutable HostFault fault_;
+
+  // M-mode traps, trap CSRs are not a part of bstate, but of checkpoint context
+  TrapCSRs mcsr_;
+  bool irq_ready_ = false; //< enabled interrupt is pending, taken between blocks
+
+  struct Trap {
+    reg_t cause;
+    reg_t tval;
+  };
+
+  mutable Trap trap_ {}; //< exception raised by the current insn
+  bool trap_jump_ = false; //< fault_.env is set for traps of the current block
+  static constexpr int TRAP_JUMP = 2; //< host faults jump with 1
+
+  // cleared when guest stops (bad read of const access too), set again by init
+  mutable bool execution = true;
+  bool trace_ = true; //< print every executed insn to stderr
   bool is_valid_ = false;
 
 public:
-  RVModel(addr_t pc_init = 0) : pc_(pc_init) {}
-  RVModel(const MemoryModel& mem_init, const RegisterFile& regs_init, addr_t pc_init)
+  BasicRVModel(addr_t pc_init = 0) : pc_(pc_init) {}
+  BasicRVModel(const MemoryModel& mem_init, const RegisterFile& regs_init, addr_t pc_init)
     : mem_(mem_init), regs_(regs_init), pc_(pc_init) {}
 
-  RVModel(MemoryModel&& mem_init, RegisterFile&& regs_init, addr_t pc_init)
+  BasicRVModel(MemoryModel&& mem_init, RegisterFile&& regs_init, addr_t pc_init)
     : mem_(mem_init), regs_(regs_init), pc_(pc_init) {}
 
-  RVModel(std::filesystem::path& elf_path) {
+  BasicRVModel(std::filesystem::path& elf_path) {
     elf::elfio elf_reader;
-    if (!elf_reader.load(elf_path)) {
+    if (!elf_reader.load(elf_path, true)) { // segment data is not read, it is mapped
       std::cerr << "ERROR: failed to load ELF " << elf_path << "\n";
       is_valid_ = false;
       return;
@@ -77,16 +139,21 @@ public:
     std::cerr << "Found user entry point at: " << pc_ << '\n';
 
     regs_ = RegisterFile();
-    mem_ = MemoryModel::fromELF(elf_reader);
+    // stack, environment and heap are reserved too, so mapped image is never copied
+    mem_ = MemoryModel::fromELF(elf_reader, elf_path,
+                                MemPolicy::HOST_MMU ? HOST_MMU_WINDOW : 0,
+                                MemoryModel::tailSize(DEFAULT_STACK_SIZE, MemPolicy::HOST_MMU));
+    symbols_ = SymbolTable::fromELF(elf_reader);
 
     // setting up stack and initial stack frame
-    addr_t sp = mem_.setUpStack();
+    addr_t sp = mem_.setUpStack(DEFAULT_STACK_SIZE, MemPolicy::HOST_MMU);
     regs_.set(Register::X2, sp); // SP = sp
     regs_.set(Register::X8, sp); // FP = sp
 
     // preparing execution environment i.e.
     // code which calls main and does ebreak in the end
     pc_ = setUpEnvironment(pc_);
+    mem_.setUpHeap();
 
     is_valid_ = mem_.isValid() && regs_.isValid();
   }
@@ -107,39 +174,178 @@ public:
                                                               addr_t pc_init) override;
   void init(MemoryModel&& mem_init, RegisterFile&& regs_init, addr_t pc_init) override;
 
-  bool operator== (const RVModel& other) const;
+  /// @brief pc, x registers and memory, as well as f and v registers and trap CSRs
+  /// @brief of the enabled extensions
+  bool operator== (const BasicRVModel& other) const;
+  /// @brief compare only the state bstate holds: pc, x registers and memory
+  bool sameBstate(const BasicRVModel& other) const;
 
   addr_t getPC() const override;
   void setPC(addr_t pc_new) override;
+  void setNextPC(addr_t pc_next) override;
 
 private:
   std::unique_ptr<IInsn> decode(addr_t insn_code);
+  std::unique_ptr<IInsn> fetchDecode(addr_t pc);
   void printInsn(std::ostream& out, const IInsn& insn);
 
+  void decodeBlock(BasicBlock& block, addr_t pc, std::size_t max_insns);
+  const BasicBlock& getBlock(addr_t pc);
+  void executeBlock(const BasicBlock& block);
+  void executeInsns(const BasicBlock& block);
+  bool runBlocks(uint64_t instret_limit, std::optional<addr_t> break_pc);
+  void flushBlocks();
+  void resetExecState();
+  void checkCodeWrite(addr_t addr, addr_t size);
+
+  void dumpContext(std::ostream& out) const;
+  bool initContext(std::istream& in);
+
+  // jal with zero offset, whatever it links to
+  static bool isSelfLoop(const IInsn& insn) {
+    addr_t code = insn.getCode();
+    return (code & DEFAULT_OPCODE_MASK) == RV_JAL_OPCODE && (code & MASK_31_12) == 0;
+  }
+
+  // csr insns always end a block, so when one of them is executed
+  // all the others in the block have already retired
+  uint64_t retiredInBlock() const { return curr_block_ ? curr_block_->size() - 1 : 0; }
+
+  // access to CSR which does not exist stops the model as illegal insn does
+  void unsupportedCSR(csr_t csr);
+
+  // check of MemPolicy, bad access stops the model before the next insn
+  bool checkAccess(addr_t addr, addr_t size, uint8_t rights) const;
+
+  // the same for HostMem, when host has refused an access of the current insn
+  void hostFault();
+
+  bool trapsEnabled() const { return mcsr_.mtvec != 0; }
+
+  /// @brief switch to trap handler: pc is at the handler then
+  /// @return false if there is no handler, nothing is changed
+  bool enterTrap(reg_t cause, reg_t tval);
+  bool enterTrap(TrapCause cause, reg_t tval) {
+    return enterTrap(static_cast<reg_t>(cause), tval);
+  }
+
+  /// @brief exception of the current insn: its effects are dropped and the block
+  /// @brief is left for the handler, returns only if there is none
+  void raiseTrap(TrapCause cause, reg_t tval) const;
+
+  void undefInsn(const IInsn& insn);
+  reg_t currInsnCode() const;
+
+  void updateInterrupts();
+  void takeInterrupt();
+  bool waitsForInterrupt() const;
+
 public:
   bool isValid() const override;
+  bool isExecuting() const override { return execution; }
 
   byte_t readByte(addr_t addr) const override;
   half_t readHalf(addr_t addr) const override;
   word_t readWord(addr_t addr) const override;
+  dword_t readDouble(addr_t addr) const override;
 
   void writeByte(addr_t addr, byte_t val) override;
   void writeHalf(addr_t addr, half_t val) override;
   void writeWord(addr_t addr, word_t val) override;
+  void writeDouble(addr_t addr, dword_t val) override;
+
+  byte_t* hostPtr(addr_t addr, addr_t size, uint8_t rights) override;
+  bool readString(addr_t addr, addr_t max_len, std::string& str) const override;
+  addr_t setBrk(addr_t brk) override { return mem_.setBrk(brk); }
+
+  reg_t getReg(Register reg) const override;
+  void setReg(Register reg, reg_t val) override;
 
-  addr_t getReg(Register reg) const override;
-  void setReg(Register reg, word_t val) override;
+  word_t getFReg(Register reg) const override { return fregs_.get(reg); }
+  void setFReg(Register reg, word_t val) override { fregs_.set(reg, val); }
+  void raiseFPFlags(uint8_t flags) override { fregs_.raiseFlags(flags); }
+  std::optional<RoundingMode> getRoundingMode(uint8_t rm) override;
+
+  VectorRegisterFile& getVRegs() override { return vregs_; }
+
+  reg_t readCSR(csr_t csr) override;
+  void writeCSR(csr_t csr, reg_t val) override;
+
+  uint64_t getInstret() const { return instret_; }
+  uint64_t getCycle() const { return cycle_; }
+
+  // counters are not a part of bstate, restore them when resuming from checkpoint
+  void setCounters(uint64_t instret, uint64_t cycle) { instret_ = instret; cycle_ = cycle; }
+
+  /// @brief save guest state as bstate file and its context next to it (.ctx): segments
+  /// @brief and heap, f and v registers, trap CSRs, which bstate does not hold.
+  /// @brief Files opened by guest and devices live on host, they cannot be saved
+  /// @return false if state cannot be checkpointed or files cannot be written
+  bool saveCheckpoint(const std::filesystem::path& bstate_path);
+
+  /// @brief restore state saved by saveCheckpoint, counters are left to setCounters
+  void initCheckpoint(const std::filesystem::path& bstate_path);
+
+  const SymbolTable& getSymbols() const { return symbols_; }
+
+  void addObserver(IExecObserver* observer);
+  void removeObserver(IExecObserver* observer);
+
+  // watch data accesses, observer is dropped when memory is reinitialized
+  void setMemObserver(IMemObserver* observer) { mem_.setObserver(observer); }
+
+  // devices schedule their events here, time is instret
+  EventScheduler& getEvents() { return events_; }
+
+  // memory-mapped device, dropped when memory is reinitialized as observer is
+  bool attachDevice(addr_t base, addr_t size, IDevice* device) {
+    return mem_.attachDevice(base, size, device);
+  }
 
   addr_t setUpEnvironment(addr_t pc_main);
 
   void execute() override;
+  void ecall() override;
+  void ebreak() override;
+  void illegalInsn() override;
+  void mret() override;
+  void wfi() override;
+
+  /// @brief raise or clear interrupts of mip (MIP_MSIP, MIP_MTIP), e.g. by CLINT,
+  /// @brief an enabled one is taken at the next block boundary
+  void setInterruptPending(reg_t irq_mask, bool pending);
+
+  const TrapCSRs& getTrapCSRs() const { return mcsr_; }
+
+  /// @brief status passed to exit syscall, nullopt if guest has not called it
+  std::optional<word_t> getExitCode() const { return env_.getExitCode(); }
+
+  // guest outputs and their buffering
+  ExecEnv& getEnv() { return env_; }
+  const ExecEnv& getEnv() const { return env_; }
+
+  /// @brief execute until guest stops, instret reaches instret_limit
+  /// @brief or pc reaches break_pc, whatever happens first
+  /// @return true if guest has not stopped and execution may be continued
+  bool run(uint64_t instret_limit, std::optional<addr_t> break_pc = std::nullopt);
+
+  // observers and tracing may be switched between runs,
+  // e.g. to fast-forward to a region of interest and look at it in detail
+  void setTrace(bool trace) { trace_ = trace; }
   void exit() override;
 
+  // stop with exit status as exit syscall does, e.g. on poweroff by a device
+  void exit(word_t status) { env_.exit(*this, status); }
+
   std::ostream& print(std::ostream& out) override;
   void binaryDump(std::ofstream& fout) override;
 };
 
-void RVModel::init(std::ifstream& model_state_file) {
+// guest code is checked and told about its bad accesses unless asked otherwise
+using RVModel = BasicRVModel<DiagMem>;
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::init(std::ifstream& model_state_file) {
   if (!model_state_file) {
     std::cerr << "ERROR: wrong model state file\n";
     is_valid_ = false;
@@ -163,93 +369,454 @@ void RVModel::init(std::ifstream& model_state_file) {
   // the order of initialization is important (see bstate format)
   regs_ = RegisterFile::fromBstate(model_state_file);
   mem_ = MemoryModel::fromBstate(model_state_file);
+  resetExecState();
 
   is_valid_ = regs_.isValid() && mem_.isValid() && pc_ % IALIGN == 0;
 }
 
-void RVModel::init(const MemoryModel& mem_init, const RegisterFile& regs_init, addr_t pc_init) {
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::init(const MemoryModel& mem_init, const RegisterFile& regs_init,
+                                   addr_t pc_init) {
   mem_ = mem_init; regs_ = regs_init; pc_ = pc_init;
+  resetExecState();
   assert(pc_ % IALIGN == 0 && "PC at unaligned position");
   if (pc_ % IALIGN == 0) is_valid_ = true;
 }
 
-void RVModel::init(MemoryModel&& mem_init, RegisterFile&& regs_init, addr_t pc_init) {
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::init(MemoryModel&& mem_init, RegisterFile&& regs_init,
+                                   addr_t pc_init) {
   mem_ = mem_init; regs_ = regs_init; pc_ = pc_init;
+  resetExecState();
   assert(pc_ % IALIGN == 0 && "PC at unaligned position");
   if (pc_ % IALIGN == 0) is_valid_ = true;
 }
 
-bool RVModel::operator== (const RVModel& other) const {
+template <typename MemPolicy>
+bool BasicRVModel<MemPolicy>::operator== (const BasicRVModel& other) const {
+  return sameBstate(other) && (!EXT_F || fregs_ == other.fregs_) &&
+         (!EXT_V || vregs_ == other.vregs_) && (!EXT_ZICSR || mcsr_ == other.mcsr_);
+}
+
+template <typename MemPolicy>
+bool BasicRVModel<MemPolicy>::sameBstate(const BasicRVModel& other) const {
   return pc_ == other.pc_ && regs_ == other.regs_ && mem_ == other.mem_;
 }
 
-addr_t RVModel::getPC() const {
+template <typename MemPolicy>
+addr_t BasicRVModel<MemPolicy>::getPC() const {
   return pc_;
 }
 
-void RVModel::setPC(addr_t pc_new) {
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::setPC(addr_t pc_new) {
   assert(pc_new % IALIGN == 0 && "PC set to unaligned position");
   if (pc_new % IALIGN != 0) is_valid_ = false;
 
   pc_ = pc_new;
 }
 
-bool RVModel::isValid() const { return is_valid_; }
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::setNextPC(addr_t pc_next) {
+  if (pc_next % IALIGN != 0) raiseTrap(TrapCause::INSN_MISALIGNED, pc_next);
+
+  assert(pc_next % IALIGN == 0 && "Jump to unaligned position");
+  if (pc_next % IALIGN != 0) is_valid_ = false;
+
+  next_pc_ = pc_next;
+}
+
+template <typename MemPolicy>
+bool BasicRVModel<MemPolicy>::isValid() const { return is_valid_; }
+
+// unchecked model compiles the check out, checked ones stop at the faulting
+// insn: it has no effect but a load writes 0 to its destination
+template <typename MemPolicy>
+bool BasicRVModel<MemPolicy>::checkAccess(addr_t addr, addr_t size, uint8_t rights) const {
+  if constexpr (!MemPolicy::CHECK && !MemPolicy::HOST_MMU) return true;
+
+  // host pages cover every RV32 address, RV64 ones have to get there first
+  MemCheck check = MemCheck::OK;
+  if constexpr (MemPolicy::HOST_MMU) {
+    if (XLEN == 64 && addr >= HOST_MMU_WINDOW - sizeof(dword_t)) check = MemCheck::BOUNDS;
+  } else {
+    check = mem_.checkAccess(addr, size, rights);
+  }
+
+  if (check == MemCheck::OK) [[likely]] return true;
+
+  bool store = rights == RIGHTS_W;
+  if (check == MemCheck::ALIGN)
+    raiseTrap(store ? TrapCause::STORE_MISALIGNED : TrapCause::LOAD_MISALIGNED, addr);
+  else
+    raiseTrap(store ? TrapCause::STORE_ACCESS_FAULT : TrapCause::LOAD_ACCESS_FAULT, addr);
+
+  if constexpr (MemPolicy::DIAG) {
+    std::cerr << "ERROR: " << check << (rights == RIGHTS_W ? " write" : " read")
+              << " of " << size << " bytes at 0x" << std::hex << addr << std::dec
+              << " <pc = " << pc_ << ">\n";
+  }
+
+  execution = false;
+  return false;
+}
+
+// the insn has done nothing (but a part of misaligned store across pages),
+// it is not known whether it was a read, unless its page is readable
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::hostFault() {
+  addr_t addr = mem_.guestAddr(fault_.addr).value_or(0);
+  MemCheck check = mem_.checkAccess(addr, sizeof(byte_t), RIGHTS_R);
+
+  if (enterTrap(check == MemCheck::OK ? TrapCause::STORE_ACCESS_FAULT
+                                      : TrapCause::LOAD_ACCESS_FAULT, addr))
+    return;
+
+  if constexpr (MemPolicy::DIAG) {
+    std::cerr << "ERROR: " << (check == MemCheck::OK ? MemCheck::RIGHTS : check)
+              << (check == MemCheck::OK ? " write" : " access") << " at 0x"
+              << std::hex << addr << std::dec << " <pc = " << pc_ << ">\n";
+  }
+
+  execution = false;
+}
+
+template <typename MemPolicy>
+byte_t BasicRVModel<MemPolicy>::readByte(addr_t addr) const {
+  return checkAccess(addr, sizeof(byte_t), RIGHTS_R) ? mem_.readByte(addr) : 0;
+}
+
+template <typename MemPolicy>
+half_t BasicRVModel<MemPolicy>::readHalf(addr_t addr) const {
+  return checkAccess(addr, sizeof(half_t), RIGHTS_R) ? mem_.readHalf(addr) : 0;
+}
+
+template <typename MemPolicy>
+word_t BasicRVModel<MemPolicy>::readWord(addr_t addr) const {
+  return checkAccess(addr, sizeof(word_t), RIGHTS_R) ? mem_.readWord(addr) : 0;
+}
+
+template <typename MemPolicy>
+dword_t BasicRVModel<MemPolicy>::readDouble(addr_t addr) const {
+  return checkAccess(addr, sizeof(dword_t), RIGHTS_R) ? mem_.readDouble(addr) : 0;
+}
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::writeByte(addr_t addr, byte_t val) {
+  if (!checkAccess(addr, sizeof(byte_t), RIGHTS_W)) return;
+  checkCodeWrite(addr, sizeof(byte_t));
+  mem_.writeByte(addr, val);
+}
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::writeHalf(addr_t addr, half_t val) {
+  if (!checkAccess(addr, sizeof(half_t), RIGHTS_W)) return;
+  checkCodeWrite(addr, sizeof(half_t));
+  mem_.writeHalf(addr, val);
+}
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::writeWord(addr_t addr, word_t val) {
+  if (!checkAccess(addr, sizeof(word_t), RIGHTS_W)) return;
+  checkCodeWrite(addr, sizeof(word_t));
+  mem_.writeWord(addr, val);
+}
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::writeDouble(addr_t addr, dword_t val) {
+  if (!checkAccess(addr, sizeof(dword_t), RIGHTS_W)) return;
+  checkCodeWrite(addr, sizeof(dword_t));
+  mem_.writeDouble(addr, val);
+}
+
+template <typename MemPolicy>
+byte_t* BasicRVModel<MemPolicy>::hostPtr(addr_t addr, addr_t size, uint8_t rights) {
+  if (rights & RIGHTS_W) checkCodeWrite(addr, size);
+  return mem_.hostPtr(addr, size, rights);
+}
 
-byte_t RVModel::readByte(addr_t addr) const { return mem_.readByte(addr); }
-half_t RVModel::readHalf(addr_t addr) const { return mem_.readHalf(addr); }
-word_t RVModel::readWord(addr_t addr) const { return mem_.readWord(addr); }
+template <typename MemPolicy>
+bool BasicRVModel<MemPolicy>::readString(addr_t addr, addr_t max_len, std::string& str) const {
+  return mem_.readString(addr, max_len, str);
+}
 
-void RVModel::writeByte(addr_t addr, byte_t val) { mem_.writeByte(addr, val); }
-void RVModel::writeHalf(addr_t addr, half_t val) { mem_.writeHalf(addr, val); }
-void RVModel::writeWord(addr_t addr, word_t val) { mem_.writeWord(addr, val); }
+// self-modifying code: decoded blocks become stale, but the block being
+// executed must stay alive, so flush is postponed until its end
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::checkCodeWrite(addr_t addr, addr_t size) {
+  if (addr < code_hi_ && code_lo_ < addr + size) blocks_dirty_ = true;
+}
 
-std::unique_ptr<IInsn> RVModel::decode(addr_t insn_code) {
+template <typename MemPolicy>
+std::unique_ptr<IInsn> BasicRVModel<MemPolicy>::decode(addr_t insn_code) {
   return RVInsn::decode(insn_code);
 }
 
-void RVModel::execute() {
-  std::cerr << "DBG: begin execution (pc = " << pc_ << ")\n";
+// insn is fetched by 16-bit parcels: with C extension a 32-bit insn
+// may start in the middle of a word and even cross a segment boundary,
+// blocks are decoded ahead, so a bad fetch stops the model only when reached
+template <typename MemPolicy>
+std::unique_ptr<IInsn> BasicRVModel<MemPolicy>::fetchDecode(addr_t pc) {
+  auto fetchable = [this](addr_t addr) {
+    if constexpr (!MemPolicy::CHECK && !MemPolicy::HOST_MMU) return true;
+    return mem_.checkAccess(addr, sizeof(half_t), RIGHTS_X) == MemCheck::OK;
+  };
+
+  if (!fetchable(pc)) return std::make_unique<GeneralUndefInsn>(0);
+
+  half_t low = mem_.fetchHalf(pc);
+  if (!isCompressed(low)) {
+    if (!fetchable(pc + sizeof(half_t))) return std::make_unique<GeneralUndefInsn>(0);
+    return decode(word_t(mem_.fetchHalf(pc + sizeof(half_t))) << 16 | low);
+  }
 
-  execution = true;
+  // without C extension 16-bit parcels are just illegal
+  std::optional<word_t> expanded = EXT_C ? expandCompressed(low) : std::nullopt;
+  std::unique_ptr<IInsn> insn = expanded ? decode(*expanded)
+                                         : std::make_unique<GeneralUndefInsn>(low);
+  insn->setSize(sizeof(half_t));
+
+  return insn;
+}
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::decodeBlock(BasicBlock& block, addr_t pc,
+                                          std::size_t max_insns) {
+  block.start_pc = pc;
+
+  addr_t insn_pc = pc;
+  while (block.size() < max_insns) {
+    std::unique_ptr<IInsn> insn = fetchDecode(insn_pc);
+    insn_pc += insn->getSize();
+
+    block.exit = classifyInsn(*insn);
+    block.insns.push_back(std::move(insn));
+
+    if (block.exit != BlockExit::FALLTHROUGH) break;
+  }
+
+  block.end_pc = insn_pc;
+  code_lo_ = std::min(code_lo_, block.start_pc);
+  code_hi_ = std::max(code_hi_, block.end_pc);
+}
+
+template <typename MemPolicy>
+const BasicBlock& BasicRVModel<MemPolicy>::getBlock(addr_t pc) {
+  if (blocks_dirty_) flushBlocks();
+
+  auto found = blocks_.find(pc);
+  if (found != blocks_.end()) return found->second;
+
+  BasicBlock& block = blocks_[pc];
+  decodeBlock(block, pc, MAX_BLOCK_INSNS);
+
+  return block;
+}
+
+// a guest access faulting on a protected host page jumps back here and so does
+// an insn which traps, insns run a frame deeper and nothing on the way has to be
+// destroyed, the jump is set up only if guest has a trap handler or HostMem is used
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::executeBlock(const BasicBlock& block) {
+  curr_block_ = &block;
+  trap_jump_ = trapsEnabled();
+
+  std::size_t retired = block.retired();
+  if (MemPolicy::HOST_MMU || trap_jump_) {
+    switch (sigsetjmp(fault_.env, 0))
+    {
+    case 0:
+      executeInsns(block);
+      break;
+
+    case TRAP_JUMP:
+      retired = block.insnIndex(pc_); // the trapped insn does not retire
+      enterTrap(trap_.cause, trap_.tval);
+      break;
+
+    default:
+      retired = block.insnIndex(pc_);
+      hostFault();
+      break;
+    }
+  } else {
+    executeInsns(block);
+  }
+
+  trap_jump_ = false;
 
-  while (execution && is_valid_) {
-    addr_t insn_code = mem_.readWord(pc_); // fetch
-    std::unique_ptr<IInsn> insn = decode(insn_code);
+  instret_ += retired;
+  cycle_ += retired;
 
-    printInsn(std::cerr, *insn);
+  curr_block_ = nullptr;
+
+  if (retired == block.retired()) {
+    for (auto* observer : observers_) observer->onBlock(block, pc_, instret_);
+    return;
+  }
+
+  // observers see only the insns retired before the trap, as the block did not
+  // leave by its last insn, they do not take the jump to handler for its exit
+  if (observers_.empty()) return;
+
+  BasicBlock retired_part;
+  decodeBlock(retired_part, block.start_pc, retired);
+  retired_part.exit = BlockExit::TRAP;
+
+  for (auto* observer : observers_) observer->onBlock(retired_part, pc_, instret_);
+}
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::executeInsns(const BasicBlock& block) {
+  for (auto&& insn : block.insns) {
+    if (trace_) printInsn(std::cerr, *insn);
 
     if (insn->getType() == RVInsnType::UNDEF_TYPE_INSN) {
-      break; // todo should refactor this
+      undefInsn(*insn);
+      break;
     }
 
+    next_pc_ = pc_ + insn->getSize();
     insn->execute(*this);
 
-    setPC(pc_ + sizeof(word_t) * execution); // advance if executing, else - do nothing
+    // jump to itself (j .) can never make progress, this is how bare-metal
+    // programs halt, so does the simulation, unless an interrupt may still
+    // come and take the hart out of the loop
+    if (isSelfLoop(*insn) && !waitsForInterrupt()) exit();
+
+    if (!execution) break; // stopped insn keeps pc pointing at itself
+    setPC(next_pc_);
   }
+}
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::addObserver(IExecObserver* observer) {
+  assert(observer && "Observer is null");
+  observers_.push_back(observer);
+}
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::removeObserver(IExecObserver* observer) {
+  std::erase(observers_, observer);
+}
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::flushBlocks() {
+  blocks_.clear();
+  code_lo_ = std::numeric_limits<addr_t>::max();
+  code_hi_ = 0;
+  blocks_dirty_ = false;
+}
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::resetExecState() {
+  flushBlocks();
+  fregs_ = FPRegisterFile{}; // f and v registers are not a part of bstate
+  vregs_ = VectorRegisterFile{};
+  instret_ = 0;
+  cycle_ = 0;
+  events_.clear(); // devices are dropped with memory, so are their events
+  mcsr_ = TrapCSRs{};
+  irq_ready_ = false;
+  execution = true;
+  env_.reset();
+}
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::execute() {
+  std::cerr << "DBG: begin execution (pc = " << pc_ << ")\n";
+
+  run(std::numeric_limits<uint64_t>::max());
 
   std::cerr << "DBG: end execution (pc = " << pc_ << ")\n";
 }
 
+template <typename MemPolicy>
+bool BasicRVModel<MemPolicy>::run(uint64_t instret_limit, std::optional<addr_t> break_pc) {
+  if constexpr (MemPolicy::HOST_MMU) {
+    // pages are protected only while guest runs, so the model is copied,
+    // dumped and loaded between runs as any other one
+    HostFaultScope scope{fault_, mem_.hostMemory()};
+    mem_.protect(true);
+    bool running = runBlocks(instret_limit, break_pc);
+    mem_.protect(false);
+
+    return running;
+  } else {
+    return runBlocks(instret_limit, break_pc);
+  }
+}
+
+// run stops exactly on the limit, events fire exactly on their time: the block
+// which crosses either is decoded once more up to the stop point, so observers
+// see only retired insns
+template <typename MemPolicy>
+bool BasicRVModel<MemPolicy>::runBlocks(uint64_t instret_limit,
+                                        std::optional<addr_t> break_pc) {
+  addr_t stop_pc = break_pc.value_or(0);
+
+  while (execution && is_valid_ && instret_ < instret_limit) {
+    // one compare per block while no event is due, callbacks may stop the model
+    if (instret_ >= events_.nextDeadline()) {
+      events_.advance(instret_);
+      if (!execution) break;
+    }
+
+    // interrupts are taken between blocks, so insns never poll for them
+    if (irq_ready_) [[unlikely]] takeInterrupt();
+
+    if (break_pc && pc_ == stop_pc) break;
+
+    const BasicBlock& block = getBlock(pc_);
+
+    uint64_t stop_instret = std::min(instret_limit, events_.nextDeadline());
+    std::size_t n_insns = block.size();
+    if (stop_instret - instret_ < n_insns) n_insns = stop_instret - instret_;
+    if (break_pc && stop_pc > block.start_pc && stop_pc < block.end_pc) {
+      std::size_t n_before = 0; // insns before stop_pc
+      for (addr_t pc = block.start_pc; pc < stop_pc; pc += block.insns[n_before++]->getSize());
+      n_insns = std::min(n_insns, n_before);
+    }
+
+    if (n_insns == block.size()) {
+      executeBlock(block);
+      continue;
+    }
+
+    BasicBlock partial;
+    decodeBlock(partial, pc_, n_insns);
+    executeBlock(partial);
+  }
+
+  return execution && is_valid_;
+}
+
 // todo this function should somehow return control to exec env
 // not figured out how to implement it correctly yet
 // so this is a workaround
-void RVModel::exit() {
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::exit() {
   execution = false;
+  env_.flush();
 }
 
-void RVModel::printInsn(std::ostream& out, const IInsn& insn) {
-  out << insn << ' ' << insn.getName() << " <pc = " << getPC() << ">\n";
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::printInsn(std::ostream& out, const IInsn& insn) {
+  out << insn << ' ' << insn.getName();
+  if (insn.getSize() == sizeof(half_t)) out << " (compressed)";
+  out << " <pc = " << getPC() << ">\n";
 }
 
-std::ostream& RVModel::print(std::ostream& out) {
+template <typename MemPolicy>
+std::ostream& BasicRVModel<MemPolicy>::print(std::ostream& out) {
   out << "pc = " << getPC() << '\n';
   regs_.print(out);
   mem_.print(out);
   return out;
 }
 
-void RVModel::binaryDump(std::ofstream& fout) {
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::binaryDump(std::ofstream& fout) {
   if (!fout) {
     std::cerr << "ERROR: wrong fout\n";
     return;
@@ -262,15 +829,481 @@ void RVModel::binaryDump(std::ofstream& fout) {
   mem_.binaryDump(fout);
 }
 
-addr_t RVModel::getReg(Register reg) const {
+template <typename MemPolicy>
+bool BasicRVModel<MemPolicy>::saveCheckpoint(const std::filesystem::path& bstate_path) {
+  const char* reason = mem_.hasDevices()    ? "devices are attached" :
+                       env_.hasFileState()  ? "guest has opened or closed files" : nullptr;
+  if (reason) {
+    std::cerr << "ERROR: cannot checkpoint at insn " << instret_ << ": " << reason << "\n";
+    return false;
+  }
+
+  std::ofstream bstate_file{bstate_path};
+  std::ofstream context_file{std::filesystem::path{bstate_path}.replace_extension(".ctx")};
+  if (!bstate_file || !context_file) {
+    std::cerr << "ERROR: wrong checkpoint file " << bstate_path << "\n";
+    return false;
+  }
+
+  binaryDump(bstate_file);
+  dumpContext(context_file);
+
+  return bstate_file && context_file;
+}
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::initCheckpoint(const std::filesystem::path& bstate_path) {
+  std::filesystem::path path = bstate_path;
+  init(path);
+  if (!is_valid_) return;
+
+  std::ifstream context_file{path.replace_extension(".ctx")};
+  if (!context_file) {
+    std::cerr << "ERROR: failed to open checkpoint context " << path << "\n";
+    is_valid_ = false;
+    return;
+  }
+
+  is_valid_ = initContext(context_file);
+}
+
+// text lines of <key> <values> as in checkpoint manifest, zero registers are omitted,
+// as init leaves them zero
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::dumpContext(std::ostream& out) const {
+  for (auto&& seg : mem_.getSegments()) {
+    out << "segment " << seg.getVaddr() << ' ' << seg.getSize() << ' '
+        << unsigned{seg.getRights()} << ' ' << unsigned{seg.getAlign()} << '\n';
+  }
+
+  if (mem_.hasHeap()) out << "heap " << mem_.getHeapLimit() << '\n';
+
+  if constexpr (EXT_F) {
+    out << "fcsr " << fregs_.getFCSR() << '\n';
+    for (uint8_t i = 0; i != N_REGS; ++i) {
+      word_t val = fregs_.get(static_cast<Register>(i));
+      if (val) out << "freg " << unsigned{i} << ' ' << val << '\n';
+    }
+  }
+
+  if constexpr (EXT_V) {
+    out << "vtype " << vregs_.getVType().bits << ' ' << vregs_.getVL() << '\n';
+    for (uint8_t i = 0; i != N_REGS; ++i) {
+      const byte_t* vreg = vregs_.reg(static_cast<Register>(i));
+      if (std::all_of(vreg, vreg + VLENB, [](byte_t byte) { return byte == 0; })) continue;
+
+      out << "vreg " << unsigned{i} << ' ' << std::hex << std::setfill('0');
+      for (unsigned j = 0; j != VLENB; ++j) out << std::setw(2) << unsigned{vreg[j]};
+      out << std::dec << std::setfill(' ') << '\n';
+    }
+  }
+
+  if constexpr (EXT_ZICSR) {
+    out << "trap " << mcsr_.mstatus << ' ' << mcsr_.mie << ' ' << mcsr_.mip << ' '
+        << mcsr_.mtvec << ' ' << mcsr_.mscratch << ' ' << mcsr_.mepc << ' '
+        << mcsr_.mcause << ' ' << mcsr_.mtval << '\n';
+  }
+}
+
+template <typename MemPolicy>
+bool BasicRVModel<MemPolicy>::initContext(std::istream& in) {
+  std::vector<Segment> segments;
+  std::optional<addr_t> heap_limit;
+
+  for (std::string line; std::getline(in, line); ) {
+    std::istringstream fields{line};
+    std::string key;
+    if (!(fields >> key)) continue; // empty line
+
+    bool ok = false;
+    if (key == "segment") {
+      addr_t vaddr = 0, size = 0;
+      unsigned rights = 0, align = 0;
+      ok = static_cast<bool>(fields >> vaddr >> size >> rights >> align);
+      segments.emplace_back(vaddr, size, rights, align);
+    } else if (key == "heap") {
+      addr_t limit = 0;
+      ok = static_cast<bool>(fields >> limit);
+      heap_limit = limit;
+    } else if (EXT_F && key == "fcsr") {
+      word_t fcsr = 0;
+      ok = static_cast<bool>(fields >> fcsr);
+      fregs_.setFCSR(fcsr);
+    } else if (EXT_F && key == "freg") {
+      unsigned idx = 0;
+      word_t val = 0;
+      ok = fields >> idx >> val && idx < N_REGS;
+      if (ok) fregs_.set(static_cast<Register>(idx), val);
+    } else if (EXT_V && key == "vtype") {
+      word_t bits = 0, vl = 0;
+      ok = static_cast<bool>(fields >> bits >> vl);
+      ok = ok && vregs_.setConfig(vl, bits) == vl;
+    } else if (EXT_V && key == "vreg") {
+      unsigned idx = 0;
+      std::string bytes;
+      ok = fields >> idx >> bytes && idx < N_REGS && bytes.size() == 2 * VLENB &&
+           bytes.find_first_not_of("0123456789abcdef") == std::string::npos;
+      for (unsigned j = 0; ok && j != VLENB; ++j) {
+        byte_t* vreg = vregs_.reg(static_cast<Register>(idx));
+        vreg[j] = static_cast<byte_t>(std::stoul(bytes.substr(2 * j, 2), nullptr, 16));
+      }
+    } else if (EXT_ZICSR && key == "trap") {
+      ok = static_cast<bool>(fields >> mcsr_.mstatus >> mcsr_.mie >> mcsr_.mip
+                                    >> mcsr_.mtvec >> mcsr_.mscratch >> mcsr_.mepc
+                                    >> mcsr_.mcause >> mcsr_.mtval);
+    }
+
+    if (!ok) {
+      std::cerr << "ERROR: malformed checkpoint context line <" << line << ">\n";
+      return false;
+    }
+  }
+
+  if (!segments.empty() && !mem_.setLayout(std::move(segments), heap_limit)) {
+    std::cerr << "ERROR: checkpoint segments do not fit in its memory\n";
+    return false;
+  }
+
+  updateInterrupts();
+  return true;
+}
+
+template <typename MemPolicy>
+reg_t BasicRVModel<MemPolicy>::getReg(Register reg) const {
   return regs_.get(reg);
 }
 
-void RVModel::setReg(Register reg, word_t val) {
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::setReg(Register reg, reg_t val) {
   regs_.set(reg, val);
 }
 
-addr_t RVModel::setUpEnvironment(addr_t pc_main) {
+template <typename MemPolicy>
+std::optional<RoundingMode> BasicRVModel<MemPolicy>::getRoundingMode(uint8_t rm) {
+  if (rm == static_cast<uint8_t>(RoundingMode::DYN)) rm = fregs_.getRM();
+  if (rm <= static_cast<uint8_t>(RoundingMode::RMM)) return static_cast<RoundingMode>(rm);
+
+  raiseTrap(TrapCause::ILLEGAL_INSN, currInsnCode());
+  std::cerr << "ERROR: reserved rounding mode " << unsigned(rm)
+            << " <pc = " << pc_ << ">\n";
+  exit();
+  return std::nullopt;
+}
+
+// time is not modelled separately: timer ticks once per cycle,
+// on RV64 counters are read whole and their *h halves do not exist
+template <typename MemPolicy>
+reg_t BasicRVModel<MemPolicy>::readCSR(csr_t csr) {
+  uint64_t cycle = cycle_ + retiredInBlock();
+  uint64_t instret = instret_ + retiredInBlock();
+
+  switch (csr)
+  {
+  case CSR_CYCLE:
+  case CSR_TIME:
+  case CSR_MCYCLE:
+    return static_cast<reg_t>(cycle);
+
+  case CSR_CYCLEH:
+  case CSR_TIMEH:
+  case CSR_MCYCLEH:
+    if constexpr (XLEN == 64) break;
+    return hi32(cycle);
+
+  case CSR_INSTRET:
+  case CSR_MINSTRET:
+    return static_cast<reg_t>(instret);
+
+  case CSR_INSTRETH:
+  case CSR_MINSTRETH:
+    if constexpr (XLEN == 64) break;
+    return hi32(instret);
+
+  // CSRs of extensions not in the core do not exist either
+  case CSR_FFLAGS:
+    if constexpr (!EXT_F) break;
+    return fregs_.getFlags();
+
+  case CSR_FRM:
+    if constexpr (!EXT_F) break;
+    return fregs_.getRM();
+
+  case CSR_FCSR:
+    if constexpr (!EXT_F) break;
+    return fregs_.getFCSR();
+
+  case CSR_VSTART:
+    if constexpr (!EXT_V) break;
+    return 0;
+
+  case CSR_VL:
+    if constexpr (!EXT_V) break;
+    return vregs_.getVL();
+
+  case CSR_VTYPE:
+    if constexpr (!EXT_V) break;
+    return vregs_.getVType().bits;
+
+  case CSR_VLENB:
+    if constexpr (!EXT_V) break;
+    return VLENB;
+
+  case CSR_MSTATUS:
+    return mcsr_.mstatus | MSTATUS_MPP;
+
+  case CSR_MIE:
+    return mcsr_.mie;
+
+  case CSR_MIP:
+    return mcsr_.mip;
+
+  case CSR_MTVEC:
+    return mcsr_.mtvec;
+
+  case CSR_MSCRATCH:
+    return mcsr_.mscratch;
+
+  case CSR_MEPC:
+    return mcsr_.mepc;
+
+  case CSR_MCAUSE:
+    return mcsr_.mcause;
+
+  case CSR_MTVAL:
+    return mcsr_.mtval;
+
+  case CSR_MHARTID:
+    return 0;
+
+  default:
+    break;
+  }
+
+  unsupportedCSR(csr);
+  return 0;
+}
+
+// written value is what counter holds after the writing insn retires,
+// so the part of the current block which is yet to be added is subtracted
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::writeCSR(csr_t csr, reg_t val) {
+  if (isCSRReadOnly(csr)) {
+    raiseTrap(TrapCause::ILLEGAL_INSN, currInsnCode());
+    std::cerr << "ERROR: write to read-only CSR 0x" << std::hex << csr << std::dec
+              << " <pc = " << pc_ << ">\n";
+    exit();
+    return;
+  }
+
+  uint64_t in_block = retiredInBlock() + 1;
+
+  switch (csr)
+  {
+  case CSR_MCYCLE:
+    if constexpr (XLEN == 64) cycle_ = val - in_block;
+    else cycle_ = ((cycle_ + in_block) & 0xFFFF'FFFF'0000'0000) + val - in_block;
+    break;
+
+  case CSR_MCYCLEH:
+    if constexpr (XLEN == 64) { unsupportedCSR(csr); break; }
+    cycle_ = ((uint64_t(val) << 32) | lo32(cycle_ + in_block)) - in_block;
+    break;
+
+  case CSR_MINSTRET:
+    if constexpr (XLEN == 64) instret_ = val - in_block;
+    else instret_ = ((instret_ + in_block) & 0xFFFF'FFFF'0000'0000) + val - in_block;
+    break;
+
+  case CSR_MINSTRETH:
+    if constexpr (XLEN == 64) { unsupportedCSR(csr); break; }
+    instret_ = ((uint64_t(val) << 32) | lo32(instret_ + in_block)) - in_block;
+    break;
+
+  case CSR_FFLAGS:
+    if constexpr (!EXT_F) { unsupportedCSR(csr); break; }
+    fregs_.setFlags(val);
+    break;
+
+  case CSR_FRM:
+    if constexpr (!EXT_F) { unsupportedCSR(csr); break; }
+    fregs_.setRM(val);
+    break;
+
+  case CSR_FCSR:
+    if constexpr (!EXT_F) { unsupportedCSR(csr); break; }
+    fregs_.setFCSR(val);
+    break;
+
+  case CSR_VSTART: // vector insns are never interrupted, they always start from 0
+    if constexpr (!EXT_V) unsupportedCSR(csr);
+    break;
+
+  // csr insns end blocks, so interrupts enabled here are taken right after them
+  case CSR_MSTATUS:
+    mcsr_.mstatus = val & (MSTATUS_MIE | MSTATUS_MPIE);
+    updateInterrupts();
+    break;
+
+  case CSR_MIE:
+    mcsr_.mie = val & (MIP_MSIP | MIP_MTIP);
+    updateInterrupts();
+    break;
+
+  case CSR_MIP: // pending bits are set by CLINT only
+    break;
+
+  case CSR_MTVEC: // modes above vectored are reserved
+    mcsr_.mtvec = val & ~(MTVEC_MODE_MASK & ~MTVEC_VECTORED);
+    updateInterrupts();
+    break;
+
+  case CSR_MSCRATCH:
+    mcsr_.mscratch = val;
+    break;
+
+  case CSR_MEPC:
+    mcsr_.mepc = val & ~reg_t(IALIGN - 1);
+    break;
+
+  case CSR_MCAUSE:
+    mcsr_.mcause = val;
+    break;
+
+  case CSR_MTVAL:
+    mcsr_.mtval = val;
+    break;
+
+  default:
+    unsupportedCSR(csr);
+    break;
+  }
+}
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::unsupportedCSR(csr_t csr) {
+  raiseTrap(TrapCause::ILLEGAL_INSN, currInsnCode());
+  std::cerr << "ERROR: unsupported CSR 0x" << std::hex << csr << std::dec
+            << " <pc = " << pc_ << ">\n";
+  exit();
+}
+
+// mepc is the insn which trapped or the one to be executed after interrupt
+template <typename MemPolicy>
+bool BasicRVModel<MemPolicy>::enterTrap(reg_t cause, reg_t tval) {
+  if (!trapsEnabled()) return false;
+
+  mcsr_.mepc = pc_;
+  mcsr_.mcause = cause;
+  mcsr_.mtval = tval;
+
+  reg_t mie = mcsr_.mstatus & MSTATUS_MIE;
+  mcsr_.mstatus &= ~(MSTATUS_MIE | MSTATUS_MPIE);
+  if (mie) mcsr_.mstatus |= MSTATUS_MPIE;
+
+  addr_t handler = mcsr_.mtvec & ~MTVEC_MODE_MASK;
+  if ((cause & MCAUSE_INTERRUPT) && (mcsr_.mtvec & MTVEC_MODE_MASK) == MTVEC_VECTORED)
+    handler += sizeof(word_t) * (cause & ~MCAUSE_INTERRUPT);
+
+  pc_ = handler;
+  updateInterrupts();
+  return true;
+}
+
+// jump is set only while a block is executed with a handler in place
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::raiseTrap(TrapCause cause, reg_t tval) const {
+  if (!trap_jump_) return;
+
+  trap_ = Trap {static_cast<reg_t>(cause), tval};
+  siglongjmp(fault_.env, TRAP_JUMP);
+}
+
+// undefined insn is illegal, or it could not be fetched at all
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::undefInsn(const IInsn& insn) {
+  bool fetched = mem_.checkAccess(pc_, insn.getSize(), RIGHTS_X) == MemCheck::OK;
+  bool trapped = fetched ? enterTrap(TrapCause::ILLEGAL_INSN, insn.getCode())
+                         : enterTrap(TrapCause::INSN_ACCESS_FAULT, pc_);
+
+  if (!trapped) execution = false;
+}
+
+// mtval of illegal insn, compressed one is seen expanded
+template <typename MemPolicy>
+reg_t BasicRVModel<MemPolicy>::currInsnCode() const {
+  if (!curr_block_) return 0;
+
+  std::size_t idx = curr_block_->insnIndex(pc_);
+  return idx < curr_block_->size() ? curr_block_->insns[idx]->getCode() : 0;
+}
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::updateInterrupts() {
+  irq_ready_ = trapsEnabled() && (mcsr_.mstatus & MSTATUS_MIE) && (mcsr_.mip & mcsr_.mie);
+}
+
+// software interrupt has priority over timer one
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::takeInterrupt() {
+  reg_t pending = mcsr_.mip & mcsr_.mie;
+  reg_t irq = pending & MIP_MSIP ? IRQ_M_SOFTWARE : IRQ_M_TIMER;
+
+  enterTrap(MCAUSE_INTERRUPT | irq, 0);
+}
+
+// interrupt may come if it is enabled and there are device events yet to fire
+template <typename MemPolicy>
+bool BasicRVModel<MemPolicy>::waitsForInterrupt() const {
+  return irq_ready_ ||
+         (trapsEnabled() && (mcsr_.mstatus & MSTATUS_MIE) && mcsr_.mie && !events_.empty());
+}
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::setInterruptPending(reg_t irq_mask, bool pending) {
+  if (pending) mcsr_.mip |= irq_mask;
+  else mcsr_.mip &= ~irq_mask;
+
+  updateInterrupts();
+}
+
+// with a handler guest services its own ecalls (e.g. yield of RTOS)
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::ecall() {
+  raiseTrap(TrapCause::ECALL_M, 0);
+  env_.syscall(*this);
+}
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::ebreak() {
+  raiseTrap(TrapCause::BREAKPOINT, pc_);
+  exit();
+}
+
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::illegalInsn() {
+  raiseTrap(TrapCause::ILLEGAL_INSN, currInsnCode());
+  exit();
+}
+
+// mret ends a block, so interrupts it enables are taken right after it
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::mret() {
+  reg_t mpie = mcsr_.mstatus & MSTATUS_MPIE;
+  mcsr_.mstatus = (mcsr_.mstatus & ~MSTATUS_MIE) | MSTATUS_MPIE;
+  if (mpie) mcsr_.mstatus |= MSTATUS_MIE;
+
+  setNextPC(mcsr_.mepc);
+  updateInterrupts();
+}
+
+// wfi resumes on an interrupt pending in mie even if mstatus.MIE keeps it from being taken
+template <typename MemPolicy>
+void BasicRVModel<MemPolicy>::wfi() {
+  if (!(mcsr_.mip & mcsr_.mie) && !(mcsr_.mie && !events_.empty())) exit();
+}
+
+template <typename MemPolicy>
+addr_t BasicRVModel<MemPolicy>::setUpEnvironment(addr_t pc_main) {
   assert(pc_main < mem_.size() && "pc of main is set too high");
 
   addr_t env_vaddr = mem_.pushSegment(
@@ -283,14 +1316,15 @@ addr_t RVModel::setUpEnvironment(addr_t pc_main) {
 
   rvJAL jal_main;
   jal_main.encode(Register::X1,
-    static_cast<sword_t>(pc_main) - static_cast<sword_t>(env_vaddr) - sizeof(addr_t)
+    static_cast<sword_t>(pc_main) - static_cast<sword_t>(env_vaddr)
   );
 
   rvEBREAK ebreak;
 
   // emit environment code
   writeWord(env_vaddr, jal_main.getCode());
-  writeWord(env_vaddr + sizeof(addr_t), ebreak.getCode());
+  // jal_main links ra to the very next insn
+  writeWord(env_vaddr + jal_main.getSize(), ebreak.getCode());
 
   return env_vaddr;
 }
@@ -310,63 +1344,286 @@ void rvSUB::execute(IRVModel& model) const {
 void rvSLL::execute(IRVModel& model) const {
   addr_t op1 = model.getReg(rs1_);
   addr_t op2 = model.getReg(rs2_);
-  model.setReg(dst_, op1 << (op2 & MASK_4_0));
+  model.setReg(dst_, op1 << (op2 & SHAMT_MASK));
+}
+
+void rvSLT::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, std::bit_cast<sreg_t>(op1) < std::bit_cast<sreg_t>(op2));
+}
+
+void rvSLTU::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, op1 < op2);
+}
+
+void rvXOR::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, op1 ^ op2);
+}
+
+void rvSRL::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, op1 >> (op2 & SHAMT_MASK));
+}
+
+void rvSRA::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, std::bit_cast<sreg_t>(op1) >> (op2 & SHAMT_MASK));
+}
+
+void rvOR::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, op1 | op2);
+}
+
+void rvAND::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, op1 & op2);
+}
+
+#if RVSIM_EXT_M
+// RV32M: high parts are taken from double width host products
+// (64-bit on RV32, 128-bit on RV64)
+void rvMUL::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, op1 * op2);
+}
+
+void rvMULH::execute(IRVModel& model) const {
+  sdreg_t op1 = std::bit_cast<sreg_t>(model.getReg(rs1_));
+  sdreg_t op2 = std::bit_cast<sreg_t>(model.getReg(rs2_));
+  model.setReg(dst_, static_cast<dreg_t>(op1 * op2) >> XLEN);
+}
+
+void rvMULHSU::execute(IRVModel& model) const {
+  sdreg_t op1 = std::bit_cast<sreg_t>(model.getReg(rs1_));
+  sdreg_t op2 = static_cast<dreg_t>(model.getReg(rs2_));
+  model.setReg(dst_, static_cast<dreg_t>(op1 * op2) >> XLEN);
+}
+
+void rvMULHU::execute(IRVModel& model) const {
+  dreg_t op1 = model.getReg(rs1_);
+  dreg_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, (op1 * op2) >> XLEN);
+}
+
+// division never traps: by zero quotient is all ones and remainder is
+// the dividend, overflow (INT_MIN / -1) gives INT_MIN and remainder 0
+void rvDIV::execute(IRVModel& model) const {
+  sreg_t op1 = std::bit_cast<sreg_t>(model.getReg(rs1_));
+  sreg_t op2 = std::bit_cast<sreg_t>(model.getReg(rs2_));
+
+  if (op2 == 0)
+    model.setReg(dst_, ~reg_t(0));
+  else if (op1 == std::numeric_limits<sreg_t>::min() && op2 == -1)
+    model.setReg(dst_, std::bit_cast<reg_t>(op1));
+  else
+    model.setReg(dst_, std::bit_cast<reg_t>(op1 / op2));
+}
+
+void rvDIVU::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, op2 == 0 ? ~reg_t(0) : op1 / op2);
+}
+
+void rvREM::execute(IRVModel& model) const {
+  sreg_t op1 = std::bit_cast<sreg_t>(model.getReg(rs1_));
+  sreg_t op2 = std::bit_cast<sreg_t>(model.getReg(rs2_));
+
+  if (op2 == 0)
+    model.setReg(dst_, std::bit_cast<reg_t>(op1));
+  else if (op1 == std::numeric_limits<sreg_t>::min() && op2 == -1)
+    model.setReg(dst_, 0);
+  else
+    model.setReg(dst_, std::bit_cast<reg_t>(op1 % op2));
+}
+
+void rvREMU::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, op2 == 0 ? op1 : op1 % op2);
+}
+#endif
+
+#if RVSIM_EXT_ZBA
+void rvSH1ADD::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, (op1 << 1) + op2);
+}
+
+void rvSH2ADD::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, (op1 << 2) + op2);
+}
+
+void rvSH3ADD::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, (op1 << 3) + op2);
+}
+#endif
+
+#if RVSIM_EXT_ZBB
+void rvANDN::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, op1 & ~op2);
+}
+
+void rvORN::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, op1 | ~op2);
+}
+
+void rvXNOR::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, ~(op1 ^ op2));
+}
+
+void rvMIN::execute(IRVModel& model) const {
+  sreg_t op1 = std::bit_cast<sreg_t>(model.getReg(rs1_));
+  sreg_t op2 = std::bit_cast<sreg_t>(model.getReg(rs2_));
+  model.setReg(dst_, std::min(op1, op2));
 }
 
-void rvSLT::execute(IRVModel& model) const {
+void rvMINU::execute(IRVModel& model) const {
   addr_t op1 = model.getReg(rs1_);
   addr_t op2 = model.getReg(rs2_);
-  model.setReg(dst_, std::bit_cast<sword_t>(op1) < std::bit_cast<sword_t>(op2));
+  model.setReg(dst_, std::min(op1, op2));
 }
 
-void rvSLTU::execute(IRVModel& model) const {
-  addr_t op1 = model.getReg(rs1_);
-  addr_t op2 = model.getReg(rs2_);
-  model.setReg(dst_, op1 < op2);
+void rvMAX::execute(IRVModel& model) const {
+  sreg_t op1 = std::bit_cast<sreg_t>(model.getReg(rs1_));
+  sreg_t op2 = std::bit_cast<sreg_t>(model.getReg(rs2_));
+  model.setReg(dst_, std::max(op1, op2));
 }
 
-void rvXOR::execute(IRVModel& model) const {
+void rvMAXU::execute(IRVModel& model) const {
   addr_t op1 = model.getReg(rs1_);
   addr_t op2 = model.getReg(rs2_);
-  model.setReg(dst_, op1 ^ op2);
+  model.setReg(dst_, std::max(op1, op2));
 }
 
-void rvSRL::execute(IRVModel& model) const {
+void rvROL::execute(IRVModel& model) const {
   addr_t op1 = model.getReg(rs1_);
   addr_t op2 = model.getReg(rs2_);
-  model.setReg(dst_, op1 >> (op2 & MASK_4_0));
+  model.setReg(dst_, std::rotl(op1, op2 & SHAMT_MASK));
 }
 
-void rvSRA::execute(IRVModel& model) const {
+void rvROR::execute(IRVModel& model) const {
   addr_t op1 = model.getReg(rs1_);
   addr_t op2 = model.getReg(rs2_);
-  model.setReg(dst_, std::bit_cast<sword_t>(op1) >> (op2 & MASK_4_0));
+  model.setReg(dst_, std::rotr(op1, op2 & SHAMT_MASK));
 }
 
-void rvOR::execute(IRVModel& model) const {
+void rvZEXT_H::execute(IRVModel& model) const {
   addr_t op1 = model.getReg(rs1_);
-  addr_t op2 = model.getReg(rs2_);
-  model.setReg(dst_, op1 | op2);
+  model.setReg(dst_, static_cast<half_t>(op1));
 }
+#endif
 
-void rvAND::execute(IRVModel& model) const {
-  addr_t op1 = model.getReg(rs1_);
-  addr_t op2 = model.getReg(rs2_);
-  model.setReg(dst_, op1 & op2);
+// RV64: *w ops take the low 32 bits of operands and sign extend the result
+void rvADDW::execute(IRVModel& model) const {
+  word_t op1 = model.getReg(rs1_);
+  word_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, sign_extend_32_to_32(op1 + op2));
+}
+
+void rvSUBW::execute(IRVModel& model) const {
+  word_t op1 = model.getReg(rs1_);
+  word_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, sign_extend_32_to_32(op1 - op2));
+}
+
+void rvSLLW::execute(IRVModel& model) const {
+  word_t op1 = model.getReg(rs1_);
+  word_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, sign_extend_32_to_32(op1 << (op2 & MASK_4_0)));
+}
+
+void rvSRLW::execute(IRVModel& model) const {
+  word_t op1 = model.getReg(rs1_);
+  word_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, sign_extend_32_to_32(op1 >> (op2 & MASK_4_0)));
+}
+
+void rvSRAW::execute(IRVModel& model) const {
+  word_t op1 = model.getReg(rs1_);
+  word_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, sign_extend_32_to_32(op1) >> (op2 & MASK_4_0));
+}
+
+#if RVSIM_EXT_M
+void rvMULW::execute(IRVModel& model) const {
+  word_t op1 = model.getReg(rs1_);
+  word_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, sign_extend_32_to_32(op1 * op2));
+}
+
+// the same corner cases as of div and rem, but on 32 bits
+void rvDIVW::execute(IRVModel& model) const {
+  sword_t op1 = sign_extend_32_to_32(model.getReg(rs1_));
+  sword_t op2 = sign_extend_32_to_32(model.getReg(rs2_));
+
+  if (op2 == 0)
+    model.setReg(dst_, ~reg_t(0));
+  else if (op1 == std::numeric_limits<sword_t>::min() && op2 == -1)
+    model.setReg(dst_, op1);
+  else
+    model.setReg(dst_, op1 / op2);
+}
+
+void rvDIVUW::execute(IRVModel& model) const {
+  word_t op1 = model.getReg(rs1_);
+  word_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, op2 == 0 ? ~reg_t(0) : sign_extend_32_to_32(op1 / op2));
 }
 
+void rvREMW::execute(IRVModel& model) const {
+  sword_t op1 = sign_extend_32_to_32(model.getReg(rs1_));
+  sword_t op2 = sign_extend_32_to_32(model.getReg(rs2_));
+
+  if (op2 == 0)
+    model.setReg(dst_, op1);
+  else if (op1 == std::numeric_limits<sword_t>::min() && op2 == -1)
+    model.setReg(dst_, 0);
+  else
+    model.setReg(dst_, op1 % op2);
+}
+
+void rvREMUW::execute(IRVModel& model) const {
+  word_t op1 = model.getReg(rs1_);
+  word_t op2 = model.getReg(rs2_);
+  model.setReg(dst_, sign_extend_32_to_32(op2 == 0 ? op1 : op1 % op2));
+}
+#endif
+
 void rvUNDEF_R::execute(IRVModel& model) const {
-  // do nothing
+  model.illegalInsn();
 }
 
 void rvJALR::execute(IRVModel& model) const {
-  addr_t ret_addr = model.getPC(); // actual return address will be set at
-                                   // advance pc stage, where pc += 4
-  model.setReg(rd_, ret_addr);
-
+  // target is computed first, as rd may be the same as rs1
   addr_t jmp_addr = model.getReg(rs1_) + sign_extend_12_to_32(imm_);
-  jmp_addr &= 0xFFFF'FFFE; // clear least significant bit
-  model.setPC(jmp_addr);
+  jmp_addr &= ~addr_t(1); // clear least significant bit
+
+  // misaligned target traps, then rd is left as is
+  model.setNextPC(jmp_addr);
+  model.setReg(rd_, model.getPC() + getSize()); // c.jalr links to pc + 2
 }
 
 void rvLB::execute(IRVModel& model) const {
@@ -385,7 +1642,7 @@ void rvLW::execute(IRVModel& model) const {
   addr_t mem_addr = model.getReg(rs1_) + sign_extend_12_to_32(imm_);
   word_t mem_val = model.readWord(mem_addr);
 
-  model.setReg(rd_, mem_val);
+  model.setReg(rd_, sign_extend_32_to_32(mem_val)); // sign extended on RV64
 }
 
 void rvLBU::execute(IRVModel& model) const {
@@ -407,12 +1664,12 @@ void rvADDI::execute(IRVModel& model) const {
 
 void rvSLTI::execute(IRVModel& model) const {
   addr_t op1 = model.getReg(rs1_);
-  model.setReg(rd_, std::bit_cast<sword_t>(op1) < sign_extend_12_to_32(imm_));
+  model.setReg(rd_, std::bit_cast<sreg_t>(op1) < sign_extend_12_to_32(imm_));
 }
 
 void rvSLTIU::execute(IRVModel& model) const {
   addr_t op1 = model.getReg(rs1_);
-  model.setReg(rd_, op1 < std::bit_cast<addr_t>(sign_extend_12_to_32(imm_)));
+  model.setReg(rd_, op1 < static_cast<addr_t>(sign_extend_12_to_32(imm_)));
 }
 
 void rvXORI::execute(IRVModel& model) const {
@@ -442,27 +1699,114 @@ void rvANDI::execute(IRVModel& model) const {
 
 void rvSLLI::execute(IRVModel& model) const {
   addr_t op1 = model.getReg(rs1_);
-  addr_t shamt = imm_ & MASK_4_0;
+  addr_t shamt = imm_ & SHAMT_MASK;
 
   model.setReg(rd_, op1 << shamt);
 }
 
 void rvSRLI::execute(IRVModel& model) const {
   addr_t op1 = model.getReg(rs1_);
-  addr_t shamt = imm_ & MASK_4_0;
+  addr_t shamt = imm_ & SHAMT_MASK;
 
   model.setReg(rd_, op1 >> shamt);
 }
 
 void rvSRAI::execute(IRVModel& model) const {
   addr_t op1 = model.getReg(rs1_);
-  addr_t shamt = imm_ & MASK_4_0;
+  addr_t shamt = imm_ & SHAMT_MASK;
+
+  model.setReg(rd_, std::bit_cast<sreg_t>(op1) >> shamt);
+}
+
+void rvLD::execute(IRVModel& model) const {
+  addr_t mem_addr = model.getReg(rs1_) + sign_extend_12_to_32(imm_);
+  model.setReg(rd_, model.readDouble(mem_addr));
+}
+
+void rvLWU::execute(IRVModel& model) const {
+  addr_t mem_addr = model.getReg(rs1_) + sign_extend_12_to_32(imm_);
+  word_t mem_val = model.readWord(mem_addr);
+  model.setReg(rd_, static_cast<addr_t>(mem_val));
+}
+
+void rvADDIW::execute(IRVModel& model) const {
+  word_t op1 = model.getReg(rs1_);
+  model.setReg(rd_, sign_extend_32_to_32(op1 + sign_extend_12_to_32(imm_)));
+}
+
+void rvSLLIW::execute(IRVModel& model) const {
+  word_t op1 = model.getReg(rs1_);
+  model.setReg(rd_, sign_extend_32_to_32(op1 << (imm_ & MASK_4_0)));
+}
+
+void rvSRLIW::execute(IRVModel& model) const {
+  word_t op1 = model.getReg(rs1_);
+  model.setReg(rd_, sign_extend_32_to_32(op1 >> (imm_ & MASK_4_0)));
+}
+
+void rvSRAIW::execute(IRVModel& model) const {
+  word_t op1 = model.getReg(rs1_);
+  model.setReg(rd_, sign_extend_32_to_32(op1) >> (imm_ & MASK_4_0));
+}
+
+#if RVSIM_EXT_ZBB
+void rvCLZ::execute(IRVModel& model) const {
+  model.setReg(rd_, std::countl_zero(model.getReg(rs1_)));
+}
+
+void rvCTZ::execute(IRVModel& model) const {
+  model.setReg(rd_, std::countr_zero(model.getReg(rs1_)));
+}
+
+void rvCPOP::execute(IRVModel& model) const {
+  model.setReg(rd_, std::popcount(model.getReg(rs1_)));
+}
+
+void rvSEXT_B::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  model.setReg(rd_, static_cast<sword_t>(static_cast<sbyte_t>(op1)));
+}
+
+void rvSEXT_H::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  model.setReg(rd_, static_cast<sword_t>(static_cast<shalf_t>(op1)));
+}
+
+void rvRORI::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t shamt = imm_ & SHAMT_MASK;
+
+  model.setReg(rd_, std::rotr(op1, shamt));
+}
+
+void rvORC_B::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+
+  addr_t res = 0;
+  for (unsigned byte = 0; byte != sizeof(reg_t); ++byte) {
+    addr_t byte_mask = addr_t(0xFF) << (byte * BITS_BYTE);
+    if (op1 & byte_mask) res |= byte_mask;
+  }
+
+  model.setReg(rd_, res);
+}
+
+void rvREV8::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+
+  // std::byteswap is c++23, reverse bytes of the whole XLEN register
+  addr_t res = 0;
+  for (unsigned byte = 0; byte != sizeof(reg_t); ++byte) {
+    res = (res << BITS_BYTE) | (op1 & 0xFF);
+    op1 >>= BITS_BYTE;
+  }
 
-  model.setReg(rd_, std::bit_cast<sword_t>(op1) >> shamt);
+  model.setReg(rd_, res);
 }
+#endif
 
 void rvUNDEF_I::execute(IRVModel& model) const {
-  // do nothing
+  model.illegalInsn();
 }
 
 void rvSB::execute(IRVModel& model) const {
@@ -492,9 +1836,17 @@ void rvSW::execute(IRVModel& model) const {
   model.writeWord(mem_addr, val);
 };
 
+void rvSD::execute(IRVModel& model) const {
+  addr_t op1 = model.getReg(rs1_);
+  addr_t op2 = model.getReg(rs2_);
+  addr_t mem_addr = op1 + sign_extend_12_to_32(imm_);
+
+  model.writeDouble(mem_addr, op2);
+};
+
 void rvUNDEF_S::execute(IRVModel& model) const {
-  // do nothing
   std::cerr << *this << " ??? <pc = " << model.getPC() << ">\n";
+  model.illegalInsn();
 }
 
 void rvBEQ::execute(IRVModel& model) const {
@@ -503,7 +1855,7 @@ void rvBEQ::execute(IRVModel& model) const {
 
   if (op1 == op2) {
     addr_t branch_addr = model.getPC() + sign_extend_13_to_32(imm_);
-    model.setPC(branch_addr);
+    model.setNextPC(branch_addr);
   }
 }
 
@@ -513,17 +1865,17 @@ void rvBNE::execute(IRVModel& model) const {
 
   if (op1 != op2) {
     addr_t branch_addr = model.getPC() + sign_extend_13_to_32(imm_);
-    model.setPC(branch_addr);
+    model.setNextPC(branch_addr);
   }
 }
 
 void rvBLT::execute(IRVModel& model) const {
-  sword_t op1 = std::bit_cast<sword_t>(model.getReg(rs1_));
-  sword_t op2 = std::bit_cast<sword_t>(model.getReg(rs2_));
+  sreg_t op1 = std::bit_cast<sreg_t>(model.getReg(rs1_));
+  sreg_t op2 = std::bit_cast<sreg_t>(model.getReg(rs2_));
 
   if (op1 < op2) {
     addr_t branch_addr = model.getPC() + sign_extend_13_to_32(imm_);
-    model.setPC(branch_addr);
+    model.setNextPC(branch_addr);
   }
 }
 
@@ -533,17 +1885,17 @@ void rvBLTU::execute(IRVModel& model) const {
 
   if (op1 < op2) {
     addr_t branch_addr = model.getPC() + sign_extend_13_to_32(imm_);
-    model.setPC(branch_addr);
+    model.setNextPC(branch_addr);
   }
 }
 
 void rvBGE::execute(IRVModel& model) const {
-  sword_t op1 = std::bit_cast<sword_t>(model.getReg(rs1_));
-  sword_t op2 = std::bit_cast<sword_t>(model.getReg(rs2_));
+  sreg_t op1 = std::bit_cast<sreg_t>(model.getReg(rs1_));
+  sreg_t op2 = std::bit_cast<sreg_t>(model.getReg(rs2_));
 
   if (op1 >= op2) {
     addr_t branch_addr = model.getPC() + sign_extend_13_to_32(imm_);
-    model.setPC(branch_addr);
+    model.setNextPC(branch_addr);
   }
 }
 
@@ -553,75 +1905,503 @@ void rvBGEU::execute(IRVModel& model) const {
 
   if (op1 >= op2) {
     addr_t branch_addr = model.getPC() + sign_extend_13_to_32(imm_);
-    model.setPC(branch_addr);
+    model.setNextPC(branch_addr);
   }
 }
 
 void rvUNDEF_B::execute(IRVModel& model) const {
-  // do nothing
+  model.illegalInsn();
 }
 
+// imm is bits [31:12] of the result, sign extended on RV64
 void rvLUI::execute(IRVModel& model) const {
-  model.setReg(rd_, imm_);
+  model.setReg(rd_, sign_extend_32_to_32(imm_));
 }
 
 void rvAUIPC::execute(IRVModel& model) const {
   addr_t curr_pc = model.getPC();
-  model.setReg(rd_, curr_pc + imm_);
+  model.setReg(rd_, curr_pc + sign_extend_32_to_32(imm_));
 }
 
 void rvUNDEF_U::execute(IRVModel& model) const {
-  // do nothing
+  model.illegalInsn();
 }
 
 void rvJAL::execute(IRVModel& model) const {
   addr_t curr_pc = model.getPC();
 
-  model.setReg(rd_, curr_pc); // actual return address will be set at
-                              // advance pc stage, where pc += 4
-  model.setPC(curr_pc + sign_extend_21_to_32(imm_));
+  // misaligned target traps, then rd is left as is
+  model.setNextPC(curr_pc + sign_extend_21_to_32(imm_));
+  model.setReg(rd_, curr_pc + getSize());
 }
 
 void rvEBREAK::execute(IRVModel& model) const {
-  model.exit();
+  model.ebreak();
 }
 
-// todo implement handlers
+// syscalls are serviced by the execution environment of the model
 void rvECALL::execute(IRVModel& model) const {
-  // Arch/ABI	arg1	arg2	arg3	arg4	arg5	arg6	 syscall No
-  // riscv	    a0	  a1	  a2	  a3	  a4	  a5	      a7
+  model.ecall();
+}
 
-  EESyscall syscall = static_cast<EESyscall>(model.getReg(Register::X17));
+void rvMRET::execute(IRVModel& model) const {
+  model.mret();
+}
 
-  switch (syscall)
-  {
-  case EESyscall::READ:
-  {
-    std::cerr << "READ SYSCALL" << "\n";
-    std::string input (static_cast<uint8_t>(model.getReg(Register::X11)), '\0');
-    std::cin >> input;
-    std::cerr << input << '\n';
-    break;
-  }
-  case EESyscall::WRITE:
-    std::cerr << "WRITE SYSCALL" << "\n";
-    break;
+// hart is never stalled, the next insns are executed until an interrupt comes
+void rvWFI::execute(IRVModel& model) const {
+  model.wfi();
+}
 
-  case EESyscall::EXIT:
-    std::cerr << "EXIT SYSCALL" << "\n";
-    model.exit();
-    break;
+#if RVSIM_EXT_ZICSR
+void rvCSRRW::execute(IRVModel& model) const {
+  reg_t src = model.getReg(rs1_);
 
-  default:
-    std::cerr << "Unknown syscall\n";
-    break;
-  }
+  // csrrw does not read csr if rd = x0
+  reg_t old_val = rd_ != Register::X0 ? model.readCSR(getCSR()) : 0;
+  model.writeCSR(getCSR(), src);
+  model.setReg(rd_, old_val);
+}
+
+void rvCSRRS::execute(IRVModel& model) const {
+  reg_t mask = model.getReg(rs1_);
+  reg_t old_val = model.readCSR(getCSR());
+
+  // csrrs does not write csr if rs1 = x0
+  if (rs1_ != Register::X0) model.writeCSR(getCSR(), old_val | mask);
+  model.setReg(rd_, old_val);
+}
+
+void rvCSRRC::execute(IRVModel& model) const {
+  reg_t mask = model.getReg(rs1_);
+  reg_t old_val = model.readCSR(getCSR());
+
+  // csrrc does not write csr if rs1 = x0
+  if (rs1_ != Register::X0) model.writeCSR(getCSR(), old_val & ~mask);
+  model.setReg(rd_, old_val);
+}
+
+void rvCSRRWI::execute(IRVModel& model) const {
+  reg_t old_val = rd_ != Register::X0 ? model.readCSR(getCSR()) : 0;
+  model.writeCSR(getCSR(), getUimm());
+  model.setReg(rd_, old_val);
+}
+
+void rvCSRRSI::execute(IRVModel& model) const {
+  reg_t old_val = model.readCSR(getCSR());
+  if (getUimm() != 0) model.writeCSR(getCSR(), old_val | getUimm());
+  model.setReg(rd_, old_val);
+}
+
+void rvCSRRCI::execute(IRVModel& model) const {
+  reg_t old_val = model.readCSR(getCSR());
+  if (getUimm() != 0) model.writeCSR(getCSR(), old_val & ~reg_t(getUimm()));
+  model.setReg(rd_, old_val);
 }
+#endif
 
 void GeneralUndefInsn::execute(IRVModel& model) const {
   // do nothing
 }
 
+#if RVSIM_EXT_F
+// result of F op goes to f register, its exceptions accrue in fflags
+void writeFPResult(IRVModel& model, Register rd, FPResult res) {
+  model.setFReg(rd, res.value);
+  model.raiseFPFlags(res.flags);
+}
+
+// comparisons and conversions to integer write x register,
+// 32-bit results are sign extended on RV64 (even of fcvt.wu.s)
+void writeIntResult(IRVModel& model, Register rd, FPResult res) {
+  model.setReg(rd, sign_extend_32_to_32(res.value));
+  model.raiseFPFlags(res.flags);
+}
+
+void rvFLW::execute(IRVModel& model) const {
+  addr_t mem_addr = model.getReg(rs1_) + sign_extend_12_to_32(imm_);
+  model.setFReg(rd_, model.readWord(mem_addr));
+}
+
+void rvFSW::execute(IRVModel& model) const {
+  addr_t mem_addr = model.getReg(rs1_) + sign_extend_12_to_32(imm_);
+  model.writeWord(mem_addr, model.getFReg(rs2_));
+}
+
+void rvFADD_S::execute(IRVModel& model) const {
+  std::optional<RoundingMode> rm = model.getRoundingMode(getRM());
+  if (!rm) return;
+
+  writeFPResult(model, dst_, fpAdd(model.getFReg(rs1_), model.getFReg(rs2_), *rm));
+}
+
+void rvFSUB_S::execute(IRVModel& model) const {
+  std::optional<RoundingMode> rm = model.getRoundingMode(getRM());
+  if (!rm) return;
+
+  writeFPResult(model, dst_, fpSub(model.getFReg(rs1_), model.getFReg(rs2_), *rm));
+}
+
+void rvFMUL_S::execute(IRVModel& model) const {
+  std::optional<RoundingMode> rm = model.getRoundingMode(getRM());
+  if (!rm) return;
+
+  writeFPResult(model, dst_, fpMul(model.getFReg(rs1_), model.getFReg(rs2_), *rm));
+}
+
+void rvFDIV_S::execute(IRVModel& model) const {
+  std::optional<RoundingMode> rm = model.getRoundingMode(getRM());
+  if (!rm) return;
+
+  writeFPResult(model, dst_, fpDiv(model.getFReg(rs1_), model.getFReg(rs2_), *rm));
+}
+
+void rvFSQRT_S::execute(IRVModel& model) const {
+  std::optional<RoundingMode> rm = model.getRoundingMode(getRM());
+  if (!rm) return;
+
+  writeFPResult(model, dst_, fpSqrt(model.getFReg(rs1_), *rm));
+}
+
+// sign injection only moves bits, NaNs are not canonicalized
+void rvFSGNJ_S::execute(IRVModel& model) const {
+  word_t op1 = model.getFReg(rs1_);
+  word_t op2 = model.getFReg(rs2_);
+  model.setFReg(dst_, (op1 & ~FP_SIGN_MASK) | (op2 & FP_SIGN_MASK));
+}
+
+void rvFSGNJN_S::execute(IRVModel& model) const {
+  word_t op1 = model.getFReg(rs1_);
+  word_t op2 = model.getFReg(rs2_);
+  model.setFReg(dst_, (op1 & ~FP_SIGN_MASK) | (~op2 & FP_SIGN_MASK));
+}
+
+void rvFSGNJX_S::execute(IRVModel& model) const {
+  word_t op1 = model.getFReg(rs1_);
+  word_t op2 = model.getFReg(rs2_);
+  model.setFReg(dst_, op1 ^ (op2 & FP_SIGN_MASK));
+}
+
+void rvFMIN_S::execute(IRVModel& model) const {
+  writeFPResult(model, dst_, fpMin(model.getFReg(rs1_), model.getFReg(rs2_)));
+}
+
+void rvFMAX_S::execute(IRVModel& model) const {
+  writeFPResult(model, dst_, fpMax(model.getFReg(rs1_), model.getFReg(rs2_)));
+}
+
+void rvFCVT_W_S::execute(IRVModel& model) const {
+  std::optional<RoundingMode> rm = model.getRoundingMode(getRM());
+  if (!rm) return;
+
+  writeIntResult(model, dst_, fpCvtWS(model.getFReg(rs1_), *rm));
+}
+
+void rvFCVT_WU_S::execute(IRVModel& model) const {
+  std::optional<RoundingMode> rm = model.getRoundingMode(getRM());
+  if (!rm) return;
+
+  writeIntResult(model, dst_, fpCvtWUS(model.getFReg(rs1_), *rm));
+}
+
+void rvFMV_X_W::execute(IRVModel& model) const {
+  model.setReg(dst_, sign_extend_32_to_32(model.getFReg(rs1_)));
+}
+
+void rvFCLASS_S::execute(IRVModel& model) const {
+  model.setReg(dst_, fpClass(model.getFReg(rs1_)));
+}
+
+void rvFEQ_S::execute(IRVModel& model) const {
+  writeIntResult(model, dst_, fpEq(model.getFReg(rs1_), model.getFReg(rs2_)));
+}
+
+void rvFLT_S::execute(IRVModel& model) const {
+  writeIntResult(model, dst_, fpLt(model.getFReg(rs1_), model.getFReg(rs2_)));
+}
+
+void rvFLE_S::execute(IRVModel& model) const {
+  writeIntResult(model, dst_, fpLe(model.getFReg(rs1_), model.getFReg(rs2_)));
+}
+
+void rvFCVT_S_W::execute(IRVModel& model) const {
+  std::optional<RoundingMode> rm = model.getRoundingMode(getRM());
+  if (!rm) return;
+
+  writeFPResult(model, dst_, fpCvtSW(model.getReg(rs1_), *rm));
+}
+
+void rvFCVT_S_WU::execute(IRVModel& model) const {
+  std::optional<RoundingMode> rm = model.getRoundingMode(getRM());
+  if (!rm) return;
+
+  writeFPResult(model, dst_, fpCvtSWU(model.getReg(rs1_), *rm));
+}
+
+void rvFMV_W_X::execute(IRVModel& model) const {
+  model.setFReg(dst_, model.getReg(rs1_));
+}
+
+// negated forms flip signs of the product and the addend, which is exact
+void rvFMADD_S::execute(IRVModel& model) const {
+  std::optional<RoundingMode> rm = model.getRoundingMode(getRM());
+  if (!rm) return;
+
+  writeFPResult(model, dst_, fpFma(model.getFReg(rs1_), model.getFReg(rs2_),
+                                   model.getFReg(rs3_), *rm));
+}
+
+void rvFMSUB_S::execute(IRVModel& model) const {
+  std::optional<RoundingMode> rm = model.getRoundingMode(getRM());
+  if (!rm) return;
+
+  writeFPResult(model, dst_, fpFma(model.getFReg(rs1_), model.getFReg(rs2_),
+                                   model.getFReg(rs3_) ^ FP_SIGN_MASK, *rm));
+}
+
+void rvFNMSUB_S::execute(IRVModel& model) const {
+  std::optional<RoundingMode> rm = model.getRoundingMode(getRM());
+  if (!rm) return;
+
+  writeFPResult(model, dst_, fpFma(model.getFReg(rs1_) ^ FP_SIGN_MASK, model.getFReg(rs2_),
+                                   model.getFReg(rs3_), *rm));
+}
+
+void rvFNMADD_S::execute(IRVModel& model) const {
+  std::optional<RoundingMode> rm = model.getRoundingMode(getRM());
+  if (!rm) return;
+
+  writeFPResult(model, dst_, fpFma(model.getFReg(rs1_) ^ FP_SIGN_MASK, model.getFReg(rs2_),
+                                   model.getFReg(rs3_) ^ FP_SIGN_MASK, *rm));
+}
+#endif
+
+
+#if RVSIM_EXT_V
+void VTypeInsn::illegal(IRVModel& model, const char* reason) const {
+  std::cerr << "ERROR: illegal " << getName() << ": " << reason
+            << " <pc = " << model.getPC() << ">\n";
+  model.illegalInsn();
+}
+
+bool VTypeInsn::checkGroups(IRVModel& model, std::initializer_list<Register> groups) const {
+  const VType& vtype = model.getVRegs().getVType();
+
+  if (vtype.vill) {
+    illegal(model, "vtype is not set or not supported");
+    return false;
+  }
+
+  if (isMasked()) {
+    illegal(model, "masked insns are not supported");
+    return false;
+  }
+
+  for (Register v : groups) {
+    if (static_cast<uint8_t>(v) % vtype.lmul != 0) {
+      illegal(model, "register group is not aligned to LMUL");
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// rs1 = x0 with rd != x0 asks for VLMAX, with rd = x0 keeps vl
+void VTypeInsn::setConfig(IRVModel& model, word_t vtype) const {
+  VectorRegisterFile& vregs = model.getVRegs();
+
+  word_t avl = vregs.getVL();
+  if (src1_ != Register::X0)
+    avl = std::min<reg_t>(model.getReg(src1_), std::numeric_limits<word_t>::max());
+  else if (dst_ != Register::X0) avl = std::numeric_limits<word_t>::max();
+
+  model.setReg(dst_, vregs.setConfig(avl, vtype));
+}
+
+// elements past vl are left undisturbed, which tail-agnostic policy allows too
+void VTypeInsn::executeBinary(IRVModel& model, VecOp op, Src src) const {
+  bool legal = src == Src::VV ? checkGroups(model, {dst_, src2_, src1_}) :
+                                checkGroups(model, {dst_, src2_});
+  if (!legal) return;
+
+  VectorRegisterFile& vregs = model.getVRegs();
+  unsigned sew = vregs.getVType().sew;
+  word_t vl = vregs.getVL();
+
+  std::array<byte_t, VLENB * MAX_LMUL> scalar;
+  const byte_t* operand = vregs.reg(src1_);
+  if (src != Src::VV) {
+    vecSplat(sew, scalar.data(), src == Src::VX ? model.getReg(src1_) : getSimm5(), vl);
+    operand = scalar.data();
+  }
+
+  vecBinary(op, sew, vregs.reg(dst_), vregs.reg(src2_), operand, vl);
+}
+
+void VTypeInsn::executeMove(IRVModel& model, Src src) const {
+  bool legal = src == Src::VV ? checkGroups(model, {dst_, src1_}) :
+                                checkGroups(model, {dst_});
+  if (!legal) return;
+
+  VectorRegisterFile& vregs = model.getVRegs();
+  unsigned sew = vregs.getVType().sew;
+  word_t vl = vregs.getVL();
+
+  if (src == Src::VV) {
+    std::memmove(vregs.reg(dst_), vregs.reg(src1_), vl * sew / BITS_BYTE);
+    return;
+  }
+
+  vecSplat(sew, vregs.reg(dst_), src == Src::VX ? model.getReg(src1_) : getSimm5(), vl);
+}
+
+// vd[0] = op(vs1[0], vs2[*]), vd and vs1 are single registers whatever LMUL is
+void VTypeInsn::executeReduce(IRVModel& model, VecRed op) const {
+  if (!checkGroups(model, {src2_})) return;
+
+  VectorRegisterFile& vregs = model.getVRegs();
+  unsigned sew = vregs.getVType().sew;
+  word_t vl = vregs.getVL();
+  if (vl == 0) return; // vd is not written then
+
+  word_t init = 0;
+  std::memcpy(&init, vregs.reg(src1_), sew / BITS_BYTE);
+
+  word_t res = vecReduce(op, sew, vregs.reg(src2_), init, vl);
+  std::memcpy(vregs.reg(dst_), &res, sew / BITS_BYTE);
+}
+
+// eew comes from insn, EMUL = EEW / SEW * LMUL
+void VTypeInsn::executeLoad(IRVModel& model, unsigned eew) const {
+  if (!checkGroups(model, {})) return;
+
+  VectorRegisterFile& vregs = model.getVRegs();
+  const VType& vtype = vregs.getVType();
+  unsigned emul = std::max(1u, eew * vtype.lmul / vtype.sew);
+  addr_t size = vregs.getVL() * eew / BITS_BYTE;
+
+  if (eew * vtype.lmul / vtype.sew > MAX_LMUL || static_cast<uint8_t>(dst_) % emul != 0 ||
+      !vregs.fits(dst_, size)) {
+    illegal(model, "wrong EMUL or register group");
+    return;
+  }
+
+  // elements are read one by one as by scalar loads, so are checked, seen by
+  // observers and may come from devices, a faulting one stops the insn
+  addr_t addr = model.getReg(src1_);
+  unsigned elem_size = eew / BITS_BYTE;
+  for (addr_t offset = 0; offset != size; offset += elem_size) {
+    word_t elem = 0;
+    switch (eew)
+    {
+    case 8:  elem = model.readByte(addr + offset); break;
+    case 16: elem = model.readHalf(addr + offset); break;
+    default: elem = model.readWord(addr + offset); break;
+    }
+
+    if (!model.isExecuting()) return;
+    std::memcpy(vregs.reg(dst_) + offset, &elem, elem_size);
+  }
+}
+
+void VTypeInsn::executeStore(IRVModel& model, unsigned eew) const {
+  if (!checkGroups(model, {})) return;
+
+  VectorRegisterFile& vregs = model.getVRegs();
+  const VType& vtype = vregs.getVType();
+  unsigned emul = std::max(1u, eew * vtype.lmul / vtype.sew);
+  addr_t size = vregs.getVL() * eew / BITS_BYTE;
+
+  if (eew * vtype.lmul / vtype.sew > MAX_LMUL || static_cast<uint8_t>(dst_) % emul != 0 ||
+      !vregs.fits(dst_, size)) {
+    illegal(model, "wrong EMUL or register group");
+    return;
+  }
+
+  addr_t addr = model.getReg(src1_);
+  unsigned elem_size = eew / BITS_BYTE;
+  for (addr_t offset = 0; offset != size; offset += elem_size) {
+    word_t elem = 0;
+    std::memcpy(&elem, vregs.reg(dst_) + offset, elem_size);
+
+    switch (eew)
+    {
+    case 8:  model.writeByte(addr + offset, elem); break;
+    case 16: model.writeHalf(addr + offset, elem); break;
+    default: model.writeWord(addr + offset, elem); break;
+    }
+
+    if (!model.isExecuting()) return;
+  }
+}
+
+void rvVSETVLI::execute(IRVModel& model) const {
+  setConfig(model, getZimm());
+}
+
+void rvVSETIVLI::execute(IRVModel& model) const {
+  model.setReg(dst_, model.getVRegs().setConfig(getUimm5(), getZimm()));
+}
+
+void rvVSETVL::execute(IRVModel& model) const {
+  setConfig(model, model.getReg(src2_));
+}
+
+void rvVLE8_V::execute(IRVModel& model) const { executeLoad(model, 8); }
+void rvVLE16_V::execute(IRVModel& model) const { executeLoad(model, 16); }
+void rvVLE32_V::execute(IRVModel& model) const { executeLoad(model, 32); }
+
+void rvVSE8_V::execute(IRVModel& model) const { executeStore(model, 8); }
+void rvVSE16_V::execute(IRVModel& model) const { executeStore(model, 16); }
+void rvVSE32_V::execute(IRVModel& model) const { executeStore(model, 32); }
+
+void rvVADD_VV::execute(IRVModel& model) const { executeBinary(model, VecOp::ADD, Src::VV); }
+void rvVADD_VX::execute(IRVModel& model) const { executeBinary(model, VecOp::ADD, Src::VX); }
+void rvVADD_VI::execute(IRVModel& model) const { executeBinary(model, VecOp::ADD, Src::VI); }
+void rvVSUB_VV::execute(IRVModel& model) const { executeBinary(model, VecOp::SUB, Src::VV); }
+void rvVSUB_VX::execute(IRVModel& model) const { executeBinary(model, VecOp::SUB, Src::VX); }
+void rvVAND_VV::execute(IRVModel& model) const { executeBinary(model, VecOp::AND, Src::VV); }
+void rvVAND_VX::execute(IRVModel& model) const { executeBinary(model, VecOp::AND, Src::VX); }
+void rvVAND_VI::execute(IRVModel& model) const { executeBinary(model, VecOp::AND, Src::VI); }
+void rvVOR_VV::execute(IRVModel& model) const { executeBinary(model, VecOp::OR, Src::VV); }
+void rvVOR_VX::execute(IRVModel& model) const { executeBinary(model, VecOp::OR, Src::VX); }
+void rvVOR_VI::execute(IRVModel& model) const { executeBinary(model, VecOp::OR, Src::VI); }
+void rvVXOR_VV::execute(IRVModel& model) const { executeBinary(model, VecOp::XOR, Src::VV); }
+void rvVXOR_VX::execute(IRVModel& model) const { executeBinary(model, VecOp::XOR, Src::VX); }
+void rvVXOR_VI::execute(IRVModel& model) const { executeBinary(model, VecOp::XOR, Src::VI); }
+void rvVMUL_VV::execute(IRVModel& model) const { executeBinary(model, VecOp::MUL, Src::VV); }
+void rvVMUL_VX::execute(IRVModel& model) const { executeBinary(model, VecOp::MUL, Src::VX); }
+
+void rvVMV_V_V::execute(IRVModel& model) const { executeMove(model, Src::VV); }
+void rvVMV_V_X::execute(IRVModel& model) const { executeMove(model, Src::VX); }
+void rvVMV_V_I::execute(IRVModel& model) const { executeMove(model, Src::VI); }
+
+// element 0 sign-extended, regardless of vl
+void rvVMV_X_S::execute(IRVModel& model) const {
+  const VType& vtype = model.getVRegs().getVType();
+  if (vtype.vill) {
+    illegal(model, "vtype is not set or not supported");
+    return;
+  }
+
+  word_t val = 0;
+  std::memcpy(&val, model.getVRegs().reg(src2_), vtype.sew / BITS_BYTE);
+
+  unsigned shift = sizeof(word_t) * BITS_BYTE - vtype.sew;
+  model.setReg(dst_, std::bit_cast<sword_t>(val << shift) >> shift);
+}
+
+void rvVREDSUM_VS::execute(IRVModel& model) const { executeReduce(model, VecRed::SUM); }
+void rvVREDAND_VS::execute(IRVModel& model) const { executeReduce(model, VecRed::AND); }
+void rvVREDOR_VS::execute(IRVModel& model) const { executeReduce(model, VecRed::OR); }
+void rvVREDXOR_VS::execute(IRVModel& model) const { executeReduce(model, VecRed::XOR); }
+void rvVREDMINU_VS::execute(IRVModel& model) const { executeReduce(model, VecRed::MINU); }
+void rvVREDMIN_VS::execute(IRVModel& model) const { executeReduce(model, VecRed::MIN); }
+void rvVREDMAXU_VS::execute(IRVModel& model) const { executeReduce(model, VecRed::MAXU); }
+void rvVREDMAX_VS::execute(IRVModel& model) const { executeReduce(model, VecRed::MAX); }
+#endif
+
 } // namespace rv32i_sim
 
 #endif // SIMULATOR_HPP
@@ -0,0 +1,69 @@
+#ifndef SIMPOINT_HPP
+#define SIMPOINT_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "basic_block.hpp"
+#include "encoding.hpp"
+#include "exec_observer.hpp"
+
+namespace rv32i_sim {
+
+constexpr uint64_t DEFAULT_INTERVAL = 10'000'000; // insns in interval
+
+/// @brief basic block vectors for SimPoint
+///
+/// blocks are numbered from 1 in order of first execution,
+/// every interval is one line of .bb file:
+/// "T:<id>:<insns executed in block> :<id>:<insns> ..."
+/// Interval boundaries are set by the caller (see RVModel::run),
+/// so intervals are exact.
+class BBVProfiler final : public IExecObserver {
+  std::unordered_map<addr_t, uint64_t> ids_; ///< block start pc -> id
+  std::unordered_map<uint64_t, uint64_t> counts_; ///< id -> insns in current interval
+  uint64_t n_intervals_ = 0;
+
+public:
+  void onBlock(const BasicBlock& block, addr_t next_pc, uint64_t instret) override;
+
+  /// @brief write current interval as a line of .bb file and start the next one
+  std::ostream& endInterval(std::ostream& out);
+
+  bool intervalEmpty() const { return counts_.empty(); }
+  uint64_t nIntervals() const { return n_intervals_; }
+  std::size_t nBlocks() const { return ids_.size(); }
+};
+
+/// @brief model state at the start of an interval
+struct Checkpoint {
+  uint64_t interval = 0; ///< index of interval starting at checkpoint
+  uint64_t instret = 0;
+  uint64_t cycle = 0;
+  std::filesystem::path path; ///< bstate file, relative to manifest directory, .ctx is next to it
+};
+
+/// @brief list of checkpoints taken in a single run
+///
+/// stored as text file next to bstate files:
+///   interval <insns in interval>
+///   checkpoint <interval> <instret> <cycle> <bstate file>
+struct CheckpointManifest {
+  static constexpr const char* FILE_NAME = "checkpoints.txt";
+
+  uint64_t interval_len = DEFAULT_INTERVAL;
+  std::vector<Checkpoint> checkpoints; ///< ordered by interval
+
+  static std::filesystem::path bstateName(uint64_t interval);
+
+  bool save(const std::filesystem::path& dir) const;
+  static std::optional<CheckpointManifest> load(const std::filesystem::path& dir);
+};
+
+} // rv32i_sim
+
+#endif // SIMPOINT_HPP
@@ -0,0 +1,51 @@
+#ifndef SYMBOLS_HPP
+#define SYMBOLS_HPP
+
+#include <string>
+#include <vector>
+
+#include <elfio/elfio.hpp>
+
+#include "encoding.hpp"
+
+namespace rv32i_sim {
+
+namespace elf = ELFIO;
+
+const std::string UNKNOWN_SYMBOL = "??";
+
+struct Symbol {
+  addr_t addr = 0; ///< start address
+  addr_t size = 0; ///< 0 if unknown (e.g. labels in assembly)
+  std::string name = UNKNOWN_SYMBOL;
+};
+
+/// @brief code symbols of a guest program, used to map pc to a function
+class SymbolTable final {
+  std::vector<Symbol> symbols_; ///< sorted by address
+
+public:
+  SymbolTable() {}
+  SymbolTable(std::vector<Symbol> symbols);
+
+  // collects functions and global labels pointing to executable sections
+  static SymbolTable fromELF(elf::elfio& elf_reader);
+
+  /// @brief find symbol which pc belongs to
+  /// @return nullptr if there is no such symbol
+  const Symbol* lookup(addr_t pc) const;
+
+  /// @brief find symbol by its name
+  /// @return nullptr if there is no such symbol
+  const Symbol* find(const std::string& name) const;
+
+  // name of the symbol pc belongs to or UNKNOWN_SYMBOL
+  const std::string& nameOf(addr_t pc) const;
+
+  bool empty() const;
+  std::size_t size() const;
+};
+
+} // rv32i_sim
+
+#endif // SYMBOLS_HPP
@@ -0,0 +1,102 @@
+#ifndef VECTOR_HPP
+#define VECTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "encoding.hpp"
+#include "registers.hpp"
+
+namespace rv32i_sim {
+
+constexpr unsigned VLEN = 256; // bits in vector register, the width of AVX2 register
+constexpr unsigned VLENB = VLEN / BITS_BYTE;
+constexpr unsigned ELEN = 32; // widest element
+constexpr unsigned MAX_LMUL = 8;
+
+constexpr word_t VTYPE_VILL = 0x80000000;
+
+/// @brief decoded vtype CSR
+///
+/// supported are SEW 8/16/32 and integer LMUL 1-8,
+/// anything else (fractional LMUL, reserved bits) sets vill
+struct VType {
+  word_t bits = VTYPE_VILL; ///< value of vtype CSR
+  unsigned sew = 0; ///< bits in element
+  unsigned lmul = 0; ///< registers in group
+  bool vill = true;
+
+  static VType fromBits(word_t bits);
+
+  /// @brief elements in register group
+  word_t vlmax() const { return vill ? 0 : VLEN * lmul / sew; }
+};
+
+/// @brief vector registers, vl and vtype of V extension
+///
+/// registers are kept as one byte array, so a register group is a
+/// contiguous range and element i of SEW lies at byte i * SEW / 8
+/// the same way as in guest memory (both are little-endian)
+class VectorRegisterFile final {
+  std::vector<byte_t> data_ = std::vector<byte_t>(N_REGS * VLENB);
+  word_t vl_ = 0;
+  VType vtype_;
+
+public:
+  bool operator==(const VectorRegisterFile& other) const;
+
+  byte_t* reg(Register v) { return data_.data() + static_cast<uint8_t>(v) * VLENB; }
+  const byte_t* reg(Register v) const {
+    return data_.data() + static_cast<uint8_t>(v) * VLENB;
+  }
+
+  /// @brief true if size bytes starting at v do not run past v31
+  bool fits(Register v, std::size_t size) const {
+    return static_cast<uint8_t>(v) * VLENB + size <= data_.size();
+  }
+
+  word_t getVL() const { return vl_; }
+  const VType& getVType() const { return vtype_; }
+
+  /// @brief vsetvl{i} semantics: vl = min(avl, VLMAX), 0 if vtype is illegal
+  /// @return new vl
+  word_t setConfig(word_t avl, word_t vtype_bits);
+};
+
+enum class VecOp : uint8_t {
+  ADD = 0,
+  SUB = 1, //< a - b
+  AND = 2,
+  OR = 3,
+  XOR = 4,
+  MUL = 5, //< low half of product
+};
+
+enum class VecRed : uint8_t {
+  SUM = 0,
+  AND = 1,
+  OR = 2,
+  XOR = 3,
+  MINU = 4,
+  MIN = 5,
+  MAXU = 6,
+  MAX = 7,
+};
+
+// element loops use AVX2 or SSE2 when host has them, the rest is scalar
+
+/// @brief dst[i] = a[i] op b[i] for n elements of sew bits
+void vecBinary(VecOp op, unsigned sew, byte_t* dst, const byte_t* a, const byte_t* b,
+               std::size_t n);
+
+/// @brief fold n elements of src with op, starting from init
+/// @return result truncated to sew bits
+word_t vecReduce(VecRed op, unsigned sew, const byte_t* src, word_t init, std::size_t n);
+
+/// @brief dst[i] = val for n elements of sew bits
+void vecSplat(unsigned sew, byte_t* dst, word_t val, std::size_t n);
+
+} // rv32i_sim
+
+#endif // VECTOR_HPP
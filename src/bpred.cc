@@ -0,0 +1,204 @@
+#include "bpred.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rv32i_sim {
+
+static double percentOf(uint64_t part, uint64_t total) {
+  return total ? 100.0 * part / total : 0.0;
+}
+
+std::optional<BPredKind> BPredConfig::parseKind(const std::string& str) {
+  if (str == "static") return BPredKind::STATIC;
+  if (str == "bimodal") return BPredKind::BIMODAL;
+  if (str == "gshare") return BPredKind::GSHARE;
+
+  return std::nullopt;
+}
+
+BranchPredictor::BranchPredictor(const BPredConfig& config) : config_(config) {
+  assert(config_.table_bits < 32 && config_.btb_bits < 32 && "Predictor tables too large");
+  assert(config_.ras_depth != 0 && "Return address stack must not be empty");
+
+  table_mask_ = (addr_t(1) << config_.table_bits) - 1;
+  btb_mask_ = (addr_t(1) << config_.btb_bits) - 1;
+
+  counters_.assign(std::size_t(1) << config_.table_bits, 1); // weakly not taken
+  btb_.resize(std::size_t(1) << config_.btb_bits);
+  ras_.resize(config_.ras_depth);
+}
+
+std::size_t BranchPredictor::counterIdx(addr_t pc) const {
+  addr_t idx = pc / IALIGN;
+  if (config_.kind == BPredKind::GSHARE) idx ^= history_;
+
+  return idx & table_mask_;
+}
+
+bool BranchPredictor::predictDirection(addr_t pc, addr_t code) const {
+  if (config_.kind == BPredKind::STATIC) return code >> 31; // sign of offset
+
+  return counters_[counterIdx(pc)] >= 2;
+}
+
+void BranchPredictor::updateDirection(addr_t pc, bool taken) {
+  if (config_.kind == BPredKind::STATIC) return;
+
+  uint8_t& counter = counters_[counterIdx(pc)];
+  if (taken && counter != 3) ++counter;
+  if (!taken && counter != 0) --counter;
+
+  history_ = ((history_ << 1) | taken) & table_mask_;
+}
+
+bool BranchPredictor::lookupBTB(addr_t pc, addr_t target) {
+  BTBEntry& entry = btb_[(pc / IALIGN) & btb_mask_];
+  bool hit = entry.valid && entry.pc == pc && entry.target == target;
+
+  ++btb_lookups_;
+  if (!hit) ++btb_misses_;
+
+  entry = BTBEntry {pc, target, true};
+  return hit;
+}
+
+void BranchPredictor::pushRAS(addr_t ret_addr) {
+  ras_top_ = (ras_top_ + 1) % ras_.size();
+  ras_[ras_top_] = ret_addr;
+  ras_size_ = std::min(ras_size_ + 1, ras_.size());
+}
+
+std::optional<addr_t> BranchPredictor::popRAS() {
+  if (ras_size_ == 0) return std::nullopt;
+
+  addr_t ret_addr = ras_[ras_top_];
+  ras_top_ = (ras_top_ + ras_.size() - 1) % ras_.size();
+  --ras_size_;
+
+  return ret_addr;
+}
+
+void BranchPredictor::onBlock(const BasicBlock& block, addr_t next_pc,
+                                                       uint64_t /* instret */) {
+  // the last insn of trapped block has not retired, it may even be empty
+  if (block.exit == BlockExit::TRAP) return;
+
+  addr_t pc = block.insnPC(block.size() - 1);
+  addr_t fallthrough = block.end_pc;
+
+  switch (block.exit)
+  {
+  case BlockExit::BRANCH: {
+    bool taken = next_pc != fallthrough;
+    bool mispredicted = predictDirection(pc, block.insns.back()->getCode()) != taken;
+
+    BranchStats& stats = branches_[pc];
+    ++stats.executed;
+    stats.taken += taken;
+    stats.mispredicted += mispredicted;
+
+    updateDirection(pc, taken);
+    if (taken) lookupBTB(pc, next_pc);
+    break;
+  }
+
+  case BlockExit::CALL:
+    pushRAS(fallthrough);
+    lookupBTB(pc, next_pc);
+    break;
+
+  case BlockExit::JUMP:
+    lookupBTB(pc, next_pc);
+    break;
+
+  case BlockExit::RETURN: {
+    auto predicted = popRAS();
+
+    ++returns_;
+    if (!predicted || *predicted != next_pc) ++ras_misses_;
+    break;
+  }
+
+  default:
+    break;
+  }
+}
+
+void BranchPredictor::merge(const BranchPredictor& other) {
+  for (auto&& [pc, stats] : other.branches_) {
+    BranchStats& merged = branches_[pc];
+    merged.executed += stats.executed;
+    merged.taken += stats.taken;
+    merged.mispredicted += stats.mispredicted;
+  }
+
+  btb_lookups_ += other.btb_lookups_;
+  btb_misses_ += other.btb_misses_;
+  returns_ += other.returns_;
+  ras_misses_ += other.ras_misses_;
+}
+
+const std::unordered_map<addr_t, BranchPredictor::BranchStats>&
+                                        BranchPredictor::getBranches() const {
+  return branches_;
+}
+
+uint64_t BranchPredictor::nBranches() const {
+  uint64_t n = 0;
+  for (auto&& [pc, stats] : branches_) n += stats.executed;
+
+  return n;
+}
+
+uint64_t BranchPredictor::nMispredicted() const {
+  uint64_t n = 0;
+  for (auto&& [pc, stats] : branches_) n += stats.mispredicted;
+
+  return n;
+}
+
+std::ostream& BranchPredictor::report(std::ostream& out, const SymbolTable& symbols,
+                                                             unsigned top_n) const {
+  static const char* kind_names[] = {"static", "bimodal", "gshare"};
+
+  uint64_t n_branches = nBranches();
+  uint64_t n_mispredicted = nMispredicted();
+
+  out << std::fixed << std::setprecision(2);
+
+  out << "Branch predictor (" << kind_names[static_cast<int>(config_.kind)] << "): "
+      << n_branches << " branches, " << n_mispredicted << " mispredicted, "
+      << 100.0 - percentOf(n_mispredicted, n_branches) << "% accuracy\n";
+
+  out << "BTB: " << btb_lookups_ << " lookups, " << btb_misses_ << " misses\n";
+  out << "RAS: " << returns_ << " returns, " << ras_misses_ << " mispredicted\n";
+
+  std::vector<std::pair<addr_t, BranchStats>> sorted(branches_.begin(), branches_.end());
+  std::sort(sorted.begin(), sorted.end(),
+            [](auto&& lhs, auto&& rhs) { return lhs.second.mispredicted > rhs.second.mispredicted; });
+
+  if (sorted.size() > top_n) sorted.resize(top_n);
+
+  out << "        pc    executed   taken %  mispredicted  accuracy %  function\n";
+  for (auto&& [pc, stats] : sorted) {
+    out << "0x" << std::hex << std::setw(8) << std::setfill('0') << pc
+        << std::setfill(' ') << std::dec
+        << std::setw(12) << stats.executed
+        << std::setw(10) << percentOf(stats.taken, stats.executed)
+        << std::setw(14) << stats.mispredicted
+        << std::setw(12) << 100.0 - percentOf(stats.mispredicted, stats.executed)
+        << "  " << symbols.nameOf(pc) << '\n';
+  }
+
+  out.unsetf(std::ios::floatfield);
+  return out;
+}
+
+} // rv32i_sim
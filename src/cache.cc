@@ -0,0 +1,174 @@
+#include "cache.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <charconv>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace rv32i_sim {
+
+bool CacheConfig::isValid() const {
+  if (!std::has_single_bit(size) || !std::has_single_bit(ways) ||
+      !std::has_single_bit(line_size))
+    return false;
+
+  // line must hold at least one word, sizeof(word_t) is the widest access
+  if (line_size < sizeof(word_t)) return false;
+
+  return static_cast<uint64_t>(ways) * line_size <= size;
+}
+
+std::optional<CacheConfig> CacheConfig::parse(const std::string& str) {
+  std::vector<std::string> fields;
+  std::istringstream in(str);
+  for (std::string field; std::getline(in, field, ':'); ) fields.push_back(field);
+
+  if (fields.size() != 3 && fields.size() != 4) return std::nullopt;
+
+  auto parseNum = [](const std::string& field) -> std::optional<uint32_t> {
+    if (field.empty()) return std::nullopt;
+
+    uint32_t scale = 1;
+    std::string digits = field;
+    switch (digits.back()) {
+      case 'k': case 'K': scale = 1024; digits.pop_back(); break;
+      case 'm': case 'M': scale = 1024 * 1024; digits.pop_back(); break;
+    }
+
+    // digits only, overlong ones are out of range
+    uint64_t num = 0;
+    const char* end = digits.data() + digits.size();
+    auto [ptr, ec] = std::from_chars(digits.data(), end, num);
+    if (digits.empty() || ec != std::errc{} || ptr != end) return std::nullopt;
+    if (num > UINT32_MAX / scale) return std::nullopt;
+
+    return static_cast<uint32_t>(num * scale);
+  };
+
+  auto size = parseNum(fields[0]);
+  auto ways = parseNum(fields[1]);
+  auto line_size = parseNum(fields[2]);
+  if (!size || !ways || !line_size) return std::nullopt;
+
+  CacheConfig config;
+  config.size = *size;
+  config.ways = *ways;
+  config.line_size = *line_size;
+
+  if (fields.size() == 4) {
+    if (fields[3] == "lru") config.policy = ReplacePolicy::LRU;
+    else if (fields[3] == "random") config.policy = ReplacePolicy::RANDOM;
+    else return std::nullopt;
+  }
+
+  if (!config.isValid()) return std::nullopt;
+
+  return config;
+}
+
+std::ostream& operator<<(std::ostream& out, const CacheConfig& config) {
+  return out << config.size / 1024 << "K, " << config.ways << "-way, "
+             << config.line_size << "B lines, "
+             << (config.policy == ReplacePolicy::LRU ? "LRU" : "random");
+}
+
+CacheModel::CacheModel(const CacheConfig& config) : config_(config) {
+  assert(config_.isValid() && "Invalid cache geometry");
+
+  line_shift_ = std::countr_zero(config_.line_size);
+  set_mask_ = config_.nSets() - 1;
+  lines_.resize(static_cast<std::size_t>(config_.nSets()) * config_.ways);
+}
+
+bool CacheModel::access(addr_t addr) {
+  addr_t line = lineOf(addr);
+  Line* set = &lines_[(line & set_mask_) * config_.ways];
+  Line* set_end = set + config_.ways;
+
+  ++tick_;
+
+  for (Line* way = set; way != set_end; ++way) {
+    if (way->valid && way->tag == line) {
+      way->last_use = tick_;
+      ++hits_;
+      return true;
+    }
+  }
+
+  ++misses_;
+
+  // fill invalid way first, then evict by policy
+  Line* victim = std::find_if(set, set_end, [](const Line& way) { return !way.valid; });
+  if (victim == set_end) {
+    if (config_.policy == ReplacePolicy::LRU)
+      victim = std::min_element(set, set_end,
+               [](const Line& lhs, const Line& rhs) { return lhs.last_use < rhs.last_use; });
+    else
+      victim = set + rand_() % config_.ways;
+  }
+
+  *victim = Line {line, tick_, true};
+  return false;
+}
+
+void CacheModel::mergeStats(const CacheModel& other) {
+  hits_ += other.hits_;
+  misses_ += other.misses_;
+}
+
+double CacheModel::mpki(uint64_t instret) const {
+  return instret ? 1000.0 * misses_ / instret : 0.0;
+}
+
+std::ostream& CacheModel::report(std::ostream& out, const std::string& name,
+                                                          uint64_t instret) const {
+  double hit_rate = nAccesses() ? 100.0 * hits_ / nAccesses() : 0.0;
+
+  out << name << " (" << config_ << "): "
+      << nAccesses() << " accesses, "
+      << hits_ << " hits, "
+      << misses_ << " misses, "
+      << std::fixed << std::setprecision(2)
+      << hit_rate << "% hit rate, "
+      << mpki(instret) << " MPKI\n";
+
+  out.unsetf(std::ios::floatfield);
+  return out;
+}
+
+void ICacheObserver::onBlock(const BasicBlock& block, addr_t /* next_pc */,
+                                                        uint64_t /* instret */) {
+  addr_t pc = block.start_pc;
+  std::size_t idx = 0;
+
+  // an insn is counted in the line of its first byte
+  while (idx != block.retired()) {
+    cache_.access(pc);
+
+    // insns up to the end of the line
+    addr_t line = cache_.lineOf(pc);
+    uint64_t in_line = 0;
+    for ( ; idx != block.retired() && cache_.lineOf(pc) == line; ++idx) {
+      pc += block.insns[idx]->getSize();
+      ++in_line;
+    }
+
+    cache_.addHits(in_line - 1);
+  }
+}
+
+void DCacheObserver::onAccess(addr_t addr, unsigned size, MemAccess /* type */) {
+  cache_.access(addr);
+
+  // misaligned access may touch the next line too
+  addr_t last = addr + size - 1;
+  if (cache_.lineOf(last) != cache_.lineOf(addr)) cache_.access(last);
+}
+
+} // rv32i_sim
@@ -0,0 +1,162 @@
+#include "callstack.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rv32i_sim {
+
+addr_t CallStackProfiler::funcOf(addr_t pc) const {
+  const Symbol* sym = symbols_.lookup(pc);
+  return sym ? sym->addr : pc;
+}
+
+void CallStackProfiler::push(addr_t func, uint64_t instret, CallEdge* edge) {
+  FuncStats* stats = &funcs_[func];
+  ++stats->calls;
+  ++stats->active;
+
+  stack_.push_back(Frame {func, instret, stats, edge});
+  max_depth_ = std::max(max_depth_, stack_.size());
+}
+
+void CallStackProfiler::pop(uint64_t instret) {
+  Frame& frame = stack_.back();
+  uint64_t spent = instret - frame.enter_instret;
+
+  // recursive calls are already included into the outermost one
+  if (--frame.stats->active == 0) frame.stats->inclusive += spent;
+  if (frame.edge) frame.edge->inclusive += spent;
+
+  stack_.pop_back();
+}
+
+void CallStackProfiler::onBlock(const BasicBlock& block, addr_t next_pc, uint64_t instret) {
+  instret_ = instret;
+
+  // first block or everything has returned
+  if (stack_.empty()) push(funcOf(block.start_pc), instret - block.retired(), nullptr);
+
+  stack_.back().stats->exclusive += block.retired();
+
+  if (block.exit == BlockExit::CALL) {
+    addr_t callee = funcOf(next_pc);
+    addr_t call_site = block.insnPC(block.size() - 1);
+
+    CallEdge* edge = &edges_[EdgeKey {stack_.back().func, callee, call_site}];
+    ++edge->calls;
+
+    push(callee, instret, edge);
+  } else if (block.exit == BlockExit::RETURN) {
+    pop(instret);
+  }
+}
+
+std::size_t CallStackProfiler::maxDepth() const {
+  return max_depth_;
+}
+
+std::size_t CallStackProfiler::depth() const {
+  return stack_.size();
+}
+
+const std::unordered_map<addr_t, CallStackProfiler::FuncStats>&
+                                            CallStackProfiler::getFuncs() const {
+  return funcs_;
+}
+
+std::unordered_map<addr_t, CallStackProfiler::FuncStats>
+                                            CallStackProfiler::closedFuncs() const {
+  std::unordered_map<addr_t, FuncStats> funcs = funcs_;
+
+  // walk from the outermost frame, so recursion is handled as in pop
+  std::unordered_map<addr_t, unsigned> seen;
+  for (auto&& frame : stack_) {
+    if (seen[frame.func]++ == 0)
+      funcs[frame.func].inclusive += instret_ - frame.enter_instret;
+  }
+
+  return funcs;
+}
+
+std::map<CallStackProfiler::EdgeKey, CallStackProfiler::CallEdge>
+                                            CallStackProfiler::closedEdges() const {
+  std::map<EdgeKey, CallEdge> edges = edges_;
+
+  for (auto&& [key, edge] : edges_) {
+    for (auto&& frame : stack_) {
+      if (frame.edge == &edge) edges[key].inclusive += instret_ - frame.enter_instret;
+    }
+  }
+
+  return edges;
+}
+
+std::string CallStackProfiler::nameOf(addr_t func) const {
+  const Symbol* sym = symbols_.lookup(func);
+  if (sym) return sym->name;
+
+  std::ostringstream name;
+  name << "0x" << std::hex << func;
+  return name.str();
+}
+
+std::ostream& CallStackProfiler::report(std::ostream& out) const {
+  auto funcs = closedFuncs();
+
+  std::vector<std::pair<addr_t, FuncStats>> sorted(funcs.begin(), funcs.end());
+  std::sort(sorted.begin(), sorted.end(),
+            [](auto&& lhs, auto&& rhs) { return lhs.second.exclusive > rhs.second.exclusive; });
+
+  out << "Call stack profile: " << instret_ << " insns, max stack depth "
+      << max_depth_ << '\n';
+  out << "     calls    inclusive    exclusive  function\n";
+
+  for (auto&& [func, stats] : sorted) {
+    out << std::setw(10) << stats.calls
+        << std::setw(13) << stats.inclusive
+        << std::setw(13) << stats.exclusive
+        << "  " << nameOf(func) << '\n';
+  }
+
+  return out;
+}
+
+std::ostream& CallStackProfiler::dumpCallgrind(std::ostream& out) const {
+  auto funcs = closedFuncs();
+  auto edges = closedEdges();
+
+  out << "# callgrind format\n"
+      << "version: 1\n"
+      << "creator: rvsim\n"
+      << "positions: instr\n"
+      << "events: Ir\n"
+      << "summary: " << instret_ << "\n\n";
+
+  out << std::hex << std::showbase;
+
+  for (auto&& [func, stats] : funcs) {
+    out << "fn=" << nameOf(func) << '\n'
+        << func << ' ' << std::dec << stats.exclusive << std::hex << '\n';
+
+    // edges are sorted by caller, so the ones of func are contiguous
+    auto edge = edges.lower_bound(EdgeKey {func, 0, 0});
+    for ( ; edge != edges.end() && std::get<0>(edge->first) == func; ++edge) {
+      auto [caller, callee, call_site] = edge->first;
+      out << "cfn=" << nameOf(callee) << '\n'
+          << "calls=" << std::dec << edge->second.calls << std::hex << ' ' << callee << '\n'
+          << call_site << ' ' << std::dec << edge->second.inclusive << std::hex << '\n';
+    }
+
+    out << '\n';
+  }
+
+  out << std::dec << std::noshowbase;
+  return out;
+}
+
+} // rv32i_sim
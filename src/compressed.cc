@@ -0,0 +1,288 @@
+#include "compressed.hpp"
+
+namespace rv32i_sim {
+
+namespace {
+
+// bits [hi:lo] of code shifted down to bit 0
+word_t bits(half_t code, unsigned hi, unsigned lo) {
+  return (code >> lo) & ((1u << (hi - lo + 1)) - 1);
+}
+
+word_t bit(half_t code, unsigned pos) {
+  return (code >> pos) & 1u;
+}
+
+word_t signExtend(word_t value, unsigned n_bits) {
+  word_t sign = 1u << (n_bits - 1);
+  return (value ^ sign) - sign;
+}
+
+word_t base(RV32i_ISA insn) { return static_cast<word_t>(insn); }
+
+// registers x8-x15 of 3-bit fields (rd', rs1', rs2')
+word_t creg(word_t field) { return field + 8; }
+
+constexpr word_t SP = 2;
+constexpr word_t RA = 1;
+
+word_t encR(RV32i_ISA insn, word_t rd, word_t rs1, word_t rs2) {
+  return base(insn) | rs2 << 20 | rs1 << 15 | rd << 7;
+}
+
+word_t encI(RV32i_ISA insn, word_t rd, word_t rs1, word_t imm) {
+  return base(insn) | (imm & 0xFFF) << 20 | rs1 << 15 | rd << 7;
+}
+
+word_t encS(RV32i_ISA insn, word_t rs1, word_t rs2, word_t imm) {
+  return base(insn) | ((imm >> 5) & 0x7F) << 25 | rs2 << 20 | rs1 << 15 |
+                      (imm & 0x1F) << 7;
+}
+
+word_t encB(RV32i_ISA insn, word_t rs1, word_t rs2, word_t imm) {
+  return base(insn) | ((imm >> 12) & 1) << 31 | ((imm >> 5) & 0x3F) << 25 |
+                      rs2 << 20 | rs1 << 15 |
+                      ((imm >> 1) & 0xF) << 8 | ((imm >> 11) & 1) << 7;
+}
+
+word_t encU(RV32i_ISA insn, word_t rd, word_t imm) {
+  return base(insn) | (imm & MASK_31_12) | rd << 7;
+}
+
+word_t encJ(RV32i_ISA insn, word_t rd, word_t imm) {
+  return base(insn) | ((imm >> 20) & 1) << 31 | ((imm >> 1) & 0x3FF) << 21 |
+                      ((imm >> 11) & 1) << 20 | ((imm >> 12) & 0xFF) << 12 | rd << 7;
+}
+
+// offset of c.j and c.jal
+word_t immCJ(half_t code) {
+  word_t imm = bit(code, 12) << 11 | bit(code, 11) << 4 | bits(code, 10, 9) << 8 |
+               bit(code, 8) << 10 | bit(code, 7) << 6 | bit(code, 6) << 7 |
+               bits(code, 5, 3) << 1 | bit(code, 2) << 5;
+  return signExtend(imm, 12);
+}
+
+// offset of c.beqz and c.bnez
+word_t immCB(half_t code) {
+  word_t imm = bit(code, 12) << 8 | bits(code, 11, 10) << 3 | bits(code, 6, 5) << 6 |
+               bits(code, 4, 3) << 1 | bit(code, 2) << 5;
+  return signExtend(imm, 9);
+}
+
+// 6-bit immediate of c.addi, c.li, c.andi
+word_t immCI(half_t code) {
+  return signExtend(bit(code, 12) << 5 | bits(code, 6, 2), 6);
+}
+
+// offset of c.lw, c.sw, c.flw and c.fsw
+word_t uimmCLS(half_t code) {
+  return bits(code, 12, 10) << 3 | bit(code, 6) << 2 | bit(code, 5) << 6;
+}
+
+// offset of c.ld and c.sd of RV64
+word_t uimmCLDSD(half_t code) {
+  return bits(code, 12, 10) << 3 | bits(code, 6, 5) << 6;
+}
+
+// offset of c.lwsp and c.flwsp
+word_t uimmCLWSP(half_t code) {
+  return bit(code, 12) << 5 | bits(code, 6, 4) << 2 | bits(code, 3, 2) << 6;
+}
+
+// offset of c.swsp and c.fswsp
+word_t uimmCSWSP(half_t code) {
+  return bits(code, 12, 9) << 2 | bits(code, 8, 7) << 6;
+}
+
+// offset of c.ldsp of RV64
+word_t uimmCLDSP(half_t code) {
+  return bit(code, 12) << 5 | bits(code, 6, 5) << 3 | bits(code, 4, 2) << 6;
+}
+
+// offset of c.sdsp of RV64
+word_t uimmCSDSP(half_t code) {
+  return bits(code, 12, 10) << 3 | bits(code, 9, 7) << 6;
+}
+
+// shamt[5] is reserved on RV32
+bool shamtValid(half_t code) { return XLEN == 64 || bit(code, 12) == 0; }
+
+// shift amount of c.slli, c.srli and c.srai
+word_t shamtC(half_t code) { return bit(code, 12) << 5 | bits(code, 6, 2); }
+
+std::optional<word_t> expandQ0(half_t code) {
+  word_t rd_rs2 = creg(bits(code, 4, 2));
+  word_t rs1 = creg(bits(code, 9, 7));
+
+  switch (bits(code, 15, 13))
+  {
+  case 0b000: { // c.addi4spn
+    word_t nzuimm = bits(code, 12, 11) << 4 | bits(code, 10, 7) << 6 |
+                    bit(code, 6) << 2 | bit(code, 5) << 3;
+    if (nzuimm == 0) return std::nullopt; // also all-zero illegal insn
+    return encI(RV32i_ISA::ADDI, rd_rs2, SP, nzuimm);
+  }
+
+  case 0b010: // c.lw
+    return encI(RV32i_ISA::LW, rd_rs2, rs1, uimmCLS(code));
+
+  case 0b011: // c.flw, c.ld on RV64
+    if constexpr (XLEN == 64) return encI(RV32i_ISA::LD, rd_rs2, rs1, uimmCLDSD(code));
+    return encI(RV32i_ISA::FLW, rd_rs2, rs1, uimmCLS(code));
+
+  case 0b110: // c.sw
+    return encS(RV32i_ISA::SW, rs1, rd_rs2, uimmCLS(code));
+
+  case 0b111: // c.fsw, c.sd on RV64
+    if constexpr (XLEN == 64) return encS(RV32i_ISA::SD, rs1, rd_rs2, uimmCLDSD(code));
+    return encS(RV32i_ISA::FSW, rs1, rd_rs2, uimmCLS(code));
+
+  default:
+    return std::nullopt;
+  }
+}
+
+std::optional<word_t> expandQ1(half_t code) {
+  word_t rd = bits(code, 11, 7);
+  word_t rd_c = creg(bits(code, 9, 7));
+  word_t rs2_c = creg(bits(code, 4, 2));
+
+  switch (bits(code, 15, 13))
+  {
+  case 0b000: // c.addi (c.nop)
+    return encI(RV32i_ISA::ADDI, rd, rd, immCI(code));
+
+  case 0b001: // c.jal, c.addiw on RV64
+    if constexpr (XLEN == 64) {
+      if (rd == 0) return std::nullopt;
+      return encI(RV32i_ISA::ADDIW, rd, rd, immCI(code));
+    }
+    return encJ(RV32i_ISA::JAL, RA, immCJ(code));
+
+  case 0b010: // c.li
+    return encI(RV32i_ISA::ADDI, rd, 0, immCI(code));
+
+  case 0b011: {
+    if (rd == SP) { // c.addi16sp
+      word_t nzimm = bit(code, 12) << 9 | bit(code, 6) << 4 | bit(code, 5) << 6 |
+                     bits(code, 4, 3) << 7 | bit(code, 2) << 5;
+      if (nzimm == 0) return std::nullopt;
+      return encI(RV32i_ISA::ADDI, SP, SP, signExtend(nzimm, 10));
+    }
+
+    // c.lui
+    word_t nzimm = bit(code, 12) << 17 | bits(code, 6, 2) << 12;
+    if (nzimm == 0) return std::nullopt;
+    return encU(RV32i_ISA::LUI, rd, signExtend(nzimm, 18));
+  }
+
+  case 0b100: {
+    word_t shamt = shamtC(code);
+
+    switch (bits(code, 11, 10))
+    {
+    case 0b00: // c.srli
+      if (!shamtValid(code)) return std::nullopt;
+      return encI(RV32i_ISA::SRLI, rd_c, rd_c, shamt);
+
+    case 0b01: // c.srai
+      if (!shamtValid(code)) return std::nullopt;
+      return encI(RV32i_ISA::SRAI, rd_c, rd_c, shamt);
+
+    case 0b10: // c.andi
+      return encI(RV32i_ISA::ANDI, rd_c, rd_c, immCI(code));
+
+    default:
+      break;
+    }
+
+    if (bit(code, 12)) { // c.subw and c.addw of RV64, the rest is reserved
+      if (XLEN != 64 || bit(code, 6)) return std::nullopt;
+      return encR(bit(code, 5) ? RV32i_ISA::ADDW : RV32i_ISA::SUBW, rd_c, rd_c, rs2_c);
+    }
+
+    static constexpr RV32i_ISA ops[] = {
+      RV32i_ISA::SUB, RV32i_ISA::XOR, RV32i_ISA::OR, RV32i_ISA::AND,
+    };
+    return encR(ops[bits(code, 6, 5)], rd_c, rd_c, rs2_c);
+  }
+
+  case 0b101: // c.j
+    return encJ(RV32i_ISA::JAL, 0, immCJ(code));
+
+  case 0b110: // c.beqz
+    return encB(RV32i_ISA::BEQ, rd_c, 0, immCB(code));
+
+  case 0b111: // c.bnez
+    return encB(RV32i_ISA::BNE, rd_c, 0, immCB(code));
+
+  default:
+    return std::nullopt;
+  }
+}
+
+std::optional<word_t> expandQ2(half_t code) {
+  word_t rd = bits(code, 11, 7);
+  word_t rs2 = bits(code, 6, 2);
+
+  switch (bits(code, 15, 13))
+  {
+  case 0b000: // c.slli
+    if (!shamtValid(code)) return std::nullopt;
+    return encI(RV32i_ISA::SLLI, rd, rd, shamtC(code));
+
+  case 0b010: // c.lwsp
+    if (rd == 0) return std::nullopt;
+    return encI(RV32i_ISA::LW, rd, SP, uimmCLWSP(code));
+
+  case 0b011: // c.flwsp, f0 is a valid destination; c.ldsp on RV64
+    if constexpr (XLEN == 64) {
+      if (rd == 0) return std::nullopt;
+      return encI(RV32i_ISA::LD, rd, SP, uimmCLDSP(code));
+    }
+    return encI(RV32i_ISA::FLW, rd, SP, uimmCLWSP(code));
+
+  case 0b100:
+    if (bit(code, 12) == 0) {
+      if (rs2 != 0) return encR(RV32i_ISA::ADD, rd, 0, rs2); // c.mv
+
+      if (rd == 0) return std::nullopt;
+      return encI(RV32i_ISA::JALR, 0, rd, 0); // c.jr
+    }
+
+    if (rs2 != 0) return encR(RV32i_ISA::ADD, rd, rd, rs2); // c.add
+    if (rd == 0) return base(RV32i_ISA::EBREAK); // c.ebreak
+    return encI(RV32i_ISA::JALR, RA, rd, 0); // c.jalr
+
+  case 0b110: // c.swsp
+    return encS(RV32i_ISA::SW, SP, rs2, uimmCSWSP(code));
+
+  case 0b111: // c.fswsp, c.sdsp on RV64
+    if constexpr (XLEN == 64) return encS(RV32i_ISA::SD, SP, rs2, uimmCSDSP(code));
+    return encS(RV32i_ISA::FSW, SP, rs2, uimmCSWSP(code));
+
+  default:
+    return std::nullopt;
+  }
+}
+
+} // namespace
+
+std::optional<word_t> expandCompressed(half_t code) {
+  switch (code & RVC_QUADRANT_MASK)
+  {
+  case 0b00:
+    return expandQ0(code);
+
+  case 0b01:
+    return expandQ1(code);
+
+  case 0b10:
+    return expandQ2(code);
+
+  default:
+    return std::nullopt; // not a compressed insn
+  }
+}
+
+} // rv32i_sim
@@ -0,0 +1,50 @@
+#include "device.hpp"
+
+#include <iostream>
+
+namespace rv32i_sim {
+
+bool DeviceBus::attach(addr_t base, addr_t size, IDevice* device) {
+  if (!device || size == 0) return false;
+
+  std::size_t first_page = base >> DEVICE_PAGE_BITS;
+  std::size_t last_page = (std::size_t(base) + size - 1) >> DEVICE_PAGE_BITS;
+
+  if (devices_.size() >= UINT8_MAX) {
+    std::cerr << "ERROR: too many devices on bus\n";
+    return false;
+  }
+
+  if (pages_.size() <= last_page) pages_.resize(last_page + 1);
+
+  for (std::size_t page = first_page; page <= last_page; ++page) {
+    if (pages_[page]) {
+      std::cerr << "ERROR: device at 0x" << std::hex << base << std::dec
+                << " overlaps another one\n";
+      return false;
+    }
+  }
+
+  devices_.push_back(Mapping {
+    static_cast<addr_t>(first_page << DEVICE_PAGE_BITS),
+    static_cast<addr_t>((last_page - first_page + 1) << DEVICE_PAGE_BITS),
+    device,
+  });
+
+  for (std::size_t page = first_page; page <= last_page; ++page)
+    pages_[page] = devices_.size();
+
+  return true;
+}
+
+dword_t DeviceBus::read(addr_t addr, unsigned size) const {
+  const Mapping* mapping = find(addr);
+  return mapping ? mapping->device->read(addr - mapping->base, size) : 0;
+}
+
+void DeviceBus::write(addr_t addr, unsigned size, dword_t val) const {
+  const Mapping* mapping = find(addr);
+  if (mapping) mapping->device->write(addr - mapping->base, size, val);
+}
+
+} // rv32i_sim
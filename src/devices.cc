@@ -0,0 +1,159 @@
+#include "devices.hpp"
+
+#include <iostream>
+
+namespace rv32i_sim {
+
+namespace {
+
+dword_t sizeMask(unsigned size) {
+  return size >= sizeof(dword_t) ? ~dword_t(0) : (dword_t(1) << size * BITS_BYTE) - 1;
+}
+
+// true if access [offset, offset + size) lies in register [reg, reg + reg_size)
+bool hits(addr_t offset, unsigned size, addr_t reg, unsigned reg_size) {
+  return offset >= reg && offset + size <= reg + reg_size;
+}
+
+// registers are accessed by their parts too, e.g. 64-bit mtimecmp by two sw
+dword_t readPart(dword_t reg_val, addr_t shift, unsigned size) {
+  return (reg_val >> shift * BITS_BYTE) & sizeMask(size);
+}
+
+template <typename T>
+void writePart(T& reg_val, addr_t shift, unsigned size, dword_t val) {
+  dword_t mask = sizeMask(size) << shift * BITS_BYTE;
+  reg_val = (reg_val & ~mask) | ((val << shift * BITS_BYTE) & mask);
+}
+
+} // namespace
+
+// registers are bytes, wider accesses see only the first one
+dword_t Uart::read(addr_t offset, unsigned size) {
+  (void) size;
+  if (offset >= regs_.size()) return 0;
+
+  bool dlab = regs_[UART_LCR] & UART_LCR_DLAB;
+  if (dlab && offset < divisor_.size()) return divisor_[offset];
+
+  switch (offset)
+  {
+  case UART_THR:
+    return 0; // nothing received
+
+  case UART_IIR:
+    return UART_IIR_NONE;
+
+  case UART_LSR:
+    return UART_LSR_IDLE;
+
+  default:
+    return regs_[offset];
+  }
+}
+
+void Uart::write(addr_t offset, unsigned size, dword_t val) {
+  (void) size;
+  if (offset >= regs_.size()) return;
+
+  bool dlab = regs_[UART_LCR] & UART_LCR_DLAB;
+  if (dlab && offset < divisor_.size()) {
+    divisor_[offset] = val;
+    return;
+  }
+
+  if (offset == UART_THR) {
+    byte_t byte = val;
+    env_.writeConsole(&byte, sizeof(byte));
+    return;
+  }
+
+  if (offset != UART_LSR) regs_[offset] = val;
+}
+
+dword_t Clint::read(addr_t offset, unsigned size) {
+  if (hits(offset, size, CLINT_MSIP, sizeof(word_t)))
+    return readPart(msip_, offset - CLINT_MSIP, size);
+
+  if (hits(offset, size, CLINT_MTIMECMP, sizeof(dword_t)))
+    return readPart(mtimecmp_, offset - CLINT_MTIMECMP, size);
+
+  if (hits(offset, size, CLINT_MTIME, sizeof(dword_t)))
+    return readPart(getMtime(), offset - CLINT_MTIME, size);
+
+  return 0;
+}
+
+void Clint::write(addr_t offset, unsigned size, dword_t val) {
+  if (hits(offset, size, CLINT_MSIP, sizeof(word_t))) {
+    writePart(msip_, offset - CLINT_MSIP, size, val);
+    msip_ &= 1; // the rest is hardwired to 0
+    if (on_software_) on_software_(softwarePending());
+    return;
+  }
+
+  if (hits(offset, size, CLINT_MTIMECMP, sizeof(dword_t))) {
+    writePart(mtimecmp_, offset - CLINT_MTIMECMP, size, val);
+    scheduleTimer();
+    return;
+  }
+
+  if (hits(offset, size, CLINT_MTIME, sizeof(dword_t))) {
+    uint64_t mtime = getMtime();
+    writePart(mtime, offset - CLINT_MTIME, size, val);
+    time_offset_ = mtime - time_();
+    scheduleTimer();
+  }
+}
+
+void Clint::connect(EventScheduler* events, IrqCallback on_timer, IrqCallback on_software) {
+  if (events_) events_->cancel(timer_event_);
+
+  events_ = events;
+  on_timer_ = std::move(on_timer);
+  on_software_ = std::move(on_software);
+  scheduleTimer();
+  if (on_software_) on_software_(softwarePending());
+}
+
+// time source is not ticked, so the timer is an event at mtimecmp in its units
+void Clint::scheduleTimer() {
+  if (!events_) return;
+
+  events_->cancel(timer_event_);
+  timer_event_ = 0;
+
+  bool pending = timerPending();
+  if (on_timer_) on_timer_(pending);
+  if (pending || mtimecmp_ == UINT64_MAX) return;
+
+  timer_event_ = events_->schedule(mtimecmp_ - time_offset_, [this](uint64_t) {
+    timer_event_ = 0;
+    if (on_timer_) on_timer_(true);
+  });
+}
+
+void Syscon::write(addr_t offset, unsigned size, dword_t val) {
+  if (offset != 0 || size < sizeof(half_t)) return;
+
+  switch (val & 0xFFFF)
+  {
+  case SYSCON_PASS:
+    power_off_(0);
+    break;
+
+  case SYSCON_FAIL:
+    power_off_((val >> 16) & 0xFFFF);
+    break;
+
+  case SYSCON_RESET:
+    std::cerr << "ERROR: guest reset is not supported\n";
+    power_off_(std::nullopt);
+    break;
+
+  default:
+    break;
+  }
+}
+
+} // rv32i_sim
@@ -0,0 +1,446 @@
+#include "exec_env.hpp"
+
+#include <bit>
+#include <cassert>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "isim.hpp"
+
+namespace rv32i_sim {
+
+namespace {
+
+int hostOpenFlags(reg_t flags) {
+  int host_flags = flags & GUEST_O_ACCMODE;
+  if (flags & GUEST_O_APPEND) host_flags |= O_APPEND;
+  if (flags & GUEST_O_CREAT)  host_flags |= O_CREAT;
+  if (flags & GUEST_O_TRUNC)  host_flags |= O_TRUNC;
+  if (flags & GUEST_O_EXCL)   host_flags |= O_EXCL;
+
+  return host_flags;
+}
+
+template <typename T>
+void put(std::vector<byte_t>& buf, std::size_t offset, T val) {
+  static_assert(std::endian::native == std::endian::little, "Guest is little endian");
+  std::memcpy(buf.data() + offset, &val, sizeof(T));
+}
+
+// struct kernel_stat of libgloss/riscv for rv32
+std::vector<byte_t> guestStat(const struct stat& st) {
+  std::vector<byte_t> buf(GUEST_STAT_SIZE);
+
+  put<uint64_t>(buf,   0, st.st_dev);
+  put<uint64_t>(buf,   8, st.st_ino);
+  put<uint32_t>(buf,  16, st.st_mode);
+  put<uint32_t>(buf,  20, st.st_nlink);
+  put<uint32_t>(buf,  24, st.st_uid);
+  put<uint32_t>(buf,  28, st.st_gid);
+  put<uint64_t>(buf,  32, st.st_rdev);
+  put<int64_t> (buf,  48, st.st_size);
+  put<int32_t> (buf,  56, st.st_blksize);
+  put<int64_t> (buf,  64, st.st_blocks);
+  put<int64_t> (buf,  72, st.st_atim.tv_sec);
+  put<int32_t> (buf,  80, st.st_atim.tv_nsec);
+  put<int64_t> (buf,  88, st.st_mtim.tv_sec);
+  put<int32_t> (buf,  96, st.st_mtim.tv_nsec);
+  put<int64_t> (buf, 104, st.st_ctim.tv_sec);
+  put<int32_t> (buf, 112, st.st_ctim.tv_nsec);
+
+  return buf;
+}
+
+sreg_t errnoResult() { return -static_cast<sreg_t>(errno); }
+
+} // namespace
+
+std::optional<FlushPolicy> OutputConfig::parsePolicy(const std::string& str) {
+  if (str == "unbuffered") return FlushPolicy::UNBUFFERED;
+  if (str == "line") return FlushPolicy::LINE;
+  if (str == "full") return FlushPolicy::FULL;
+  if (str == "exit") return FlushPolicy::EXIT;
+
+  return std::nullopt;
+}
+
+GuestOutput::GuestOutput(GuestOutput&& other) noexcept :
+    host_fd_(std::exchange(other.host_fd_, -1)), owned_(std::exchange(other.owned_, false)),
+    config_(other.config_), buf_(std::move(other.buf_)),
+    captured_(std::move(other.captured_)) {
+  other.buf_.clear();
+}
+
+GuestOutput& GuestOutput::operator=(GuestOutput&& other) noexcept {
+  if (this == &other) return *this;
+
+  release();
+  host_fd_ = std::exchange(other.host_fd_, -1);
+  owned_ = std::exchange(other.owned_, false);
+  config_ = other.config_;
+  buf_ = std::move(other.buf_);
+  captured_ = std::move(other.captured_);
+  other.buf_.clear();
+
+  return *this;
+}
+
+void GuestOutput::release() {
+  flush();
+  if (owned_) ::close(host_fd_);
+
+  host_fd_ = -1;
+  owned_ = false;
+}
+
+GuestOutput GuestOutput::capture(const OutputConfig& config) {
+  return GuestOutput(-1, config);
+}
+
+std::optional<GuestOutput> GuestOutput::toFile(const std::filesystem::path& path,
+                                               const OutputConfig& config) {
+  int host_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (host_fd < 0) {
+    std::cerr << "ERROR: failed to open guest output file " << path << "\n";
+    return std::nullopt;
+  }
+
+  GuestOutput output(host_fd, config);
+  output.owned_ = true;
+
+  return output;
+}
+
+bool GuestOutput::writeHost(const char* data, std::size_t size) {
+  if (isCaptured()) {
+    captured_.append(data, size);
+    return true;
+  }
+
+  while (size != 0) {
+    ssize_t n_written = ::write(host_fd_, data, size);
+    if (n_written < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+
+    data += n_written;
+    size -= n_written;
+  }
+
+  return true;
+}
+
+sreg_t GuestOutput::write(const byte_t* data, std::size_t size) {
+  const char* chars = reinterpret_cast<const char *>(data);
+
+  // nothing to merge with, or too big to be worth copying
+  bool direct = config_.policy == FlushPolicy::UNBUFFERED ||
+                (buf_.empty() && size >= config_.buffer_size &&
+                                 config_.policy != FlushPolicy::EXIT);
+  if (direct) return writeHost(chars, size) ? static_cast<sreg_t>(size) : errnoResult();
+
+  buf_.append(chars, size);
+
+  bool full = buf_.size() >= config_.buffer_size;
+  bool do_flush = false;
+  switch (config_.policy)
+  {
+  case FlushPolicy::LINE:
+    do_flush = full || std::memchr(chars, '\n', size);
+    break;
+
+  case FlushPolicy::FULL:
+    do_flush = full;
+    break;
+
+  default:
+    break;
+  }
+
+  if (do_flush && !flush()) return errnoResult();
+
+  return size;
+}
+
+bool GuestOutput::flush() {
+  if (buf_.empty()) return true;
+
+  bool ok = writeHost(buf_.data(), buf_.size());
+  buf_.clear();
+
+  return ok;
+}
+
+void GuestOutput::setConfig(const OutputConfig& config) {
+  flush();
+  config_ = config;
+}
+
+ExecEnv::ExecEnv() : fds_{{0, STDIN_FILENO}, {1, STDOUT_FILENO}, {2, STDERR_FILENO}},
+    outputs_{GuestOutput(STDOUT_FILENO), GuestOutput(STDERR_FILENO)} {}
+
+ExecEnv::ExecEnv(ExecEnv&& other) noexcept :
+    fds_(std::exchange(other.fds_, {})), next_fd_(other.next_fd_),
+    exit_code_(other.exit_code_), outputs_(std::move(other.outputs_)) {}
+
+ExecEnv& ExecEnv::operator=(ExecEnv&& other) noexcept {
+  if (this == &other) return *this;
+
+  closeOwned();
+  fds_ = std::exchange(other.fds_, {});
+  next_fd_ = other.next_fd_;
+  exit_code_ = other.exit_code_;
+  outputs_ = std::move(other.outputs_);
+
+  return *this;
+}
+
+ExecEnv::~ExecEnv() { closeOwned(); }
+
+void ExecEnv::reset() {
+  closeOwned();
+  fds_ = {{0, STDIN_FILENO}, {1, STDOUT_FILENO}, {2, STDERR_FILENO}};
+  next_fd_ = 3;
+  exit_code_ = std::nullopt;
+
+  flush();
+}
+
+void ExecEnv::setOutput(word_t guest_fd, GuestOutput&& output) {
+  assert((guest_fd == 1 || guest_fd == 2) && "Only stdout and stderr are buffered");
+  outputs_[guest_fd - 1] = std::move(output);
+}
+
+const GuestOutput& ExecEnv::getOutput(word_t guest_fd) const {
+  assert((guest_fd == 1 || guest_fd == 2) && "Only stdout and stderr are buffered");
+  return outputs_[guest_fd - 1];
+}
+
+void ExecEnv::setOutputConfig(const OutputConfig& config) {
+  for (auto&& output : outputs_) output.setConfig(config);
+}
+
+void ExecEnv::captureOutputs() {
+  for (auto&& output : outputs_) output = GuestOutput::capture(output.getConfig());
+}
+
+void ExecEnv::flush() {
+  for (auto&& output : outputs_) output.flush();
+}
+
+void ExecEnv::closeOwned() {
+  for (auto&& [guest_fd, host_fd] : fds_)
+    if (guest_fd > STDERR_FILENO) ::close(host_fd);
+
+  fds_.clear();
+}
+
+std::optional<int> ExecEnv::hostFd(reg_t guest_fd) const {
+  auto found = fds_.find(guest_fd);
+  if (found == fds_.end()) return std::nullopt;
+
+  return found->second;
+}
+
+// nullptr if guest has closed its stdout or stderr
+GuestOutput* ExecEnv::outputOf(reg_t guest_fd) {
+  if (guest_fd != 1 && guest_fd != 2) return nullptr;
+  if (!fds_.count(guest_fd)) return nullptr;
+
+  return &outputs_[guest_fd - 1];
+}
+
+void ExecEnv::syscall(IRVModel& model) {
+  // Arch/ABI	arg1	arg2	arg3	arg4	arg5	arg6	 syscall No
+  // riscv	    a0	  a1	  a2	  a3	  a4	  a5	      a7
+  auto syscall = static_cast<EESyscall>(model.getReg(Register::X17));
+  reg_t a0 = model.getReg(Register::X10);
+  reg_t a1 = model.getReg(Register::X11);
+  reg_t a2 = model.getReg(Register::X12);
+  reg_t a3 = model.getReg(Register::X13);
+
+  sreg_t res = 0;
+  switch (syscall)
+  {
+  case EESyscall::OPENAT:
+    res = sysOpenat(model, static_cast<sreg_t>(a0), a1, a2, a3);
+    break;
+
+  case EESyscall::CLOSE:
+    res = sysClose(a0);
+    break;
+
+  case EESyscall::LSEEK:
+    res = sysLseek(a0, static_cast<sreg_t>(a1), a2);
+    break;
+
+  case EESyscall::READ:
+    res = sysRead(model, a0, a1, a2);
+    break;
+
+  case EESyscall::WRITE:
+    res = sysWrite(model, a0, a1, a2);
+    break;
+
+  case EESyscall::FSTAT:
+    res = sysFstat(model, a0, a1);
+    break;
+
+  case EESyscall::GETTIMEOFDAY:
+    res = sysGettimeofday(model, a0);
+    break;
+
+  case EESyscall::BRK:
+    res = sysBrk(model, a0);
+    break;
+
+  case EESyscall::EXIT:
+    exit(model, a0);
+    return; // a0 is kept for the exit status
+
+  default:
+    std::cerr << "ERROR: unknown syscall " << static_cast<word_t>(syscall)
+              << " <pc = " << model.getPC() << ">\n";
+    res = -ENOSYS;
+    break;
+  }
+
+  model.setReg(Register::X10, static_cast<reg_t>(res));
+}
+
+sreg_t ExecEnv::sysOpenat(IRVModel& model, sreg_t dirfd, addr_t path,
+                                                       reg_t flags, reg_t mode) {
+  int host_dirfd = AT_FDCWD;
+  if (dirfd != GUEST_AT_FDCWD) {
+    auto found = hostFd(std::bit_cast<reg_t>(dirfd));
+    if (!found) return -EBADF;
+    host_dirfd = *found;
+  }
+
+  std::string host_path;
+  if (!model.readString(path, PATH_MAX, host_path)) return -EFAULT;
+
+  int host_fd = ::openat(host_dirfd, host_path.c_str(), hostOpenFlags(flags), mode);
+  if (host_fd < 0) return errnoResult();
+
+  reg_t guest_fd = next_fd_++;
+  fds_[guest_fd] = host_fd;
+
+  return guest_fd;
+}
+
+sreg_t ExecEnv::sysClose(reg_t fd) {
+  auto host_fd = hostFd(fd);
+  if (!host_fd) return -EBADF;
+
+  if (GuestOutput* output = outputOf(fd)) output->flush();
+
+  fds_.erase(fd);
+  if (fd <= STDERR_FILENO) return 0; // shared with simulator
+
+  return ::close(*host_fd) < 0 ? errnoResult() : 0;
+}
+
+sreg_t ExecEnv::sysLseek(reg_t fd, sreg_t offset, reg_t whence) {
+  auto host_fd = hostFd(fd);
+  if (!host_fd) return -EBADF;
+
+  off_t pos = ::lseek(*host_fd, offset, whence);
+  if (pos < 0) return errnoResult();
+  if (pos > std::numeric_limits<sreg_t>::max()) return -EOVERFLOW;
+
+  return pos;
+}
+
+// data goes directly between host and guest memory, the range is checked
+// once, so a bad buffer fails the whole call as on a real kernel
+sreg_t ExecEnv::sysRead(IRVModel& model, reg_t fd, addr_t buf, reg_t count) {
+  auto host_fd = hostFd(fd);
+  if (!host_fd) return -EBADF;
+
+  byte_t* data = model.hostPtr(buf, count, RIGHTS_W);
+  if (!data) return -EFAULT;
+
+  // prompt must be seen before the guest waits for input
+  if (fd == 0) flush();
+
+  ssize_t n_read = ::read(*host_fd, data, count);
+  if (n_read < 0) return errnoResult();
+
+  return n_read;
+}
+
+sreg_t ExecEnv::sysWrite(IRVModel& model, reg_t fd, addr_t buf, reg_t count) {
+  auto host_fd = hostFd(fd);
+  if (!host_fd) return -EBADF;
+
+  const byte_t* data = model.hostPtr(buf, count, RIGHTS_R);
+  if (!data) return -EFAULT;
+
+  if (GuestOutput* output = outputOf(fd)) return output->write(data, count);
+
+  ssize_t n_written = ::write(*host_fd, data, count);
+  if (n_written < 0) return errnoResult();
+
+  return n_written;
+}
+
+sreg_t ExecEnv::sysFstat(IRVModel& model, reg_t fd, addr_t statbuf) {
+  auto host_fd = hostFd(fd);
+  if (!host_fd) return -EBADF;
+
+  struct stat st {};
+  if (::fstat(*host_fd, &st) < 0) return errnoResult();
+
+  byte_t* data = model.hostPtr(statbuf, GUEST_STAT_SIZE, RIGHTS_W);
+  if (!data) return -EFAULT;
+
+  std::vector<byte_t> guest_st = guestStat(st);
+  std::memcpy(data, guest_st.data(), guest_st.size());
+
+  return 0;
+}
+
+sreg_t ExecEnv::sysGettimeofday(IRVModel& model, addr_t tv) {
+  struct timeval host_tv {};
+  ::gettimeofday(&host_tv, nullptr);
+
+  byte_t* data = model.hostPtr(tv, GUEST_TIMEVAL_SIZE, RIGHTS_W);
+  if (!data) return -EFAULT;
+
+  std::vector<byte_t> guest_tv(GUEST_TIMEVAL_SIZE);
+  put<int64_t>(guest_tv, 0, host_tv.tv_sec);
+  put<int32_t>(guest_tv, 8, host_tv.tv_usec);
+  std::memcpy(data, guest_tv.data(), guest_tv.size());
+
+  return 0;
+}
+
+// as in Linux: brk(0) asks for current break, failure leaves it as it was
+sreg_t ExecEnv::sysBrk(IRVModel& model, addr_t brk) {
+  return static_cast<sreg_t>(model.setBrk(brk));
+}
+
+void ExecEnv::exit(IRVModel& model, word_t code) {
+  exit_code_ = code;
+  model.exit(); // flushes outputs
+}
+
+// console is hardware, guest cannot close it as it can close fd 1
+sreg_t ExecEnv::writeConsole(const byte_t* data, std::size_t size) {
+  return outputs_[0].write(data, size);
+}
+
+} // rv32i_sim
@@ -0,0 +1,239 @@
+#include "fpu.hpp"
+
+#include <bit>
+#include <cfenv>
+#include <cmath>
+#include <limits>
+
+namespace rv32i_sim {
+
+namespace {
+
+constexpr word_t EXP_MASK = 0x7F800000;
+constexpr word_t FRAC_MASK = 0x007FFFFF;
+constexpr word_t QUIET_BIT = 0x00400000;
+
+// host has no ties-to-max-magnitude mode, RMM differs from RNE only
+// on exact ties, conversions to integer handle it on their own
+int hostRounding(RoundingMode rm) {
+  switch (rm)
+  {
+  case RoundingMode::RTZ: return FE_TOWARDZERO;
+  case RoundingMode::RDN: return FE_DOWNWARD;
+  case RoundingMode::RUP: return FE_UPWARD;
+  default: return FE_TONEAREST;
+  }
+}
+
+/// @brief host FP environment for a single guest op
+///
+/// host flags are cleared and collected around the op; rounding mode is
+/// switched only when guest asks for non-default one, as almost all code
+/// runs in RNE and changing host mode is far more expensive than the op
+class HostFPEnv final {
+  int saved_rounding_ = FE_TONEAREST;
+  bool switched_ = false;
+
+public:
+  explicit HostFPEnv(RoundingMode rm) {
+    std::feclearexcept(FE_ALL_EXCEPT);
+
+    int rounding = hostRounding(rm);
+    if (rounding == FE_TONEAREST) return;
+
+    saved_rounding_ = std::fegetround();
+    std::fesetround(rounding);
+    switched_ = true;
+  }
+
+  HostFPEnv(const HostFPEnv&) = delete;
+  HostFPEnv& operator=(const HostFPEnv&) = delete;
+
+  ~HostFPEnv() {
+    if (switched_) std::fesetround(saved_rounding_);
+  }
+
+  // volatile keeps the op itself between clearing and testing of host flags
+  static float in(word_t bits) {
+    volatile float val = std::bit_cast<float>(bits);
+    return val;
+  }
+
+  uint8_t flags() const {
+    int raised = std::fetestexcept(FE_ALL_EXCEPT);
+
+    uint8_t flags = 0;
+    if (raised & FE_INEXACT) flags |= FFLAG_NX;
+    if (raised & FE_UNDERFLOW) flags |= FFLAG_UF;
+    if (raised & FE_OVERFLOW) flags |= FFLAG_OF;
+    if (raised & FE_DIVBYZERO) flags |= FFLAG_DZ;
+    if (raised & FE_INVALID) flags |= FFLAG_NV;
+
+    return flags;
+  }
+
+  FPResult result(float res) const {
+    volatile float out = res;
+    uint8_t raised = flags();
+
+    float val = out;
+    return FPResult {std::isnan(val) ? CANONICAL_NAN : std::bit_cast<word_t>(val), raised};
+  }
+};
+
+} // namespace
+
+bool isNaN(word_t bits) {
+  return (bits & ~FP_SIGN_MASK) > EXP_MASK;
+}
+
+bool isSignalingNaN(word_t bits) {
+  return isNaN(bits) && !(bits & QUIET_BIT);
+}
+
+FPResult fpAdd(word_t a, word_t b, RoundingMode rm) {
+  HostFPEnv env{rm};
+  return env.result(HostFPEnv::in(a) + HostFPEnv::in(b));
+}
+
+FPResult fpSub(word_t a, word_t b, RoundingMode rm) {
+  HostFPEnv env{rm};
+  return env.result(HostFPEnv::in(a) - HostFPEnv::in(b));
+}
+
+FPResult fpMul(word_t a, word_t b, RoundingMode rm) {
+  HostFPEnv env{rm};
+  return env.result(HostFPEnv::in(a) * HostFPEnv::in(b));
+}
+
+FPResult fpDiv(word_t a, word_t b, RoundingMode rm) {
+  HostFPEnv env{rm};
+  return env.result(HostFPEnv::in(a) / HostFPEnv::in(b));
+}
+
+FPResult fpSqrt(word_t a, RoundingMode rm) {
+  HostFPEnv env{rm};
+  return env.result(std::sqrt(HostFPEnv::in(a)));
+}
+
+FPResult fpFma(word_t a, word_t b, word_t c, RoundingMode rm) {
+  HostFPEnv env{rm};
+  return env.result(std::fma(HostFPEnv::in(a), HostFPEnv::in(b), HostFPEnv::in(c)));
+}
+
+// NaN operand is ignored, -0.0 is less than +0.0
+FPResult fpMin(word_t a, word_t b) {
+  uint8_t flags = isSignalingNaN(a) || isSignalingNaN(b) ? FFLAG_NV : 0;
+
+  if (isNaN(a) && isNaN(b)) return FPResult {CANONICAL_NAN, flags};
+  if (isNaN(a)) return FPResult {b, flags};
+  if (isNaN(b)) return FPResult {a, flags};
+
+  float x = std::bit_cast<float>(a);
+  float y = std::bit_cast<float>(b);
+  if (x == y) return FPResult {a | b, flags}; // the same or zeros of different sign
+
+  return FPResult {x < y ? a : b, flags};
+}
+
+FPResult fpMax(word_t a, word_t b) {
+  uint8_t flags = isSignalingNaN(a) || isSignalingNaN(b) ? FFLAG_NV : 0;
+
+  if (isNaN(a) && isNaN(b)) return FPResult {CANONICAL_NAN, flags};
+  if (isNaN(a)) return FPResult {b, flags};
+  if (isNaN(b)) return FPResult {a, flags};
+
+  float x = std::bit_cast<float>(a);
+  float y = std::bit_cast<float>(b);
+  if (x == y) return FPResult {a & b, flags};
+
+  return FPResult {x > y ? a : b, flags};
+}
+
+// comparisons do not touch host flags: feq is quiet (NV on signaling NaN only),
+// flt and fle are signaling (NV on any NaN)
+FPResult fpEq(word_t a, word_t b) {
+  if (isNaN(a) || isNaN(b))
+    return FPResult {0, isSignalingNaN(a) || isSignalingNaN(b) ? FFLAG_NV : uint8_t(0)};
+
+  return FPResult {std::bit_cast<float>(a) == std::bit_cast<float>(b)};
+}
+
+FPResult fpLt(word_t a, word_t b) {
+  if (isNaN(a) || isNaN(b)) return FPResult {0, FFLAG_NV};
+
+  return FPResult {std::bit_cast<float>(a) < std::bit_cast<float>(b)};
+}
+
+FPResult fpLe(word_t a, word_t b) {
+  if (isNaN(a) || isNaN(b)) return FPResult {0, FFLAG_NV};
+
+  return FPResult {std::bit_cast<float>(a) <= std::bit_cast<float>(b)};
+}
+
+FPResult fpCvtWS(word_t a, RoundingMode rm) {
+  constexpr float TWO_31 = 2147483648.0f;
+
+  if (isNaN(a)) return FPResult {word_t(std::numeric_limits<sword_t>::max()), FFLAG_NV};
+
+  HostFPEnv env{rm};
+  float x = HostFPEnv::in(a);
+  volatile float rounded = rm == RoundingMode::RMM ? std::round(x) : std::rint(x);
+
+  if (rounded >= TWO_31)
+    return FPResult {word_t(std::numeric_limits<sword_t>::max()), FFLAG_NV};
+  if (rounded < -TWO_31)
+    return FPResult {word_t(std::numeric_limits<sword_t>::min()), FFLAG_NV};
+
+  uint8_t flags = rounded != x ? FFLAG_NX : 0; // std::round does not raise it
+  return FPResult {word_t(sword_t(rounded)), flags};
+}
+
+FPResult fpCvtWUS(word_t a, RoundingMode rm) {
+  constexpr float TWO_32 = 4294967296.0f;
+
+  if (isNaN(a)) return FPResult {std::numeric_limits<word_t>::max(), FFLAG_NV};
+
+  HostFPEnv env{rm};
+  float x = HostFPEnv::in(a);
+  volatile float rounded = rm == RoundingMode::RMM ? std::round(x) : std::rint(x);
+
+  if (rounded >= TWO_32) return FPResult {std::numeric_limits<word_t>::max(), FFLAG_NV};
+  if (rounded < 0.0f) return FPResult {0, FFLAG_NV}; // -0.0 is fine
+
+  uint8_t flags = rounded != x ? FFLAG_NX : 0;
+  return FPResult {word_t(rounded), flags};
+}
+
+FPResult fpCvtSW(word_t a, RoundingMode rm) {
+  HostFPEnv env{rm};
+  volatile sword_t val = std::bit_cast<sword_t>(a);
+  return env.result(static_cast<float>(val));
+}
+
+FPResult fpCvtSWU(word_t a, RoundingMode rm) {
+  HostFPEnv env{rm};
+  volatile word_t val = a;
+  return env.result(static_cast<float>(val));
+}
+
+word_t fpClass(word_t a) {
+  bool negative = a & FP_SIGN_MASK;
+  word_t exp = a & EXP_MASK;
+  word_t frac = a & FRAC_MASK;
+
+  unsigned bit = 0;
+  if (exp == EXP_MASK) {
+    if (frac == 0) bit = negative ? 0 : 7; // infinity
+    else bit = (frac & QUIET_BIT) ? 9 : 8;
+  } else if (exp == 0) {
+    if (frac == 0) bit = negative ? 3 : 4; // zero
+    else bit = negative ? 2 : 5; // subnormal
+  } else {
+    bit = negative ? 1 : 6;
+  }
+
+  return word_t(1) << bit;
+}
+
+} // rv32i_sim
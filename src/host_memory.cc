@@ -0,0 +1,191 @@
+#include "host_memory.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <new>
+
+#include <signal.h>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace rv32i_sim {
+
+namespace {
+
+std::size_t pageUp(std::size_t size) {
+  std::size_t page = HostMemory::pageSize();
+  return (size + page - 1) / page * page;
+}
+
+std::size_t pageDown(std::size_t size) {
+  std::size_t page = HostMemory::pageSize();
+  return size / page * page;
+}
+
+// reads all size bytes, pread may return less than asked
+bool readFile(int fd, byte_t* dst, std::size_t offset, std::size_t size) {
+  while (size) {
+    ssize_t n_read = pread(fd, dst, size, offset);
+    if (n_read <= 0) return false;
+
+    dst += n_read;
+    offset += n_read;
+    size -= n_read;
+  }
+
+  return true;
+}
+
+thread_local HostFaultScope* active_scope = nullptr;
+struct sigaction prev_action; // the one installed before onHostFault
+
+} // namespace
+
+std::size_t HostMemory::pageSize() {
+  static const std::size_t page_size = sysconf(_SC_PAGESIZE);
+  return page_size;
+}
+
+HostMemory::HostMemory(const HostMemory& other) {
+  reserve(other.size_);
+  if (other.size_) std::memcpy(data_, other.data_, other.size_);
+  size_ = other.size_;
+  touched_ = size_;
+}
+
+HostMemory::HostMemory(HostMemory&& other) noexcept :
+    data_(other.data_), size_(other.size_), capacity_(other.capacity_),
+    touched_(other.touched_) {
+  other.data_ = nullptr;
+  other.size_ = other.capacity_ = other.touched_ = 0;
+}
+
+HostMemory& HostMemory::operator=(const HostMemory& other) {
+  if (this == &other) return *this;
+
+  HostMemory copy{other};
+  return *this = std::move(copy);
+}
+
+HostMemory& HostMemory::operator=(HostMemory&& other) noexcept {
+  if (this == &other) return *this;
+
+  release();
+  std::swap(data_, other.data_);
+  std::swap(size_, other.size_);
+  std::swap(capacity_, other.capacity_);
+  std::swap(touched_, other.touched_);
+
+  return *this;
+}
+
+void HostMemory::release() {
+  if (data_) munmap(data_, capacity_);
+
+  data_ = nullptr;
+  size_ = capacity_ = touched_ = 0;
+}
+
+// pages are not backed by swap until written, as heap reserve may be large
+void HostMemory::reserve(std::size_t capacity) {
+  if (capacity <= capacity_) return;
+
+  capacity = pageUp(capacity);
+  void* mapped = mmap(nullptr, capacity, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (mapped == MAP_FAILED) {
+    std::cerr << "ERROR: failed to map " << capacity << " bytes of guest memory\n";
+    throw std::bad_alloc{};
+  }
+
+  byte_t* data = static_cast<byte_t*>(mapped);
+  if (data_) std::memcpy(data, data_, size_);
+
+  std::size_t size = size_;
+  release();
+
+  data_ = data;
+  size_ = size;
+  touched_ = size;
+  capacity_ = capacity;
+}
+
+// bytes dropped by shrinking may be dirty, so only they are zeroed on growth
+void HostMemory::resize(std::size_t size) {
+  if (size > capacity_) reserve(std::max(size, 2 * capacity_));
+
+  if (size > size_ && touched_ > size_)
+    std::memset(data_ + size_, 0, std::min(size, touched_) - size_);
+
+  size_ = size;
+  touched_ = std::max(touched_, size);
+}
+
+bool HostMemory::mapFile(int fd, std::size_t offset, std::size_t addr, std::size_t size) {
+  if (addr + size > size_) return false;
+
+  // pages at both ends may be shared with the neighbouring data
+  std::size_t map_begin = pageUp(addr);
+  std::size_t map_end = pageDown(addr + size);
+  bool congruent = (addr - offset) % pageSize() == 0;
+
+  if (!congruent || map_begin >= map_end)
+    return readFile(fd, data_ + addr, offset, size);
+
+  std::size_t map_offset = offset + (map_begin - addr);
+  void* mapped = mmap(data_ + map_begin, map_end - map_begin, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_FIXED, fd, map_offset);
+  if (mapped == MAP_FAILED) return readFile(fd, data_ + addr, offset, size);
+
+  return readFile(fd, data_ + addr, offset, map_begin - addr) &&
+         readFile(fd, data_ + map_end, offset + (map_end - addr), addr + size - map_end);
+}
+
+bool HostMemory::protect(std::size_t addr, std::size_t size, int prot) {
+  std::size_t begin = pageDown(addr);
+  std::size_t end = pageUp(addr + size);
+  if (end > capacity_) return false;
+  if (begin == end) return true;
+
+  return mprotect(data_ + begin, end - begin, prot) == 0;
+}
+
+bool HostMemory::operator==(const HostMemory& other) const {
+  return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+}
+
+// SA_NODEFER: jump skips return from the handler, SIGSEGV must not stay blocked
+void onHostFault(int sig, siginfo_t* info, void* context) {
+  HostFaultScope* scope = active_scope;
+  if (scope && scope->memory_.contains(info->si_addr)) {
+    scope->fault_.addr = static_cast<const byte_t*>(info->si_addr);
+    siglongjmp(scope->fault_.env, 1);
+  }
+
+  // not a guest access: fault again with the previous handler on return
+  sigaction(sig, &prev_action, nullptr);
+  (void) context;
+}
+
+HostFaultScope::HostFaultScope(HostFault& fault, const HostMemory& memory) :
+    fault_(fault), memory_(memory), prev_(active_scope) {
+  static std::once_flag installed;
+  std::call_once(installed, [] {
+    struct sigaction action {};
+    action.sa_sigaction = onHostFault;
+    action.sa_flags = SA_SIGINFO | SA_NODEFER;
+    sigemptyset(&action.sa_mask);
+
+    if (sigaction(SIGSEGV, &action, &prev_action) != 0)
+      std::cerr << "ERROR: failed to install SIGSEGV handler, guest faults crash the host\n";
+  });
+
+  active_scope = this;
+}
+
+HostFaultScope::~HostFaultScope() { active_scope = prev_; }
+
+} // rv32i_sim
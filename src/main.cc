@@ -1,8 +1,26 @@
+#include <charconv>
 #include <iostream>
 #include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 #include <boost/program_options.hpp>
 
+#include "bpred.hpp"
+#include "cache.hpp"
+#include "callstack.hpp"
+#include "devices.hpp"
+#include "pipeline.hpp"
+#include "profiler.hpp"
+#include "replay.hpp"
+#include "simpoint.hpp"
 #include "sim.hpp"
 
 namespace po = boost::program_options;
@@ -19,6 +37,30 @@ int main(int argc, char *argv[]) {
   std::filesystem::path iregs;
   std::filesystem::path oregs;
   std::filesystem::path elf_path;
+  std::string profile_mode;
+  uint64_t profile_period = 0;
+  unsigned profile_top = rv32i_sim::DEFAULT_PROFILE_TOP;
+  std::filesystem::path callgrind_path;
+  std::string icache_config;
+  std::string dcache_config;
+  std::string bpred_kind;
+  unsigned bpred_bits = rv32i_sim::DEFAULT_BPRED_TABLE_BITS;
+  unsigned bpred_top = rv32i_sim::DEFAULT_BPRED_TOP;
+  rv32i_sim::PipelineConfig pipeline_config;
+  uint64_t fast_forward_insns = 0;
+  std::string fast_forward_sym;
+  uint64_t detail_window = 0;
+  uint64_t interval_len = rv32i_sim::DEFAULT_INTERVAL;
+  std::filesystem::path bbv_path;
+  std::string checkpoint_list;
+  std::filesystem::path checkpoint_dir = ".";
+  std::filesystem::path replay_dir;
+  unsigned jobs = 0;
+  std::string flush_policy = "full";
+  rv32i_sim::OutputConfig output_config;
+  std::filesystem::path guest_stdout;
+  std::filesystem::path guest_stderr;
+  std::string mem_check = "diag";
 
   po::options_description optns_desc{"Possible options"};
   optns_desc.add_options()
@@ -57,6 +99,113 @@ int main(int argc, char *argv[]) {
     ("checkpoints", po::value<bool>(&checkpoints)->default_value(false),
                     "record checkpoints (after each insn execution "
                     "do a mega dump of full sim state)")
+
+    ("profile", po::value<std::string>(&profile_mode)->implicit_value("insn"),
+                "sample guest pc and print flat function profile to stdout\n"
+                "(insn - every n-th retired insn, timer - on host SIGPROF timer)")
+
+    ("profile-period", po::value<uint64_t>(&profile_period),
+                       "sampling period: insns in insn mode, "
+                       "microseconds of cpu time in timer mode")
+
+    ("profile-top", po::value<unsigned>(&profile_top)->default_value(profile_top),
+                    "number of functions in profile report")
+
+    ("callstack", "track calls and returns, print per function inclusive "
+                  "and exclusive insn counts to stdout")
+
+    ("callgrind-out", po::value<std::filesystem::path>(&callgrind_path),
+                      "same as --callstack, but also dump profile in callgrind "
+                      "format (for kcachegrind) to a file")
+
+    ("icache", po::value<std::string>(&icache_config)->implicit_value("32K:4:64:lru"),
+               "model L1 insn cache \"size:ways:line[:lru|random]\", "
+               "print hits, misses and MPKI to stdout")
+
+    ("dcache", po::value<std::string>(&dcache_config)->implicit_value("32K:4:64:lru"),
+               "model L1 data cache, same format as --icache")
+
+    ("bpred", po::value<std::string>(&bpred_kind)->implicit_value("gshare"),
+              "model branch predictor (static, bimodal, gshare) with BTB and "
+              "return address stack, print accuracy to stdout")
+
+    ("bpred-bits", po::value<unsigned>(&bpred_bits)->default_value(bpred_bits),
+                   "log2 of predictor table size (and gshare history length)")
+
+    ("bpred-top", po::value<unsigned>(&bpred_top)->default_value(bpred_top),
+                  "number of worst predicted branches in report")
+
+    ("timing", "estimate cycles and CPI of 5-stage in-order pipeline, "
+               "print them to stdout")
+
+    ("mem-latency", po::value<unsigned>(&pipeline_config.mem_latency)
+                                    ->default_value(pipeline_config.mem_latency),
+                    "cycles of load or store in MEM stage (--timing)")
+
+    ("branch-penalty", po::value<unsigned>(&pipeline_config.branch_penalty)
+                                    ->default_value(pipeline_config.branch_penalty),
+                       "bubbles after taken branch or jalr (--timing)")
+
+    ("jump-penalty", po::value<unsigned>(&pipeline_config.jump_penalty)
+                                    ->default_value(pipeline_config.jump_penalty),
+                     "bubbles after jal (--timing)")
+
+    ("fast-forward", po::value<uint64_t>(&fast_forward_insns),
+                     "execute n insns without tracing and observers (profilers, "
+                     "caches, predictors, timing) before switching them on")
+
+    ("fast-forward-to", po::value<std::string>(&fast_forward_sym),
+                        "same as --fast-forward, but up to the first time "
+                        "pc reaches ELF symbol")
+
+    ("detail-window", po::value<uint64_t>(&detail_window),
+                      "switch back to fast mode after n insns in detailed mode")
+
+    ("interval", po::value<uint64_t>(&interval_len)->default_value(interval_len),
+                 "insns in interval for --bbv and --checkpoint-at")
+
+    ("bbv", po::value<std::filesystem::path>(&bbv_path),
+            "write basic block vector of every interval to a file "
+            "in SimPoint .bb format")
+
+    ("checkpoint-at", po::value<std::string>(&checkpoint_list),
+                      "comma separated indices of intervals to save model state "
+                      "at the start of (e.g. from SimPoint .simpoints file)")
+
+    ("checkpoint-dir", po::value<std::filesystem::path>(&checkpoint_dir)
+                                              ->default_value(checkpoint_dir),
+                       "directory for checkpoints and their manifest")
+
+    ("replay", po::value<std::filesystem::path>(&replay_dir),
+               "simulate checkpointed intervals from a directory in parallel with "
+               "--icache, --dcache, --bpred and --timing models, check that every "
+               "interval ends in the state of the next checkpoint, print merged stats")
+
+    ("jobs", po::value<unsigned>(&jobs)->default_value(jobs),
+             "threads for --replay (0 - number of host cpus)")
+
+    ("guest-flush", po::value<std::string>(&flush_policy)->default_value(flush_policy),
+                    "when buffered guest stdout and stderr are written out: "
+                    "unbuffered, line, full (buffer is full) or exit (guest stops)")
+
+    ("guest-buffer", po::value<std::size_t>(&output_config.buffer_size)
+                                    ->default_value(output_config.buffer_size),
+                     "size of guest output buffers in bytes")
+
+    ("guest-stdout", po::value<std::filesystem::path>(&guest_stdout),
+                     "write guest stdout to a file instead of simulator stdout")
+
+    ("guest-stderr", po::value<std::filesystem::path>(&guest_stderr),
+                     "write guest stderr to a file instead of simulator stderr")
+
+    ("mem-check", po::value<std::string>(&mem_check)->default_value(mem_check),
+                  "checks of guest memory accesses: none (trusted code, no cost), "
+                  "trap (bad access stops the model), diag (same as trap, "
+                  "and tells what was wrong) or host (segment rights are "
+                  "enforced by host page protection, exact up to a page)")
+
+    ("devices", "attach UART, CLINT and syscon at addresses of QEMU virt machine "
+                "for bare-metal firmware, mtime counts retired insns")
   ;
 
   po::variables_map vm;
@@ -76,6 +225,12 @@ int main(int argc, char *argv[]) {
     std::cerr << "Sorry, option --omem is not yet implemented\n";
   }
 
+  if (mem_check != "none" && mem_check != "trap" && mem_check != "diag" &&
+      mem_check != "host") {
+    std::cerr << "ERROR: unknown memory check policy <" << mem_check << ">\n";
+    return 1;
+  }
+
   if (logs) {
     std::cerr << "Sorry, option --logs is not yet implemented\n";
   }
@@ -84,57 +239,420 @@ int main(int argc, char *argv[]) {
     std::cerr << "Sorry, option --checkpoints is not yet implemented\n";
   }
 
-  rv32i_sim::RVModel model{};
+  auto policy = rv32i_sim::OutputConfig::parsePolicy(flush_policy);
+  if (!policy) {
+    std::cerr << "ERROR: unknown guest flush policy <" << flush_policy << ">\n";
+    return 1;
+  }
 
-  if (vm.count("elf")) {
+  output_config.policy = *policy;
 
-    model = rv32i_sim::RVModel(elf_path);
+  // microarchitecture models, shared by normal runs and replay
+  rv32i_sim::ReplayConfig detail_config;
 
-  } else if (vm.count("istate")) {
-    std::ifstream model_state_file{istate};
-    if (!model_state_file) {
-      std::cerr << "ERROR: wrong initial state file\n";
+  if (vm.count("icache")) {
+    detail_config.icache = rv32i_sim::CacheConfig::parse(icache_config);
+    if (!detail_config.icache) {
+      std::cerr << "ERROR: wrong icache config <" << icache_config << ">\n";
       return 1;
     }
+  }
 
-    model.init(model_state_file);
-    if (vm.count("pc")) model.setPC(pc_init);
+  if (vm.count("dcache")) {
+    detail_config.dcache = rv32i_sim::CacheConfig::parse(dcache_config);
+    if (!detail_config.dcache) {
+      std::cerr << "ERROR: wrong dcache config <" << dcache_config << ">\n";
+      return 1;
+    }
+  }
 
-  } else if (vm.count("imem") && vm.count("iregs") && vm.count("pc")) {
-    std::ifstream imem_file{imem};
-    if (!imem_file) {
-      std::cerr << "ERROR: wrong initial memory file\n";
+  if (vm.count("bpred")) {
+    auto kind = rv32i_sim::BPredConfig::parseKind(bpred_kind);
+    if (!kind) {
+      std::cerr << "ERROR: unknown branch predictor <" << bpred_kind << ">\n";
       return 1;
     }
 
-    std::ifstream iregs_file{iregs};
-    if (!iregs_file) {
-      std::cerr << "ERROR: wrong initial regs file\n";
+    if (bpred_bits == 0 || bpred_bits > 24) {
+      std::cerr << "ERROR: predictor table bits must be in [1, 24]\n";
       return 1;
     }
 
-    rv32i_sim::MemoryModel memory = rv32i_sim::MemoryModel::fromBstate(imem_file);
-    rv32i_sim::RegisterFile regs = rv32i_sim::RegisterFile::fromBstate(iregs_file);
+    detail_config.bpred = rv32i_sim::BPredConfig {};
+    detail_config.bpred->kind = *kind;
+    detail_config.bpred->table_bits = bpred_bits;
+  }
+
+  if (vm.count("timing")) {
+    if (pipeline_config.mem_latency == 0) {
+      std::cerr << "ERROR: memory latency must be positive\n";
+      return 1;
+    }
 
-    model.init(std::move(memory), std::move(regs), pc_init);
+    detail_config.pipeline = pipeline_config;
   }
 
-  if (!model.isValid()) {
-    std::cerr << "Error: model invalid, cannot execute\n";
-    return 1;
+  if (vm.count("replay")) {
+    auto manifest = rv32i_sim::CheckpointManifest::load(replay_dir);
+    if (!manifest) return 1;
+
+    rv32i_sim::IntervalReplay replay{replay_dir, *manifest, detail_config};
+    replay.run(jobs);
+
+    // every job captures guest output on its own, it is written in interval order
+    for (auto&& result : replay.getResults()) {
+      std::cout << result.guest_stdout;
+      std::cerr << result.guest_stderr;
+    }
+
+    replay.report(std::cout);
+
+    if (auto merged = replay.mergedICache())
+      merged->getCache().report(std::cout, "L1I", replay.nInsns());
+
+    if (auto merged = replay.mergedDCache())
+      merged->getCache().report(std::cout, "L1D", replay.nInsns());
+
+    if (auto merged = replay.mergedBPred())
+      merged->report(std::cout, rv32i_sim::SymbolTable {}, bpred_top);
+
+    if (auto merged = replay.mergedPipeline())
+      merged->report(std::cout);
+
+    if (!replay.allMatch()) {
+      std::cerr << "ERROR: replayed intervals do not match checkpoints\n";
+      return 1;
+    }
+
+    return 0;
   }
 
-  model.execute();
+  // the same run on either model, each of them is a separate engine with
+  // memory checks compiled in or out
+  auto simulate = [&](auto& model) -> int {
+    using Model = std::remove_reference_t<decltype(model)>;
+
+    if (vm.count("elf")) {
+
+      model = Model(elf_path);
+
+    } else if (vm.count("istate")) {
+      std::ifstream model_state_file{istate};
+      if (!model_state_file) {
+        std::cerr << "ERROR: wrong initial state file\n";
+        return 1;
+      }
+
+      model.init(model_state_file);
+      if (vm.count("pc")) model.setPC(pc_init);
+
+    } else if (vm.count("imem") && vm.count("iregs") && vm.count("pc")) {
+      std::ifstream imem_file{imem};
+      if (!imem_file) {
+        std::cerr << "ERROR: wrong initial memory file\n";
+        return 1;
+      }
+
+      std::ifstream iregs_file{iregs};
+      if (!iregs_file) {
+        std::cerr << "ERROR: wrong initial regs file\n";
+        return 1;
+      }
+
+      rv32i_sim::MemoryModel memory = rv32i_sim::MemoryModel::fromBstate(imem_file);
+      rv32i_sim::RegisterFile regs = rv32i_sim::RegisterFile::fromBstate(iregs_file);
+
+      model.init(std::move(memory), std::move(regs), pc_init);
+    }
+
+    if (!model.isValid()) {
+      std::cerr << "Error: model invalid, cannot execute\n";
+      return 1;
+    }
+
+    rv32i_sim::ExecEnv& env = model.getEnv();
+    env.setOutputConfig(output_config);
+
+    if (vm.count("guest-stdout")) {
+      auto output = rv32i_sim::GuestOutput::toFile(guest_stdout, output_config);
+      if (!output) return 1;
+      env.setOutput(1, std::move(*output));
+    }
+
+    if (vm.count("guest-stderr")) {
+      auto output = rv32i_sim::GuestOutput::toFile(guest_stderr, output_config);
+      if (!output) return 1;
+      env.setOutput(2, std::move(*output));
+    }
+
+    // devices live as long as the run, model does not own them
+    std::unique_ptr<rv32i_sim::Uart> uart;
+    std::unique_ptr<rv32i_sim::Clint> clint;
+    std::unique_ptr<rv32i_sim::Syscon> syscon;
+    if (vm.count("devices")) {
+      uart = std::make_unique<rv32i_sim::Uart>(env);
+      clint = std::make_unique<rv32i_sim::Clint>([&model] { return model.getInstret(); });
+      syscon = std::make_unique<rv32i_sim::Syscon>([&model](auto status) {
+        if (status) model.exit(*status);
+        else model.exit();
+      });
+
+      if (!model.attachDevice(rv32i_sim::UART_BASE, rv32i_sim::UART_SIZE, uart.get()) ||
+          !model.attachDevice(rv32i_sim::CLINT_BASE, rv32i_sim::CLINT_SIZE, clint.get()) ||
+          !model.attachDevice(rv32i_sim::SYSCON_BASE, rv32i_sim::SYSCON_SIZE, syscon.get()))
+        return 1;
+
+      // CLINT raises machine timer and software interrupts of the hart
+      clint->connect(&model.getEvents(),
+        [&model](bool pending) { model.setInterruptPending(rv32i_sim::MIP_MTIP, pending); },
+        [&model](bool pending) { model.setInterruptPending(rv32i_sim::MIP_MSIP, pending); });
+    }
 
-  if (vm.count("ostate")) {
-    std::ofstream model_state_file{ostate};
-    if (!model_state_file) {
-      std::cerr << "ERROR: wrong ostate file\n";
+    // observers which are enabled only in detailed mode
+    std::vector<rv32i_sim::IExecObserver*> detailed;
+
+    std::unique_ptr<rv32i_sim::SamplingProfiler> profiler;
+    if (vm.count("profile")) {
+      rv32i_sim::ProfileMode mode = rv32i_sim::ProfileMode::INSN;
+      uint64_t period = rv32i_sim::DEFAULT_PROFILE_INSN_PERIOD;
+
+      if (profile_mode == "timer") {
+        mode = rv32i_sim::ProfileMode::TIMER;
+        period = rv32i_sim::DEFAULT_PROFILE_TIMER_PERIOD;
+      } else if (profile_mode != "insn") {
+        std::cerr << "ERROR: unknown profile mode <" << profile_mode << ">\n";
+        return 1;
+      }
+
+      if (vm.count("profile-period")) period = profile_period;
+      if (period == 0) {
+        std::cerr << "ERROR: profile period must be positive\n";
+        return 1;
+      }
+
+      profiler = std::make_unique<rv32i_sim::SamplingProfiler>(mode, period);
+      detailed.push_back(profiler.get());
+    }
+
+    std::unique_ptr<rv32i_sim::CallStackProfiler> callstack;
+    if (vm.count("callstack") || vm.count("callgrind-out")) {
+      callstack = std::make_unique<rv32i_sim::CallStackProfiler>(model.getSymbols());
+      detailed.push_back(callstack.get());
+    }
+
+    std::unique_ptr<rv32i_sim::ICacheObserver> icache;
+    if (detail_config.icache) {
+      icache = std::make_unique<rv32i_sim::ICacheObserver>(*detail_config.icache);
+      detailed.push_back(icache.get());
+    }
+
+    std::unique_ptr<rv32i_sim::DCacheObserver> dcache;
+    if (detail_config.dcache)
+      dcache = std::make_unique<rv32i_sim::DCacheObserver>(*detail_config.dcache);
+
+    std::unique_ptr<rv32i_sim::BranchPredictor> bpred;
+    if (detail_config.bpred) {
+      bpred = std::make_unique<rv32i_sim::BranchPredictor>(*detail_config.bpred);
+      detailed.push_back(bpred.get());
+    }
+
+    std::unique_ptr<rv32i_sim::PipelineModel> pipeline;
+    if (detail_config.pipeline) {
+      pipeline = std::make_unique<rv32i_sim::PipelineModel>(*detail_config.pipeline);
+      detailed.push_back(pipeline.get());
+    }
+
+    std::optional<rv32i_sim::addr_t> fast_forward_pc;
+    if (vm.count("fast-forward-to")) {
+      const rv32i_sim::Symbol* sym = model.getSymbols().find(fast_forward_sym);
+      if (!sym) {
+        std::cerr << "ERROR: no symbol <" << fast_forward_sym << "> to fast-forward to\n";
+        return 1;
+      }
+
+      fast_forward_pc = sym->addr;
+    }
+
+    if (interval_len == 0) {
+      std::cerr << "ERROR: interval must be positive\n";
       return 1;
     }
 
-    model.binaryDump(model_state_file);
+    std::set<uint64_t> checkpoint_at;
+    std::istringstream checkpoint_stream{checkpoint_list};
+    for (std::string idx; std::getline(checkpoint_stream, idx, ','); ) {
+      uint64_t interval = 0;
+      const char* end = idx.data() + idx.size();
+      auto [ptr, ec] = std::from_chars(idx.data(), end, interval);
+      if (idx.empty() || ec != std::errc{} || ptr != end) {
+        std::cerr << "ERROR: wrong checkpoint interval <" << idx << ">\n";
+        return 1;
+      }
+
+      checkpoint_at.insert(interval);
+    }
+
+    rv32i_sim::CheckpointManifest manifest;
+    manifest.interval_len = interval_len;
+
+    auto takeCheckpoint = [&](uint64_t interval) {
+      if (!checkpoint_at.count(interval)) return true;
+
+      rv32i_sim::Checkpoint ckpt {interval, model.getInstret(), model.getCycle(),
+                                  rv32i_sim::CheckpointManifest::bstateName(interval)};
+
+      if (!model.saveCheckpoint(checkpoint_dir / ckpt.path)) return false;
+      manifest.checkpoints.push_back(ckpt);
+      return true;
+    };
+
+    std::unique_ptr<rv32i_sim::BBVProfiler> bbv;
+    std::ofstream bbv_file;
+    if (vm.count("bbv")) {
+      bbv_file.open(bbv_path);
+      if (!bbv_file) {
+        std::cerr << "ERROR: wrong bbv output file\n";
+        return 1;
+      }
+
+      bbv = std::make_unique<rv32i_sim::BBVProfiler>();
+      model.addObserver(bbv.get());
+    }
+
+    bool by_intervals = bbv || !checkpoint_at.empty();
+    if (!takeCheckpoint(0)) return 1;
+
+    // with intervals every run is cut at their boundaries,
+    // where vectors are written out and checkpoints are taken
+    auto runTo = [&](uint64_t limit,
+                     std::optional<rv32i_sim::addr_t> break_pc = std::nullopt) {
+      if (!by_intervals) return model.run(limit, break_pc);
+
+      bool running = true;
+      while (running && model.getInstret() < limit) {
+        uint64_t boundary = (model.getInstret() / interval_len + 1) * interval_len;
+        running = model.run(std::min(limit, boundary), break_pc);
+
+        if (model.getInstret() == boundary) {
+          if (bbv) bbv->endInterval(bbv_file);
+          if (!takeCheckpoint(boundary / interval_len)) return false;
+        }
+
+        if (break_pc && model.getPC() == *break_pc) break;
+      }
+
+      return running;
+    };
+
+    auto setDetailed = [&](bool on) {
+      for (auto* observer : detailed) {
+        if (on) model.addObserver(observer);
+        else model.removeObserver(observer);
+      }
+
+      model.setMemObserver(on ? dcache.get() : nullptr);
+      model.setTrace(on);
+    };
+
+    constexpr uint64_t NO_LIMIT = std::numeric_limits<uint64_t>::max();
+    bool running = true;
+
+    // fast functional mode up to the region of interest
+    if (vm.count("fast-forward") || fast_forward_pc) {
+      setDetailed(false);
+      running = runTo(vm.count("fast-forward") ? fast_forward_insns : NO_LIMIT,
+                      fast_forward_pc);
+    }
+
+    uint64_t detailed_begin = model.getInstret();
+    setDetailed(true);
+    if (running)
+      running = runTo(vm.count("detail-window") ? detailed_begin + detail_window : NO_LIMIT);
+
+    uint64_t detailed_insns = model.getInstret() - detailed_begin;
+    setDetailed(false);
+
+    // back to fast mode for the rest
+    if (running) runTo(NO_LIMIT);
+
+    // guest output goes before reports
+    env.flush();
+
+    if (bbv) {
+      model.removeObserver(bbv.get());
+      if (!bbv->intervalEmpty()) bbv->endInterval(bbv_file);
+    }
+
+    if (!checkpoint_at.empty() && !manifest.save(checkpoint_dir)) return 1;
+
+    if (vm.count("fast-forward") || fast_forward_pc || vm.count("detail-window")) {
+      std::cout << "Detailed window: " << detailed_insns << " insns starting at insn "
+                << detailed_begin << ", " << model.getInstret() << " insns total\n";
+    }
+
+    if (profiler) {
+      profiler->report(std::cout, model.getSymbols(), profile_top);
+    }
+
+    if (callstack) {
+      callstack->report(std::cout);
+    }
+
+    if (icache) {
+      icache->getCache().report(std::cout, "L1I", detailed_insns);
+    }
+
+    if (dcache) {
+      dcache->getCache().report(std::cout, "L1D", detailed_insns);
+    }
+
+    if (bpred) {
+      bpred->report(std::cout, model.getSymbols(), bpred_top);
+    }
+
+    if (pipeline) {
+      pipeline->report(std::cout);
+    }
+
+    if (vm.count("callgrind-out")) {
+      std::ofstream callgrind_file{callgrind_path};
+      if (!callgrind_file) {
+        std::cerr << "ERROR: wrong callgrind output file\n";
+        return 1;
+      }
+
+      callstack->dumpCallgrind(callgrind_file);
+    }
+
+    if (vm.count("ostate")) {
+      std::ofstream model_state_file{ostate};
+      if (!model_state_file) {
+        std::cerr << "ERROR: wrong ostate file\n";
+        return 1;
+      }
+
+      model.binaryDump(model_state_file);
+    }
+
+    // status of the guest program, as if it was run natively
+    return model.getExitCode().value_or(0);
+  };
+
+  if (mem_check == "none") {
+    rv32i_sim::BasicRVModel<rv32i_sim::UncheckedMem> model{};
+    return simulate(model);
+  }
+
+  if (mem_check == "trap") {
+    rv32i_sim::BasicRVModel<rv32i_sim::CheckedMem> model{};
+    return simulate(model);
+  }
+
+  if (mem_check == "host") {
+    rv32i_sim::BasicRVModel<rv32i_sim::HostMem> model{};
+    return simulate(model);
   }
 
-  return 0;
+  rv32i_sim::BasicRVModel<rv32i_sim::DiagMem> model{};
+  return simulate(model);
 }
@@ -1,11 +1,20 @@
 #include "memory.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <bit>
+#include <cstring>
 #include <fstream>
 #include <filesystem>
 #include <iostream>
 #include <string>
+#include <utility>
+
+#include <map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 namespace elf = ELFIO;
 
@@ -19,27 +28,28 @@ static uint32_t fileBytesLeft(std::ifstream& file) {
   return end_pos - curr_pos;
 }
 
-/// @brief resize vector to make its size % align == 0
-/// @return number of new elements inserted
-template <typename T>
-static uint32_t alignAs(std::vector<T>& vec, uint32_t align) {
+/// @brief resize vector (or HostMemory) to make its size % align == 0,
+///        an aligned one still grows by align
+/// @return new size
+template <typename Vec>
+static uint32_t alignAs(Vec& vec, uint32_t align) {
   uint32_t vec_size = vec.size();
-  if (vec_size % align) return 0;
-
-  uint32_t new_size = vec_size + (align - vec_size % align);
+  uint32_t new_size = vec_size - vec_size % align + align;
   vec.resize(new_size);
   return new_size;
 }
 
 namespace rv32i_sim {
 
+// RV32 model runs ELFCLASS32 files only, RV64 one - ELFCLASS64 only
 ELFError checkELF(elf::elfio& elf_reader) {
   addr_t elf_class = elf_reader.get_class();
   addr_t elf_encoding = elf_reader.get_encoding();
+  constexpr addr_t expected_class = XLEN == 64 ? elf::ELFCLASS64 : elf::ELFCLASS32;
 
-  if (elf_class != elf::ELFCLASS32) {
+  if (elf_class != expected_class) {
     std::cerr << "ERROR: wrong ELF class: " << elf_class
-              << "(" << elf::ELFCLASS32 << " expected)\n";
+              << "(" << expected_class << " expected)\n";
 
     return ELFError::CLASS;
   }
@@ -53,6 +63,15 @@ ELFError checkELF(elf::elfio& elf_reader) {
   return ELFError::OK;
 }
 
+static uint8_t rightsFromELF(elf::Elf_Word flags) {
+  uint8_t rights = 0;
+  if (flags & elf::PF_R) rights |= RIGHTS_R;
+  if (flags & elf::PF_W) rights |= RIGHTS_W;
+  if (flags & elf::PF_X) rights |= RIGHTS_X;
+
+  return rights;
+}
+
 ELFError checkELF(std::filesystem::path& elf_path) {
   elf::elfio elf_reader;
   if (!elf_reader.load(elf_path)) {
@@ -64,38 +83,28 @@ ELFError checkELF(std::filesystem::path& elf_path) {
   return checkELF(elf_reader);
 }
 
-MemoryModel MemoryModel::fromELF(elf::elfio& elf_reader) {
+/// @brief lay out PT_LOAD segments of ELF in memory
+/// @param load_data puts file part of segment in place: (memory, segment, size)
+///
+/// memory is grown once up to the end of the last segment before any data
+/// is loaded, new memory is zero, so .bss is never written
+template <typename LoadData>
+static MemoryModel loadSegments(elf::elfio& elf_reader, std::size_t capacity,
+                                std::size_t tail, LoadData load_data) {
   if(checkELF(elf_reader) != ELFError::OK) { return MemoryModel(false); }
 
-  uint32_t seg_vaddr = 0;
-  uint32_t seg_memsz = 0;
-  uint32_t seg_filesz = 0;
-  uint32_t seg_rights = 0;
-  uint32_t seg_align = 0;
-
-  std::vector<byte_t> memory (DEFAULT_ADDR_SPACE);
+  std::size_t memory_size = DEFAULT_ADDR_SPACE;
   std::vector<Segment> segments;
 
-  auto seg = elf_reader.segments.begin();
-  auto seg_end = elf_reader.segments.end();
-  for ( ; seg != seg_end; ++seg) {
-    seg_vaddr = seg->get()->get_virtual_address();
-    seg_memsz = seg->get()->get_memory_size();
-    seg_filesz = seg->get()->get_file_size();
-    seg_rights = seg->get()->get_flags();
-    seg_align = seg->get()->get_align();
-
-    // resize if required
-    if (memory.size() < seg_vaddr + seg_memsz)
-      memory.resize(seg_vaddr + seg_memsz);
-
-    // handle .bss section
-    if (seg_memsz > seg_filesz) {
-      std::memcpy(memory.data() + seg_vaddr, seg->get()->get_data(), seg_filesz);
-      std::memset(memory.data() + seg_vaddr + seg_filesz, 0x00, seg_memsz - seg_filesz);
-    } else {
-      std::memcpy(memory.data() + seg_vaddr, seg->get()->get_data(), seg_memsz);
-    }
+  for (auto&& seg : elf_reader.segments) {
+    if (seg->get_type() != elf::PT_LOAD) continue;
+
+    addr_t seg_vaddr = seg->get_virtual_address();
+    addr_t seg_memsz = seg->get_memory_size();
+    uint8_t seg_rights = rightsFromELF(seg->get_flags());
+    uint32_t seg_align = seg->get_align();
+
+    memory_size = std::max<std::size_t>(memory_size, seg_vaddr + seg_memsz);
 
     // create a segment for loaded data
     segments.push_back(
@@ -103,12 +112,55 @@ MemoryModel MemoryModel::fromELF(elf::elfio& elf_reader) {
     );
   }
 
-  return MemoryModel(memory, segments, true);
+  HostMemory memory;
+  memory.reserve(std::max(capacity, memory_size + tail));
+  memory.resize(memory_size);
+
+  for (auto&& seg : elf_reader.segments) {
+    if (seg->get_type() != elf::PT_LOAD) continue;
+
+    addr_t seg_size = std::min(seg->get_file_size(), seg->get_memory_size());
+    if (seg_size && !load_data(memory, *seg, seg_size)) return MemoryModel(false);
+  }
+
+  return MemoryModel(std::move(memory), segments, true);
+}
+
+MemoryModel MemoryModel::fromELF(elf::elfio& elf_reader) {
+  return loadSegments(elf_reader, 0, 0, [](HostMemory& memory, const elf::segment& seg,
+                                     addr_t size) {
+    std::memcpy(memory.data() + seg.get_virtual_address(), seg.get_data(), size);
+    return true;
+  });
+}
+
+MemoryModel MemoryModel::fromELF(elf::elfio& elf_reader,
+                                 const std::filesystem::path& elf_path,
+                                 std::size_t capacity, std::size_t tail) {
+  int fd = open(elf_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::cerr << "ERROR: failed to open ELF " << elf_path << "\n";
+    return MemoryModel(false);
+  }
+
+  // mappings stay alive after the file is closed
+  MemoryModel memory = loadSegments(elf_reader, capacity, tail, [fd, &elf_path](
+                                        HostMemory& memory, const elf::segment& seg,
+                                        addr_t size) {
+    if (memory.mapFile(fd, seg.get_offset(), seg.get_virtual_address(), size)) return true;
+
+    std::cerr << "ERROR: failed to load segment at " << seg.get_virtual_address()
+              << " from ELF " << elf_path << "\n";
+    return false;
+  });
+
+  close(fd);
+  return memory;
 }
 
 MemoryModel MemoryModel::fromELF(std::filesystem::path& elf_path) {
   elf::elfio elf_reader;
-  if (!elf_reader.load(elf_path)) {
+  if (!elf_reader.load(elf_path, true)) { // segment data is not read, it is mapped
     std::cerr << "ERROR: failed to load ELF " << elf_path << "\n";
 
     return MemoryModel(false);
@@ -116,7 +168,7 @@ MemoryModel MemoryModel::fromELF(std::filesystem::path& elf_path) {
 
   if(checkELF(elf_reader) != ELFError::OK) { return MemoryModel(false); }
 
-  return MemoryModel::fromELF(elf_reader);
+  return MemoryModel::fromELF(elf_reader, elf_path);
 }
 
 MemoryModel MemoryModel::fromBstate(std::filesystem::path& mem_path) {
@@ -147,7 +199,7 @@ MemoryModel MemoryModel::fromBstate(std::ifstream& mem_file) {
   uint32_t file_size = static_cast<uint32_t>(fileBytesLeft(mem_file));
   uint32_t memory_size = file_size > DEFAULT_ADDR_SPACE ? file_size :
                                                               DEFAULT_ADDR_SPACE;
-  std::vector<byte_t> memory(memory_size);
+  HostMemory memory(memory_size);
   mem_file.read(std::bit_cast<char *>(memory.data()), file_size);
 
   memory_size = alignAs(memory, DEFAULT_ALIGN);
@@ -170,28 +222,38 @@ MemoryModel MemoryModel::fromBstate(std::ifstream& mem_file) {
 
 // sets up stack segment of size = stack_size with canary at the top
 // returns address where initial sp is placed - the bottom of the segment
-addr_t MemoryModel::setUpStack(uint32_t stack_size) {
+addr_t MemoryModel::setUpStack(uint32_t stack_size, bool page_canaries) {
   assert(stack_size < MAX_STACK_SIZE && "Stack size is too big!");
+  assert(!heap_seg_ && "Heap must be the last segment");
 
   // stack resides at the bottom of the address space
   // and is protected by a canary segment from both sides
-  addr_t canary_top_vaddr = alignAs(mem_, DEFAULT_ALIGN);
-  addr_t stack_vaddr = canary_top_vaddr + DEFAULT_CANARY_SIZE;
+  addr_t canary_size = DEFAULT_CANARY_SIZE;
+  addr_t canary_top_vaddr = 0;
+  if (page_canaries) {
+    canary_size = HostMemory::pageSize();
+    stack_size = (stack_size + canary_size - 1) / canary_size * canary_size;
+    canary_top_vaddr = (mem_.size() + canary_size - 1) / canary_size * canary_size;
+    mem_.resize(canary_top_vaddr);
+  } else {
+    canary_top_vaddr = alignAs(mem_, DEFAULT_ALIGN);
+  }
+
+  addr_t stack_vaddr = canary_top_vaddr + canary_size;
   Segment stack {
     stack_vaddr,
     stack_size,
     RIGHTS_R | RIGHTS_W,
   };
 
-  mem_.resize(mem_.size() + 2 * DEFAULT_CANARY_SIZE + stack_size);
-  std::memset(mem_.data() + canary_top_vaddr, STACK_CANARY_BYTE, DEFAULT_CANARY_SIZE);
-  std::memset(mem_.data() + stack_vaddr + stack_size,
-                                              STACK_CANARY_BYTE, DEFAULT_CANARY_SIZE);
+  mem_.resize(mem_.size() + 2 * canary_size + stack_size);
+  std::memset(mem_.data() + canary_top_vaddr, STACK_CANARY_BYTE, canary_size);
+  std::memset(mem_.data() + stack_vaddr + stack_size, STACK_CANARY_BYTE, canary_size);
 
-  Segment canary_top {canary_top_vaddr, DEFAULT_CANARY_SIZE, 0 /* access forbidden */};
+  Segment canary_top {canary_top_vaddr, canary_size, 0 /* access forbidden */};
   Segment canary_bottom {
-    canary_top_vaddr + DEFAULT_CANARY_SIZE + stack_size,
-    DEFAULT_CANARY_SIZE,
+    canary_top_vaddr + canary_size + stack_size,
+    canary_size,
     0 // access forbidden
   };
 
@@ -202,7 +264,16 @@ addr_t MemoryModel::setUpStack(uint32_t stack_size) {
   return stack_vaddr + stack_size - sizeof(addr_t);
 }
 
+// image end and stack are rounded up to canaries, environment and heap are aligned
+std::size_t MemoryModel::tailSize(uint32_t stack_size, bool page_canaries, addr_t heap_size) {
+  std::size_t canary_size = page_canaries ? HostMemory::pageSize() : DEFAULT_CANARY_SIZE;
+
+  return 4 * canary_size + stack_size + 2 * DEFAULT_ALIGN + ENV_SEG_SIZE + heap_size;
+}
+
 addr_t MemoryModel::pushSegment(addr_t size, uint8_t rights, uint8_t align) {
+  assert(!heap_seg_ && "Heap must be the last segment");
+
   addr_t seg_vaddr = alignAs(mem_, align);
 
   if (mem_.size() < seg_vaddr + size)
@@ -223,6 +294,7 @@ addr_t MemoryModel::pushSegment(addr_t size, uint8_t rights, uint8_t align) {
 }
 
 addr_t MemoryModel::pushSegment(Segment seg) {
+  assert(!heap_seg_ && "Heap must be the last segment");
   assert(seg.getVaddr() >= mem_.size() && "New segment cannot overlap the existing one");
 
   addr_t max_addr = seg.getVaddr() + seg.getSize();
@@ -235,14 +307,188 @@ addr_t MemoryModel::pushSegment(Segment seg) {
   return max_addr;
 }
 
-bool MemoryModel::checkRights(addr_t addr, uint8_t rights) const {
-  for (auto seg : segments_) {
+addr_t MemoryModel::setUpHeap(addr_t max_size) {
+  assert(!heap_seg_ && "Heap has already been set up");
+
+  brk_ = pushSegment(0, RIGHTS_R | RIGHTS_W, DEFAULT_ALIGN);
+  heap_seg_ = segments_.size() - 1;
+  heap_limit_ = brk_ + max_size;
+
+  // only address range is reserved, host pages are not touched until used
+  mem_.reserve(heap_limit_);
+
+  return brk_;
+}
+
+// heap ends where memory ends: growing resizes memory within its capacity
+// (new bytes are zeroed), shrinking drops the tail, so it is zero next time
+addr_t MemoryModel::setBrk(addr_t brk) {
+  if (!heap_seg_) return brk_;
+
+  Segment& heap = segments_[*heap_seg_];
+  addr_t heap_start = heap.getVaddr();
+  if (brk < heap_start || brk > heap_limit_) return brk_;
+
+  // resize zeroes pages which may be protected
+  if (protected_) mem_.protect(0, mem_.capacity(), PROT_READ | PROT_WRITE);
+
+  // copies of memory do not keep capacity, reserve again once
+  if (mem_.capacity() < heap_limit_) mem_.reserve(heap_limit_);
+
+  mem_.resize(brk);
+  heap.setSize(brk - heap_start);
+  brk_ = brk;
+
+  if (protected_) applyProtection();
+
+  return brk_;
+}
+
+bool MemoryModel::setLayout(std::vector<Segment> segments, std::optional<addr_t> heap_limit) {
+  addr_t end = 0;
+  for (auto&& seg : segments) end = std::max(end, seg.getVaddr() + seg.getSize());
+  if (end > mem_.size() || (heap_limit && (segments.empty() || *heap_limit < end)))
+    return false;
+
+  segments_ = std::move(segments);
+  heap_seg_ = std::nullopt;
+  heap_limit_ = 0;
+  brk_ = 0;
+
+  if (heap_limit) {
+    const Segment& heap = segments_.back();
+    heap_seg_ = segments_.size() - 1;
+    heap_limit_ = *heap_limit;
+    brk_ = heap.getVaddr() + heap.getSize();
+
+    mem_.resize(brk_);
+    mem_.reserve(heap_limit_);
+  }
+
+  if (protected_) applyProtection();
+
+  return true;
+}
+
+void MemoryModel::protect(bool on) {
+  if (on == protected_) return;
+
+  protected_ = on;
+  if (!on) {
+    mem_.protect(0, mem_.capacity(), PROT_READ | PROT_WRITE);
+    return;
+  }
+
+  // pages past memory must fault too, whatever address guest computes
+  if (mem_.capacity() < HOST_MMU_WINDOW) mem_.reserve(HOST_MMU_WINDOW);
+  applyProtection();
+}
+
+// fetch reads code as data, so X is R for host
+void MemoryModel::applyProtection() {
+  auto hostProt = [](uint8_t rights) {
+    if (rights & RIGHTS_W) return PROT_READ | PROT_WRITE;
+    return rights ? PROT_READ : PROT_NONE;
+  };
+
+  std::size_t page = HostMemory::pageSize();
+  bool ok = mem_.protect(0, mem_.capacity(), PROT_NONE);
+
+  // pages holding ends of segments, all of their rights are merged
+  std::map<std::size_t, uint8_t> shared;
+
+  for (auto&& seg : segments_) {
+    std::size_t begin = seg.getVaddr();
+    std::size_t end = std::min<std::size_t>(begin + seg.getSize(), mem_.size());
+    if (begin >= end) continue;
+
+    std::size_t inner_begin = (begin + page - 1) / page * page;
+    std::size_t inner_end = end / page * page;
+    if (inner_begin < inner_end)
+      ok &= mem_.protect(inner_begin, inner_end - inner_begin, hostProt(seg.getRights()));
+
+    if (begin % page) shared[begin / page * page] |= seg.getRights();
+    if (end % page) shared[end / page * page] |= seg.getRights();
+  }
+
+  for (auto [page_addr, rights] : shared)
+    ok &= mem_.protect(page_addr, page, hostProt(rights));
+
+  if (!ok) std::cerr << "ERROR: failed to protect guest memory pages\n";
+}
+
+std::optional<addr_t> MemoryModel::guestAddr(const void* host_ptr) const {
+  if (!mem_.contains(host_ptr)) return std::nullopt;
+  return static_cast<const byte_t*>(host_ptr) - mem_.data();
+}
+
+const Segment* MemoryModel::findSegment(addr_t addr) const {
+  for (auto&& seg : segments_) {
     if (seg.getVaddr() <= addr && addr < seg.getVaddr() + seg.getSize()) {
-      return seg.checkRights(rights);
+      return &seg;
     }
   }
 
-  return false;
+  return nullptr;
+}
+
+bool MemoryModel::checkRights(addr_t addr, uint8_t rights) const {
+  const Segment* seg = findSegment(addr);
+  return seg && seg->checkRights(rights);
+}
+
+bool MemoryModel::checkRange(addr_t addr, addr_t size, uint8_t rights) const {
+  if (size == 0) return true;
+
+  const Segment* seg = findSegment(addr);
+  if (!seg || !seg->checkRights(rights)) return false;
+
+  // offset from segment start, so that addr + size cannot overflow
+  addr_t offset = addr - seg->getVaddr();
+  return size <= seg->getSize() - offset && addr + size <= mem_.size();
+}
+
+MemCheck MemoryModel::checkAccess(addr_t addr, addr_t size, uint8_t rights) const {
+  if (addr % size != 0) return MemCheck::ALIGN;
+
+  if (bus_.isDevicePage(addr)) [[unlikely]]
+    return rights & RIGHTS_X ? MemCheck::RIGHTS : MemCheck::OK;
+
+  const Segment* seg = findSegment(addr);
+  if (!seg || addr >= mem_.size()) return MemCheck::BOUNDS;
+
+  // offsets from segment start and memory end, so that addr + size cannot overflow
+  addr_t offset = addr - seg->getVaddr();
+  if (size > seg->getSize() - offset || size > mem_.size() - addr) return MemCheck::BOUNDS;
+
+  if (!seg->checkRights(rights)) return MemCheck::RIGHTS;
+
+  return MemCheck::OK;
+}
+
+byte_t* MemoryModel::hostPtr(addr_t addr, addr_t size, uint8_t rights) {
+  if (!checkRange(addr, size, rights)) return nullptr;
+
+  return mem_.data() + (size ? addr : 0);
+}
+
+bool MemoryModel::readString(addr_t addr, addr_t max_len, std::string& str) const {
+  const Segment* seg = findSegment(addr);
+  if (!seg || !seg->checkRights(RIGHTS_R)) return false;
+
+  addr_t seg_end = std::min<addr_t>(seg->getVaddr() + seg->getSize(), mem_.size());
+  addr_t len = std::min(max_len, seg_end - addr);
+
+  const char* begin = reinterpret_cast<const char *>(mem_.data() + addr);
+  const char* end = static_cast<const char *>(std::memchr(begin, '\0', len));
+  if (!end) return false;
+
+  str.assign(begin, end);
+  return true;
+}
+
+void MemoryModel::setObserver(IMemObserver* observer) {
+  observer_ = observer;
 }
 
 bool MemoryModel::isValid() const {
@@ -286,16 +532,20 @@ void MemoryModel::set(addr_t addr, uint8_t val, uint32_t n) {
 }
 
 byte_t MemoryModel::readByte(addr_t addr) const {
-  assert(checkRights(addr, RIGHTS_R) && "No rights to read");
-  assert(addr % sizeof(addr_t) == 0 && "Address not aligned");
-  assert(addr < mem_.size() && "Address must be within bounds of loaded memory");
+  if (bus_.isDevicePage(addr)) [[unlikely]] return bus_.read(addr, sizeof(byte_t));
+
+  notify(addr, sizeof(byte_t), MemAccess::READ);
   return mem_[addr];
 }
 
 half_t MemoryModel::readHalf(addr_t addr) const {
-  assert(checkRights(addr, RIGHTS_R) && "No rights to read");
-  assert(addr % sizeof(addr_t) == 0 && "Address not aligned");
-  assert(addr < mem_.size() && "Address must be within bounds of loaded memory");
+  if (bus_.isDevicePage(addr)) [[unlikely]] return bus_.read(addr, sizeof(half_t));
+
+  notify(addr, sizeof(half_t), MemAccess::READ);
+  return fetchHalf(addr);
+}
+
+half_t MemoryModel::fetchHalf(addr_t addr) const {
   half_t res = 0;
   for (int i = sizeof(half_t) - 1; i >= 0; --i) {
     res <<= sizeof(byte_t) * BITS_BYTE;
@@ -306,9 +556,13 @@ half_t MemoryModel::readHalf(addr_t addr) const {
 }
 
 word_t MemoryModel::readWord(addr_t addr) const {
-  assert(checkRights(addr, RIGHTS_R) && "No rights to read");
-  assert(addr % sizeof(addr_t) == 0 && "Address not aligned");
-  assert(addr < mem_.size() && "Address must be within bounds of loaded memory");
+  if (bus_.isDevicePage(addr)) [[unlikely]] return bus_.read(addr, sizeof(word_t));
+
+  notify(addr, sizeof(word_t), MemAccess::READ);
+  return fetchWord(addr);
+}
+
+word_t MemoryModel::fetchWord(addr_t addr) const {
   word_t res = 0;
   for (int i = sizeof(word_t) - 1; i >= 0; --i) {
     res <<= sizeof(byte_t) * BITS_BYTE;
@@ -318,15 +572,36 @@ word_t MemoryModel::readWord(addr_t addr) const {
   return res;
 }
 
+dword_t MemoryModel::readDouble(addr_t addr) const {
+  if (bus_.isDevicePage(addr)) [[unlikely]] return bus_.read(addr, sizeof(dword_t));
+
+  notify(addr, sizeof(dword_t), MemAccess::READ);
+  dword_t res = 0;
+  for (int i = sizeof(dword_t) - 1; i >= 0; --i) {
+    res <<= sizeof(byte_t) * BITS_BYTE;
+    res |= dword_t(mem_[addr + i]);
+  }
+
+  return res;
+}
+
 void MemoryModel::writeByte(addr_t addr, byte_t val) {
-  assert(checkRights(addr, RIGHTS_W) && "No rights to write");
-  assert(addr < mem_.size() && "Address must be within bounds of loaded memory");
+  if (bus_.isDevicePage(addr)) [[unlikely]] {
+    bus_.write(addr, sizeof(byte_t), val);
+    return;
+  }
+
+  notify(addr, sizeof(byte_t), MemAccess::WRITE);
   mem_[addr] = val;
 }
 
 void MemoryModel::writeHalf(addr_t addr, half_t val) {
-  assert(checkRights(addr, RIGHTS_W) && "No rights to write");
-  assert(addr < mem_.size() && "Address must be within bounds of loaded memory");
+  if (bus_.isDevicePage(addr)) [[unlikely]] {
+    bus_.write(addr, sizeof(half_t), val);
+    return;
+  }
+
+  notify(addr, sizeof(half_t), MemAccess::WRITE);
   for (int i = 0; i != sizeof(half_t); ++i) {
     byte_t curr = val & 0xFF;
     mem_[addr++] = curr;
@@ -335,8 +610,12 @@ void MemoryModel::writeHalf(addr_t addr, half_t val) {
 }
 
 void MemoryModel::writeWord(addr_t addr, word_t val) {
-  assert(checkRights(addr, RIGHTS_W) && "No rights to write");
-  assert(addr < mem_.size() && "Address must be within bounds of loaded memory");
+  if (bus_.isDevicePage(addr)) [[unlikely]] {
+    bus_.write(addr, sizeof(word_t), val);
+    return;
+  }
+
+  notify(addr, sizeof(word_t), MemAccess::WRITE);
   for (int i = 0; i != sizeof(word_t); ++i) {
     byte_t curr = val & 0xFF;
     mem_[addr++] = curr;
@@ -344,6 +623,20 @@ void MemoryModel::writeWord(addr_t addr, word_t val) {
   }
 }
 
+void MemoryModel::writeDouble(addr_t addr, dword_t val) {
+  if (bus_.isDevicePage(addr)) [[unlikely]] {
+    bus_.write(addr, sizeof(dword_t), val);
+    return;
+  }
+
+  notify(addr, sizeof(dword_t), MemAccess::WRITE);
+  for (int i = 0; i != sizeof(dword_t); ++i) {
+    byte_t curr = val & 0xFF;
+    mem_[addr++] = curr;
+    val >>= BITS_BYTE; // next byte
+  }
+}
+
 void MemoryModel::binaryDump(std::ofstream& fout) const {
   fout.write(RV32I_MEMORY_STATE_SIGNATURE.c_str(),
               RV32I_MEMORY_STATE_SIGNATURE.size() + 1);
@@ -386,4 +679,16 @@ std::ostream& operator<<(std::ostream& out, MemoryModel& memory) {
   return out;
 }
 
+std::ostream& operator<<(std::ostream& out, MemCheck check) {
+  switch (check)
+  {
+  case MemCheck::OK: return out << "ok";
+  case MemCheck::ALIGN: return out << "misaligned";
+  case MemCheck::BOUNDS: return out << "out of bounds";
+  case MemCheck::RIGHTS: return out << "no rights";
+  }
+
+  return out;
+}
+
 } // rv32i_sim
@@ -0,0 +1,138 @@
+#include "pipeline.hpp"
+
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+
+namespace rv32i_sim {
+
+namespace {
+
+struct RegUse {
+  Register rd = Register::X0;
+  Register rs1 = Register::X0;
+  Register rs2 = Register::X0;
+  bool is_load = false;
+  bool is_store = false;
+};
+
+// registers read and written by insn, x0 stands for none
+RegUse regUseOf(addr_t code) {
+  auto rd = static_cast<Register>((code & DEFAULT_RD_MASK) >> 7);
+  auto rs1 = static_cast<Register>((code & DEFAULT_RS1_MASK) >> 15);
+  auto rs2 = static_cast<Register>((code & DEFAULT_RS2_MASK) >> 20);
+
+  switch (code & DEFAULT_OPCODE_MASK)
+  {
+  case RV_R_TYPE_OPCODE:
+  case RV_R32_TYPE_OPCODE:
+    return RegUse {rd, rs1, rs2};
+
+  case RV_I_TYPE_OPCODE:
+  case RV_I32_TYPE_OPCODE:
+  case RV_IJALR_TYPE_OPCODE:
+    return RegUse {rd, rs1};
+
+  case RV_ILOAD_TYPE_OPCODE:
+    return RegUse {rd, rs1, Register::X0, true};
+
+  case RV_S_TYPE_OPCODE:
+    return RegUse {Register::X0, rs1, rs2, false, true};
+
+  // f and v registers are not tracked, only address and memory latency matter
+  case RV_FLOAD_OPCODE:
+    return RegUse {Register::X0, rs1, Register::X0, true};
+
+  case RV_FSTORE_OPCODE:
+    return RegUse {Register::X0, rs1, Register::X0, false, true};
+
+  case RV_B_TYPE_OPCODE:
+    return RegUse {Register::X0, rs1, rs2};
+
+  case RV_U1_TYPE_OPCODE:
+  case RV_U2_TYPE_OPCODE:
+  case RV_JAL_OPCODE:
+    return RegUse {rd};
+
+  case RV_SYSTEM_I_OPCODE:
+    // csr insns with immediate keep uimm in rs1 field
+    return RegUse {rd, (code & (1 << 14)) ? Register::X0 : rs1};
+
+  default:
+    return RegUse {};
+  }
+}
+
+} // namespace
+
+PipelineModel::PipelineModel(const PipelineConfig& config) : config_(config) {
+  assert(config_.mem_latency != 0 && "Memory access takes at least one cycle");
+}
+
+void PipelineModel::onBlock(const BasicBlock& block, addr_t next_pc,
+                                                     uint64_t /* instret */) {
+  for (std::size_t i = 0; i != block.retired(); ++i) {
+    RegUse use = regUseOf(block.insns[i]->getCode());
+
+    if (pending_load_ != Register::X0 &&
+        (use.rs1 == pending_load_ || use.rs2 == pending_load_))
+      ++load_use_stalls_;
+
+    if (use.is_load || use.is_store) mem_stalls_ += config_.mem_latency - 1;
+
+    pending_load_ = use.is_load ? use.rd : Register::X0;
+  }
+
+  insns_ += block.retired();
+
+  addr_t fallthrough = block.end_pc;
+  switch (block.exit)
+  {
+  case BlockExit::BRANCH:
+    if (next_pc != fallthrough) control_stalls_ += config_.branch_penalty;
+    break;
+
+  case BlockExit::JUMP:
+  case BlockExit::CALL:
+  case BlockExit::RETURN: {
+    addr_t opcode = block.insns.back()->getCode() & DEFAULT_OPCODE_MASK;
+    control_stalls_ += opcode == RV_JAL_OPCODE ? config_.jump_penalty
+                                               : config_.branch_penalty;
+    break;
+  }
+
+  default:
+    break;
+  }
+}
+
+void PipelineModel::merge(const PipelineModel& other) {
+  insns_ += other.insns_;
+  load_use_stalls_ += other.load_use_stalls_;
+  mem_stalls_ += other.mem_stalls_;
+  control_stalls_ += other.control_stalls_;
+}
+
+uint64_t PipelineModel::nCycles() const {
+  if (insns_ == 0) return 0;
+
+  return insns_ + (PIPELINE_DEPTH - 1) + load_use_stalls_ + mem_stalls_ + control_stalls_;
+}
+
+double PipelineModel::cpi() const {
+  return insns_ ? static_cast<double>(nCycles()) / insns_ : 0.0;
+}
+
+std::ostream& PipelineModel::report(std::ostream& out) const {
+  out << "Pipeline timing: " << insns_ << " insns, " << nCycles() << " cycles, CPI "
+      << std::fixed << std::setprecision(3) << cpi() << '\n';
+  out.unsetf(std::ios::floatfield);
+
+  out << "stalls: " << load_use_stalls_ << " load-use, "
+      << mem_stalls_ << " memory, "
+      << control_stalls_ << " control\n";
+
+  return out;
+}
+
+} // rv32i_sim
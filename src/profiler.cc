@@ -0,0 +1,130 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <csignal>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <sys/time.h>
+
+// set by SIGPROF handler, consumed at block boundary
+static volatile std::sig_atomic_t timer_fired = 0;
+static bool timer_armed = false;
+
+static void onSigprof(int) {
+  timer_fired = 1;
+}
+
+static void armTimer(uint64_t period_us) {
+  struct sigaction action = {};
+  action.sa_handler = onSigprof;
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_RESTART;
+  sigaction(SIGPROF, &action, nullptr);
+
+  struct itimerval timer = {};
+  timer.it_interval.tv_sec = period_us / 1'000'000;
+  timer.it_interval.tv_usec = period_us % 1'000'000;
+  timer.it_value = timer.it_interval;
+  setitimer(ITIMER_PROF, &timer, nullptr);
+}
+
+static void disarmTimer() {
+  struct itimerval timer = {};
+  setitimer(ITIMER_PROF, &timer, nullptr);
+  signal(SIGPROF, SIG_IGN);
+}
+
+namespace rv32i_sim {
+
+SamplingProfiler::SamplingProfiler(ProfileMode mode, uint64_t period) :
+                              mode_(mode), period_(period), next_sample_(period) {
+  assert(period_ != 0 && "Sampling period must be positive");
+
+  if (mode_ == ProfileMode::TIMER) {
+    assert(!timer_armed && "Only one timer profiler can be active");
+    timer_fired = 0;
+    timer_armed = true;
+    armTimer(period_);
+  }
+}
+
+SamplingProfiler::~SamplingProfiler() {
+  if (mode_ == ProfileMode::TIMER) {
+    disarmTimer();
+    timer_armed = false;
+  }
+}
+
+void SamplingProfiler::record(addr_t pc) {
+  ++samples_[pc];
+  ++n_samples_;
+}
+
+void SamplingProfiler::onBlock(const BasicBlock& block, addr_t /* next_pc */,
+                                                                  uint64_t instret) {
+  if (mode_ == ProfileMode::TIMER) {
+    if (timer_fired) {
+      timer_fired = 0;
+      record(block.start_pc);
+    }
+
+    return;
+  }
+
+  // sample points which fell into this block
+  uint64_t instret_before = instret - block.retired();
+  for ( ; next_sample_ <= instret; next_sample_ += period_) {
+    record(block.insnPC(next_sample_ - instret_before - 1));
+  }
+}
+
+uint64_t SamplingProfiler::nSamples() const {
+  return n_samples_;
+}
+
+const std::unordered_map<addr_t, uint64_t>& SamplingProfiler::getSamples() const {
+  return samples_;
+}
+
+std::ostream& SamplingProfiler::report(std::ostream& out, const SymbolTable& symbols,
+                                                            unsigned top_n) const {
+  std::unordered_map<std::string, uint64_t> by_func;
+  for (auto&& [pc, n] : samples_) {
+    const Symbol* sym = symbols.lookup(pc);
+    if (sym) {
+      by_func[sym->name] += n;
+      continue;
+    }
+
+    std::ostringstream name;
+    name << "0x" << std::hex << pc;
+    by_func[name.str()] += n;
+  }
+
+  std::vector<std::pair<std::string, uint64_t>> funcs(by_func.begin(), by_func.end());
+  std::sort(funcs.begin(), funcs.end(),
+            [](auto&& lhs, auto&& rhs) { return lhs.second > rhs.second; });
+
+  if (funcs.size() > top_n) funcs.resize(top_n);
+
+  out << "Flat profile: " << n_samples_ << " samples, one per " << period_
+      << (mode_ == ProfileMode::INSN ? " insns" : " us of cpu time") << '\n';
+  out << "      %    samples  function\n";
+
+  for (auto&& [name, n] : funcs) {
+    double percent = n_samples_ ? 100.0 * n / n_samples_ : 0.0;
+    out << std::setw(7) << std::fixed << std::setprecision(2) << percent
+        << std::setw(11) << n << "  " << name << '\n';
+  }
+
+  return out;
+}
+
+} // rv32i_sim
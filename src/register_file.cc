@@ -9,7 +9,7 @@
 namespace rv32i_sim {
 
 RegisterFile::RegisterFile(bool valid) : is_valid_(valid) {}
-RegisterFile::RegisterFile(std::vector<addr_t> regs, bool valid) :
+RegisterFile::RegisterFile(std::vector<reg_t> regs, bool valid) :
                                               regs_(regs), is_valid_(valid) {
   if (regs.size() != N_REGS) {
     std::cerr << "WARNING: initial regs state has " << regs.size()
@@ -39,7 +39,7 @@ RegisterFile::RegisterFile(std::ifstream& regs_bstate) {
 
   is_valid_ = true;
 
-  regs_bstate.read(reinterpret_cast<char *>(regs_.data()), sizeof(word_t) * N_REGS);
+  regs_bstate.read(reinterpret_cast<char *>(regs_.data()), sizeof(reg_t) * N_REGS);
 
   validate();
   assert(is_valid_ && "Registers invalid after creation");
@@ -69,14 +69,14 @@ bool RegisterFile::operator==(const RegisterFile& other) const {
   return regs_ == other.regs_;
 }
 
-void RegisterFile::set(Register reg, sword_t val) {
+void RegisterFile::set(Register reg, reg_t val) {
   if (reg == Register::X0) return;
 
   regs_[static_cast<uint8_t>(reg)] = val;
 }
 
-addr_t RegisterFile::get(Register reg) const {
-  assert(static_cast<addr_t>(regs_[0]) == 0 && "Register X0 not zero");
+reg_t RegisterFile::get(Register reg) const {
+  assert(regs_[0] == 0 && "Register X0 not zero");
 
   return regs_[static_cast<uint8_t>(reg)];
 }
@@ -100,7 +100,7 @@ void RegisterFile::binaryDump(std::ofstream& fout) {
   fout.write(RV32I_REGS_STATE_SIGNATURE.c_str(),
               RV32I_REGS_STATE_SIGNATURE.size() + 1);
 
-  fout.write(reinterpret_cast<char *>(regs_.data()), regs_.size() * sizeof(word_t));
+  fout.write(reinterpret_cast<char *>(regs_.data()), regs_.size() * sizeof(reg_t));
 }
 
 std::ostream& operator<<(std::ostream& out, RegisterFile& rf) {
@@ -108,6 +108,48 @@ std::ostream& operator<<(std::ostream& out, RegisterFile& rf) {
   return out;
 }
 
+bool FPRegisterFile::operator==(const FPRegisterFile& other) const {
+  return regs_ == other.regs_ && fflags_ == other.fflags_ && frm_ == other.frm_;
+}
+
+void FPRegisterFile::set(Register reg, word_t val) {
+  assert(isRegValid(reg) && "Invalid f register");
+  regs_[static_cast<uint8_t>(reg)] = val;
+}
+
+word_t FPRegisterFile::get(Register reg) const {
+  assert(isRegValid(reg) && "Invalid f register");
+  return regs_[static_cast<uint8_t>(reg)];
+}
+
+void FPRegisterFile::setFlags(word_t flags) {
+  fflags_ = flags & FFLAGS_MASK;
+}
+
+void FPRegisterFile::setRM(word_t rm) {
+  frm_ = rm & FRM_MASK;
+}
+
+word_t FPRegisterFile::getFCSR() const {
+  return word_t(frm_) << FRM_SHIFT | fflags_;
+}
+
+void FPRegisterFile::setFCSR(word_t fcsr) {
+  setFlags(fcsr);
+  setRM(fcsr >> FRM_SHIFT);
+}
+
+std::ostream& FPRegisterFile::print(std::ostream& out) {
+  for (int i = 0; i != N_REGS; ++i) {
+    out << "F" << i << " = "
+        << std::hex << regs_[i] << '\n'
+        << std::dec;
+  }
+
+  out << "fcsr = " << std::hex << getFCSR() << std::dec << '\n';
+  return out;
+}
+
 bool isRegValid(Register reg) {
   return (Register::X0 <= reg) && (reg <= Register::X31);
 }
@@ -0,0 +1,121 @@
+#include "scheduler.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace rv32i_sim {
+
+unsigned EventScheduler::levelOf(uint64_t when, uint64_t now) {
+  uint64_t diff = when ^ now;
+  if (diff == 0) return 0;
+
+  unsigned high_bit = 63 - std::countl_zero(diff);
+  return high_bit / SLOT_BITS;
+}
+
+void EventScheduler::insert(Event&& event) {
+  unsigned level = levelOf(event.when, now_);
+  unsigned slot = slotOf(event.when, level);
+
+  levels_[level].slots[slot].push_back(std::move(event));
+  levels_[level].occupied |= uint64_t(1) << slot;
+}
+
+// events of lower levels and other slots of a level are all later than
+// the slots holding now, so only those are cascaded, from the top one down
+void EventScheduler::moveTo(uint64_t now) {
+  now_ = now;
+
+  for (unsigned level = N_LEVELS - 1; level > 0; --level) {
+    unsigned slot = slotOf(now, level);
+    if (!(levels_[level].occupied & (uint64_t(1) << slot))) continue;
+
+    std::vector<Event> events = std::move(levels_[level].slots[slot]);
+    levels_[level].slots[slot].clear();
+    levels_[level].occupied &= ~(uint64_t(1) << slot);
+
+    for (auto&& event : events) insert(std::move(event));
+  }
+}
+
+// the lowest level holds the earliest events, its lowest slot the earliest of them
+void EventScheduler::updateNext() {
+  next_ = NEVER;
+
+  for (auto&& level : levels_) {
+    if (!level.occupied) continue;
+
+    for (auto&& event : level.slots[std::countr_zero(level.occupied)])
+      next_ = std::min(next_, event.when);
+
+    return;
+  }
+}
+
+EventScheduler::EventId EventScheduler::schedule(uint64_t when, Callback callback) {
+  when = std::max(when, now_);
+
+  EventId id = next_id_++;
+  pending_[id] = when;
+  insert(Event {when, id, std::move(callback)});
+  next_ = std::min(next_, when);
+
+  return id;
+}
+
+// fired events are removed from pending_ one by one, so an event may
+// cancel another one due at the same time
+bool EventScheduler::cancel(EventId id) {
+  auto found = pending_.find(id);
+  if (found == pending_.end()) return false;
+
+  uint64_t when = found->second;
+  pending_.erase(found);
+
+  unsigned level = levelOf(when, now_);
+  unsigned slot = slotOf(when, level);
+  std::vector<Event>& events = levels_[level].slots[slot];
+
+  auto event = std::find_if(events.begin(), events.end(),
+                            [id](const Event& event) { return event.id == id; });
+  if (event != events.end()) {
+    events.erase(event);
+    if (events.empty()) levels_[level].occupied &= ~(uint64_t(1) << slot);
+  }
+
+  if (when == next_) updateNext();
+  return true;
+}
+
+void EventScheduler::advance(uint64_t now) {
+  while (next_ <= now) {
+    moveTo(next_);
+
+    // level 0 slot of now holds events of exactly now
+    unsigned slot = slotOf(now_, 0);
+    std::vector<Event> due = std::move(levels_[0].slots[slot]);
+    levels_[0].slots[slot].clear();
+    levels_[0].occupied &= ~(uint64_t(1) << slot);
+    updateNext();
+
+    for (auto&& event : due) {
+      if (!pending_.erase(event.id)) continue; // cancelled by an earlier one
+      event.callback(now_);
+    }
+  }
+
+  if (now > now_) moveTo(now);
+}
+
+void EventScheduler::clear() {
+  for (auto&& level : levels_) {
+    for (auto&& slot : level.slots) slot.clear();
+    level.occupied = 0;
+  }
+
+  pending_.clear();
+  now_ = 0;
+  next_ = NEVER;
+}
+
+} // rv32i_sim
@@ -5,9 +5,7 @@ namespace rv32i_sim {
 Segment::Segment(addr_t vaddr, addr_t size, uint8_t rights, uint8_t align) :
           vaddr_(vaddr), size_(size), rights_(rights), align_(align) {
 
-  // this is done to fight rights violation in example test/elf/plus.elf
-  // elfio returns rights of section .data to be WX, while they are actually RW
-  // todo figure out the reason and fix it, or report elfio bug
+  // there is no write-only memory on riscv
   if (rights & RIGHTS_W) rights_ |= RIGHTS_R;
 }
 
@@ -19,6 +17,10 @@ addr_t Segment::getSize() const {
   return size_;
 }
 
+void Segment::setSize(addr_t size) {
+  size_ = size;
+}
+
 uint8_t Segment::getRights() const {
   return rights_;
 }
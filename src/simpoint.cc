@@ -0,0 +1,100 @@
+#include "simpoint.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rv32i_sim {
+
+void BBVProfiler::onBlock(const BasicBlock& block, addr_t /* next_pc */,
+                                                   uint64_t /* instret */) {
+  if (block.retired() == 0) return;
+
+  auto [it, inserted] = ids_.try_emplace(block.start_pc, ids_.size() + 1);
+  counts_[it->second] += block.retired();
+}
+
+std::ostream& BBVProfiler::endInterval(std::ostream& out) {
+  std::vector<std::pair<uint64_t, uint64_t>> counts(counts_.begin(), counts_.end());
+  std::sort(counts.begin(), counts.end());
+
+  out << 'T';
+  for (auto&& [id, n] : counts) out << ':' << id << ':' << n << ' ';
+  out << '\n';
+
+  counts_.clear();
+  ++n_intervals_;
+
+  return out;
+}
+
+std::filesystem::path CheckpointManifest::bstateName(uint64_t interval) {
+  return std::to_string(interval) + ".bstate";
+}
+
+bool CheckpointManifest::save(const std::filesystem::path& dir) const {
+  std::ofstream manifest{dir / FILE_NAME};
+  if (!manifest) {
+    std::cerr << "ERROR: failed to write checkpoint manifest to " << dir << "\n";
+    return false;
+  }
+
+  manifest << "interval " << interval_len << '\n';
+  for (auto&& ckpt : checkpoints) {
+    manifest << "checkpoint " << ckpt.interval << ' ' << ckpt.instret << ' '
+             << ckpt.cycle << ' ' << ckpt.path.string() << '\n';
+  }
+
+  return static_cast<bool>(manifest);
+}
+
+std::optional<CheckpointManifest> CheckpointManifest::load(const std::filesystem::path& dir) {
+  std::ifstream manifest_file{dir / FILE_NAME};
+  if (!manifest_file) {
+    std::cerr << "ERROR: failed to open checkpoint manifest in " << dir << "\n";
+    return std::nullopt;
+  }
+
+  CheckpointManifest manifest;
+  bool has_interval = false;
+
+  for (std::string line; std::getline(manifest_file, line); ) {
+    std::istringstream fields{line};
+    std::string key;
+    if (!(fields >> key)) continue; // empty line
+
+    if (key == "interval" && fields >> manifest.interval_len) {
+      has_interval = manifest.interval_len != 0;
+      continue;
+    }
+
+    Checkpoint ckpt;
+    std::string path;
+    if (key == "checkpoint" && fields >> ckpt.interval >> ckpt.instret >> ckpt.cycle >> path) {
+      ckpt.path = path;
+      manifest.checkpoints.push_back(ckpt);
+      continue;
+    }
+
+    std::cerr << "ERROR: malformed checkpoint manifest line <" << line << ">\n";
+    return std::nullopt;
+  }
+
+  if (!has_interval) {
+    std::cerr << "ERROR: checkpoint manifest has no interval length\n";
+    return std::nullopt;
+  }
+
+  std::sort(manifest.checkpoints.begin(), manifest.checkpoints.end(),
+            [](auto&& lhs, auto&& rhs) { return lhs.interval < rhs.interval; });
+
+  return manifest;
+}
+
+} // rv32i_sim
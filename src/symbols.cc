@@ -0,0 +1,92 @@
+#include "symbols.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace rv32i_sim {
+
+SymbolTable::SymbolTable(std::vector<Symbol> symbols) : symbols_(symbols) {
+  std::sort(symbols_.begin(), symbols_.end(),
+            [](const Symbol& lhs, const Symbol& rhs) { return lhs.addr < rhs.addr; });
+}
+
+SymbolTable SymbolTable::fromELF(elf::elfio& elf_reader) {
+  std::vector<Symbol> symbols;
+
+  for (auto&& sec : elf_reader.sections) {
+    if (sec->get_type() != elf::SHT_SYMTAB) continue;
+
+    elf::symbol_section_accessor accessor(elf_reader, sec.get());
+    for (elf::Elf_Xword i = 0; i != accessor.get_symbols_num(); ++i) {
+      std::string name;
+      elf::Elf64_Addr value = 0;
+      elf::Elf_Xword size = 0;
+      unsigned char bind = 0;
+      unsigned char type = 0;
+      elf::Elf_Half sec_idx = 0;
+      unsigned char other = 0;
+
+      accessor.get_symbol(i, name, value, size, bind, type, sec_idx, other);
+
+      if (name.empty() || sec_idx == elf::SHN_UNDEF) continue;
+      if (sec_idx >= elf_reader.sections.size()) continue; // ABS, COMMON, ...
+
+      // labels without type are taken only if global (like _start),
+      // local ones are mostly branch targets inside functions
+      bool is_func = type == elf::STT_FUNC;
+      bool is_label = type == elf::STT_NOTYPE && bind != elf::STB_LOCAL;
+      if (!is_func && !is_label) continue;
+
+      const elf::section* sec_of_sym = elf_reader.sections[sec_idx];
+      if (!(sec_of_sym->get_flags() & elf::SHF_EXECINSTR)) continue;
+
+      // labels have no size, let them span up to the end of their section
+      if (size == 0) size = sec_of_sym->get_address() + sec_of_sym->get_size() - value;
+
+      symbols.push_back(
+        Symbol {
+          static_cast<addr_t>(value),
+          static_cast<addr_t>(size),
+          name,
+        }
+      );
+    }
+  }
+
+  return SymbolTable(symbols);
+}
+
+const Symbol* SymbolTable::lookup(addr_t pc) const {
+  auto next = std::upper_bound(symbols_.begin(), symbols_.end(), pc,
+                  [](addr_t pc, const Symbol& sym) { return pc < sym.addr; });
+
+  if (next == symbols_.begin()) return nullptr;
+
+  const Symbol& sym = *std::prev(next);
+  if (sym.size != 0 && pc >= sym.addr + sym.size) return nullptr;
+
+  return &sym;
+}
+
+const Symbol* SymbolTable::find(const std::string& name) const {
+  auto found = std::find_if(symbols_.begin(), symbols_.end(),
+                            [&name](const Symbol& sym) { return sym.name == name; });
+
+  return found == symbols_.end() ? nullptr : &*found;
+}
+
+const std::string& SymbolTable::nameOf(addr_t pc) const {
+  const Symbol* sym = lookup(pc);
+  return sym ? sym->name : UNKNOWN_SYMBOL;
+}
+
+bool SymbolTable::empty() const {
+  return symbols_.empty();
+}
+
+std::size_t SymbolTable::size() const {
+  return symbols_.size();
+}
+
+} // rv32i_sim
@@ -1,8 +1,25 @@
+#include <algorithm>
 #include <iostream>
 #include <filesystem>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <gtest/gtest.h>
 
+#include "bpred.hpp"
+#include "cache.hpp"
+#include "callstack.hpp"
+#include "devices.hpp"
+#include "pipeline.hpp"
+#include "profiler.hpp"
+#include "replay.hpp"
+#include "simpoint.hpp"
 #include "sim.hpp"
 
 class TestRVModel : public ::testing::Test {
@@ -13,6 +30,8 @@ protected:
   rv32i_sim::RVModel ref_model;
 
   virtual void SetUp() {
+    // test data is of RV32, test64 runs only TestRV64Model ones
+    if constexpr (rv32i_sim::XLEN != 32) GTEST_SKIP() << "RV32 test";
     model = rv32i_sim::RVModel{};
   }
 
@@ -68,7 +87,7 @@ protected:
       return false;
     }
 
-    return ref_model == model;
+    return ref_model.sameBstate(model);
   }
 
   bool TestAnsELF(std::filesystem::path elf_path) {
@@ -97,7 +116,7 @@ protected:
       return false;
     }
 
-    return ref_model == model;
+    return ref_model.sameBstate(model);
   }
 };
 
@@ -209,6 +228,1138 @@ TEST_F(TestRVModel, AND) {
   }
 }
 
+TEST_F(TestRVModel, MUL) {
+  if constexpr (!rv32i_sim::EXT_M) GTEST_SKIP() << "M extension is disabled";
+
+  std::filesystem::path test_dir = "../test/insn/mul";
+  for (auto const &dir_entry :
+                      std::filesystem::directory_iterator(test_dir)) {
+    if (!dir_entry.is_regular_file()) continue;
+    if (dir_entry.path().extension() != ".bstate") continue;
+    auto fpath = dir_entry.path();
+
+    EXPECT_EQ(TestAnsBstate(fpath), true);
+  }
+}
+
+TEST_F(TestRVModel, DIV) {
+  if constexpr (!rv32i_sim::EXT_M) GTEST_SKIP() << "M extension is disabled";
+
+  std::filesystem::path test_dir = "../test/insn/div";
+  for (auto const &dir_entry :
+                      std::filesystem::directory_iterator(test_dir)) {
+    if (!dir_entry.is_regular_file()) continue;
+    if (dir_entry.path().extension() != ".bstate") continue;
+    auto fpath = dir_entry.path();
+
+    EXPECT_EQ(TestAnsBstate(fpath), true);
+  }
+}
+
+TEST_F(TestRVModel, RVC) {
+  if constexpr (!rv32i_sim::EXT_C) GTEST_SKIP() << "C extension is disabled";
+
+  std::filesystem::path test_dir = "../test/insn/rvc";
+  for (auto const &dir_entry :
+                      std::filesystem::directory_iterator(test_dir)) {
+    if (!dir_entry.is_regular_file()) continue;
+    if (dir_entry.path().extension() != ".bstate") continue;
+    auto fpath = dir_entry.path();
+
+    EXPECT_EQ(TestAnsBstate(fpath), true);
+  }
+}
+
+TEST_F(TestRVModel, ZBB) {
+  if constexpr (!rv32i_sim::EXT_ZBA || !rv32i_sim::EXT_ZBB)
+    GTEST_SKIP() << "Zba or Zbb extension is disabled";
+
+  std::filesystem::path test_dir = "../test/insn/zbb";
+  for (auto const &dir_entry :
+                      std::filesystem::directory_iterator(test_dir)) {
+    if (!dir_entry.is_regular_file()) continue;
+    if (dir_entry.path().extension() != ".bstate") continue;
+    auto fpath = dir_entry.path();
+
+    EXPECT_EQ(TestAnsBstate(fpath), true);
+  }
+}
+
+TEST_F(TestRVModel, FP) {
+  if constexpr (!rv32i_sim::EXT_F) GTEST_SKIP() << "F extension is disabled";
+
+  std::filesystem::path test_dir = "../test/insn/fp";
+  for (auto const &dir_entry :
+                      std::filesystem::directory_iterator(test_dir)) {
+    if (!dir_entry.is_regular_file()) continue;
+    if (dir_entry.path().extension() != ".bstate") continue;
+    auto fpath = dir_entry.path();
+
+    EXPECT_EQ(TestAnsBstate(fpath), true);
+  }
+}
+
+TEST_F(TestRVModel, RVV) {
+  if constexpr (!rv32i_sim::EXT_V) GTEST_SKIP() << "V extension is disabled";
+
+  std::filesystem::path test_dir = "../test/insn/rvv";
+  for (auto const &dir_entry :
+                      std::filesystem::directory_iterator(test_dir)) {
+    if (!dir_entry.is_regular_file()) continue;
+    if (dir_entry.path().extension() != ".bstate") continue;
+    auto fpath = dir_entry.path();
+
+    EXPECT_EQ(TestAnsBstate(fpath), true);
+  }
+}
+
+// the same program runs on any extension config: the core stops at the first
+// insn of an extension it is built without, the later ones leave zeros
+TEST_F(TestRVModel, ISA_CONFIG) {
+  using rv32i_sim::Register;
+
+  std::filesystem::path bstate_path = "../test/insn/isa/001.bstate";
+  model.init(bstate_path);
+  ASSERT_TRUE(model.isValid());
+
+  model.execute();
+  ASSERT_TRUE(model.isValid());
+
+  struct Step {
+    bool enabled;
+    Register reg;
+    rv32i_sim::reg_t value;
+  };
+
+  const Step steps[] = {
+    {rv32i_sim::EXT_M, Register::X6, 36},
+    {rv32i_sim::EXT_ZBA, Register::X7, 18},
+    {rv32i_sim::EXT_ZBB, Register::X28, 29},
+    {rv32i_sim::EXT_ZICSR, Register::X29, 4},
+    {rv32i_sim::EXT_F, Register::X30, 6},
+    {rv32i_sim::EXT_V, Register::X31, 4},
+    {rv32i_sim::EXT_C, Register::X9, 1},
+  };
+
+  bool running = true;
+  for (auto&& step : steps) {
+    running = running && step.enabled;
+    EXPECT_EQ(model.getReg(step.reg), running ? step.value : 0);
+  }
+}
+
+// checked models stop at a bad access leaving pc at it, unchecked one runs
+// good code the same way as they do
+TEST_F(TestRVModel, MEM_POLICY) {
+  using rv32i_sim::Register;
+
+  std::filesystem::path test_dir = "../test/insn/mem";
+  for (auto const &dir_entry : std::filesystem::directory_iterator(test_dir)) {
+    if (!dir_entry.is_regular_file()) continue;
+    if (dir_entry.path().extension() != ".bstate") continue;
+    auto fpath = dir_entry.path();
+
+    rv32i_sim::BasicRVModel<rv32i_sim::CheckedMem> checked;
+    checked.init(fpath);
+    checked.execute();
+
+    model.init(fpath);
+    model.execute();
+
+    // .text is at 0x34, the second insn faults
+    EXPECT_EQ(checked.getPC(), 0x38) << fpath;
+    EXPECT_EQ(model.getPC(), 0x38) << fpath;
+
+    EXPECT_EQ(checked.getReg(Register::X7), 0) << fpath;
+    EXPECT_EQ(model.getReg(Register::X7), 0) << fpath;
+  }
+
+  std::filesystem::path bstate_path = "../test/insn/add/001.bstate";
+  std::filesystem::path ans_path = "../test/insn/add/001.ans";
+
+  rv32i_sim::BasicRVModel<rv32i_sim::UncheckedMem> unchecked;
+  unchecked.init(bstate_path);
+  unchecked.execute();
+  ASSERT_TRUE(unchecked.isValid());
+
+  ref_model.init(ans_path);
+  EXPECT_EQ(unchecked.getPC(), ref_model.getPC());
+  for (uint8_t reg = 0; reg != rv32i_sim::N_REGS; ++reg) {
+    EXPECT_EQ(unchecked.getReg(static_cast<Register>(reg)),
+              ref_model.getReg(static_cast<Register>(reg)));
+  }
+}
+
+// host pages stop the model at the same insns as checked ones do (misaligned
+// accesses are done by host), stack overflow is caught exactly at its canary page
+TEST_F(TestRVModel, HOST_MMU) {
+  using rv32i_sim::Register;
+
+  for (std::filesystem::path fpath : {"../test/insn/mem/002.bstate",
+                                      "../test/insn/mem/003.bstate"}) {
+    rv32i_sim::BasicRVModel<rv32i_sim::HostMem> host;
+    host.init(fpath);
+    host.execute();
+
+    EXPECT_EQ(host.getPC(), 0x38) << fpath;
+    EXPECT_EQ(host.getReg(Register::X7), 0) << fpath;
+  }
+
+  std::filesystem::path bstate_path = "../test/insn/mem/003.bstate";
+  constexpr rv32i_sim::addr_t stack_size = 1 << 14;
+
+  auto runStack = [&](auto& stack_model) {
+    std::ifstream bstate_file{bstate_path};
+    bstate_file.seekg(rv32i_sim::RV32I_MODEL_STATE_SIGNATURE.size() + 1 +
+                      sizeof(rv32i_sim::addr_t));
+
+    rv32i_sim::RegisterFile regs = rv32i_sim::RegisterFile::fromBstate(bstate_file);
+    rv32i_sim::MemoryModel memory = rv32i_sim::MemoryModel::fromBstate(bstate_file);
+    rv32i_sim::addr_t sp = memory.setUpStack(stack_size, true);
+
+    stack_model.init(std::move(memory), std::move(regs), 0x34);
+    stack_model.setReg(Register::X2, sp);
+    stack_model.execute();
+
+    EXPECT_EQ(stack_model.getPC(), 0x38);
+    return sp - stack_model.getReg(Register::X2);
+  };
+
+  rv32i_sim::BasicRVModel<rv32i_sim::HostMem> host;
+  EXPECT_EQ(runStack(host), stack_size);
+  EXPECT_EQ(runStack(model), stack_size);
+
+  // protection is lifted after run, canaries can be read
+  std::ostringstream out;
+  host.print(out);
+  EXPECT_FALSE(out.str().empty());
+}
+
+// firmware talks to devices instead of ecall, on checked and host-protected models
+TEST_F(TestRVModel, MMIO) {
+  using rv32i_sim::Register;
+  std::filesystem::path bstate_path = "../test/insn/mmio/001.bstate";
+
+  auto runDevices = [&](auto& dev_model) {
+    dev_model.init(bstate_path);
+    dev_model.getEnv().captureOutputs();
+
+    rv32i_sim::Uart uart{dev_model.getEnv()};
+    rv32i_sim::Clint clint{[&dev_model] { return dev_model.getInstret(); }};
+    rv32i_sim::Syscon syscon{[&dev_model](auto status) {
+      if (status) dev_model.exit(*status);
+      else dev_model.exit();
+    }};
+
+    ASSERT_TRUE(dev_model.attachDevice(rv32i_sim::UART_BASE, rv32i_sim::UART_SIZE, &uart));
+    ASSERT_TRUE(dev_model.attachDevice(rv32i_sim::CLINT_BASE, rv32i_sim::CLINT_SIZE, &clint));
+    ASSERT_TRUE(dev_model.attachDevice(rv32i_sim::SYSCON_BASE, rv32i_sim::SYSCON_SIZE,
+                                       &syscon));
+    EXPECT_FALSE(dev_model.attachDevice(rv32i_sim::UART_BASE + 0x10, 4, &uart));
+
+    dev_model.execute();
+
+    EXPECT_EQ(dev_model.getEnv().getOutput(1).getCaptured(), "Hi");
+    EXPECT_EQ(dev_model.getReg(Register::X10), 0x60);
+    EXPECT_EQ(dev_model.getReg(Register::X11), 1000);
+    EXPECT_EQ(dev_model.getReg(Register::X12), 0);
+    EXPECT_EQ(dev_model.getReg(Register::X13), 13);
+    EXPECT_EQ(dev_model.getReg(Register::X14), 0);
+    EXPECT_EQ(clint.getMtimecmp(), 1000);
+
+    // stopped at the store to syscon
+    EXPECT_EQ(dev_model.getPC(), 0x7c);
+    EXPECT_EQ(dev_model.getExitCode(), 3);
+  };
+
+  runDevices(model);
+
+  rv32i_sim::BasicRVModel<rv32i_sim::HostMem> host;
+  runDevices(host);
+}
+
+TEST_F(TestRVModel, SCHEDULER) {
+  using rv32i_sim::Register;
+  using rv32i_sim::EventScheduler;
+
+  // wheel fires in time order whatever level events sit at
+  EventScheduler events;
+  std::vector<uint64_t> fired;
+  auto record = [&fired](uint64_t now) { fired.push_back(now); };
+
+  for (uint64_t when : {uint64_t(1) << 40, uint64_t(70), uint64_t(5), uint64_t(4100),
+                        (uint64_t(1) << 24) + 3, uint64_t(70)})
+    events.schedule(when, record);
+
+  EventScheduler::EventId cancelled = events.schedule(4100, record);
+  EXPECT_TRUE(events.cancel(cancelled));
+  EXPECT_FALSE(events.cancel(cancelled));
+  EXPECT_EQ(events.nextDeadline(), 5);
+
+  events.advance(4);
+  EXPECT_TRUE(fired.empty());
+
+  events.advance(uint64_t(1) << 30);
+  EXPECT_EQ(fired, (std::vector<uint64_t> {5, 70, 70, 4100, (uint64_t(1) << 24) + 3}));
+  EXPECT_EQ(events.nextDeadline(), uint64_t(1) << 40);
+
+  // events of the same time cancel each other, callbacks schedule more
+  fired.clear();
+  events.clear();
+
+  EventScheduler::EventId second = 0;
+  events.schedule(10, [&](uint64_t now) {
+    record(now);
+    events.cancel(second);
+    events.schedule(now, record);
+    events.schedule(now + 100, record);
+  });
+  second = events.schedule(10, record);
+
+  events.advance(200);
+  EXPECT_EQ(fired, (std::vector<uint64_t> {10, 10, 110}));
+  EXPECT_TRUE(events.empty());
+  EXPECT_EQ(events.nextDeadline(), EventScheduler::NEVER);
+
+  // model cuts blocks of 4 insns at events and fires them at exact instret
+  std::filesystem::path bstate_path = "../test/insn/sched/001.bstate";
+  model.init(bstate_path);
+
+  std::vector<uint64_t> instrets;
+  std::function<void(uint64_t)> tick = [&](uint64_t now) {
+    instrets.push_back(model.getInstret());
+    if (now < 9) model.getEvents().schedule(now + 3, tick);
+    else model.exit(0);
+  };
+  model.getEvents().schedule(3, tick);
+  model.execute();
+
+  EXPECT_EQ(instrets, (std::vector<uint64_t> {3, 6, 9}));
+  EXPECT_EQ(model.getInstret(), 9);
+  EXPECT_EQ(model.getReg(Register::X5), 3);
+  EXPECT_EQ(model.getReg(Register::X6), 4);
+  EXPECT_EQ(model.getReg(Register::X7), 6);
+
+  // CLINT timer is an event at mtimecmp, rescheduled by writes
+  uint64_t time = 0;
+  rv32i_sim::Clint clint{[&time] { return time; }};
+  std::vector<bool> timer;
+
+  events.clear();
+  clint.connect(&events, [&timer](bool pending) { timer.push_back(pending); });
+  clint.write(rv32i_sim::CLINT_MTIMECMP, 8, 100);
+  EXPECT_EQ(events.nextDeadline(), 100);
+
+  time = 60;
+  events.advance(time);
+  clint.write(rv32i_sim::CLINT_MTIME, 8, 10); // mtime = time - 50
+  EXPECT_EQ(events.nextDeadline(), 150);
+
+  time = 150;
+  events.advance(time);
+  EXPECT_TRUE(clint.timerPending());
+  EXPECT_EQ(timer, (std::vector<bool> {false, false, false, true}));
+
+  clint.write(rv32i_sim::CLINT_MTIMECMP, 8, 1000);
+  EXPECT_EQ(timer.back(), false);
+  EXPECT_EQ(events.nextDeadline(), 1050);
+}
+
+TEST_F(TestRVModel, TRAP) {
+  if constexpr (!rv32i_sim::EXT_ZICSR) GTEST_SKIP() << "Zicsr extension is disabled";
+
+  using rv32i_sim::Register;
+  std::filesystem::path bstate_path = "../test/insn/trap/001.bstate";
+
+  auto runTraps = [&](auto& trap_model, bool exact_mtval) {
+    trap_model.init(bstate_path);
+
+    rv32i_sim::Clint clint{[&trap_model] { return trap_model.getInstret(); }};
+    ASSERT_TRUE(trap_model.attachDevice(rv32i_sim::CLINT_BASE, rv32i_sim::CLINT_SIZE, &clint));
+    clint.connect(&trap_model.getEvents(),
+      [&](bool pending) { trap_model.setInterruptPending(rv32i_sim::MIP_MTIP, pending); },
+      [&](bool pending) { trap_model.setInterruptPending(rv32i_sim::MIP_MSIP, pending); });
+
+    trap_model.execute();
+
+    // illegal csrr, illegal insn, load fault, ecall, ebreak, then timer and msip
+    EXPECT_EQ(trap_model.getReg(Register::X9), 0x225b3);
+    EXPECT_EQ(trap_model.getReg(Register::X18), 0x73);
+    // host reports a byte of the access which has faulted, not the first one
+    if (exact_mtval) EXPECT_EQ(trap_model.getReg(Register::X19), 0x40000000);
+    else EXPECT_EQ(trap_model.getReg(Register::X19) & ~0x7, 0x40000000);
+    EXPECT_EQ(trap_model.getReg(Register::X21), 0x1888);
+
+    // trapped insns have no effect
+    EXPECT_EQ(trap_model.getReg(Register::X10), 42);
+    EXPECT_EQ(trap_model.getReg(Register::X11), 7);
+
+    const rv32i_sim::TrapCSRs& mcsr = trap_model.getTrapCSRs();
+    EXPECT_EQ(mcsr.mcause, rv32i_sim::MCAUSE_INTERRUPT | rv32i_sim::IRQ_M_SOFTWARE);
+    EXPECT_EQ(mcsr.mip, 0);
+
+    // stopped in the loop with interrupts disabled
+    EXPECT_EQ(trap_model.getPC(), 0x100);
+    EXPECT_FALSE(trap_model.getExitCode());
+  };
+
+  runTraps(model, true);
+
+  rv32i_sim::BasicRVModel<rv32i_sim::HostMem> host;
+  runTraps(host, false);
+
+  // observers see only insns retired before a trap,
+  // jump to handler is not taken for the exit of trapped block
+  rv32i_sim::SamplingProfiler profiler{rv32i_sim::ProfileMode::INSN, 1};
+  rv32i_sim::PipelineModel pipeline{rv32i_sim::PipelineConfig {}};
+  rv32i_sim::BranchPredictor bpred{};
+  rv32i_sim::CallStackProfiler callstack{model.getSymbols()};
+
+  model.addObserver(&profiler);
+  model.addObserver(&pipeline);
+  model.addObserver(&bpred);
+  model.addObserver(&callstack);
+  runTraps(model, true);
+
+  EXPECT_EQ(profiler.nSamples(), model.getInstret());
+  EXPECT_EQ(pipeline.nInsns(), model.getInstret());
+  EXPECT_EQ(bpred.nBranches(), 14); // bltz and bne of 7 handler runs
+  EXPECT_EQ(callstack.maxDepth(), 1);
+}
+
+// idle loop: wfi goes on with mstatus.MIE clear once the timer is pending
+TEST_F(TestRVModel, TRAP_WFI) {
+  if constexpr (!rv32i_sim::EXT_ZICSR) GTEST_SKIP() << "Zicsr extension is disabled";
+
+  using rv32i_sim::Register;
+  std::filesystem::path bstate_path = "../test/insn/trap/003.bstate";
+
+  model.init(bstate_path);
+  rv32i_sim::Clint clint{[this] { return model.getInstret(); }};
+  ASSERT_TRUE(model.attachDevice(rv32i_sim::CLINT_BASE, rv32i_sim::CLINT_SIZE, &clint));
+  clint.connect(&model.getEvents(),
+    [this](bool pending) { model.setInterruptPending(rv32i_sim::MIP_MTIP, pending); },
+    [this](bool pending) { model.setInterruptPending(rv32i_sim::MIP_MSIP, pending); });
+
+  model.execute();
+
+  EXPECT_EQ(model.getReg(Register::X9), 1);
+  EXPECT_EQ(model.getReg(Register::X18), rv32i_sim::MIP_MTIP);
+  EXPECT_GE(model.getInstret(), 20);
+
+  // the timer is not taken: there is no handler and no trap
+  EXPECT_EQ(model.getTrapCSRs().mcause, 0);
+  EXPECT_EQ(model.getPC(), 0x6c);
+}
+
+TEST_F(TestRVModel, RVV_TRAP) {
+  if constexpr (!rv32i_sim::EXT_V || !rv32i_sim::EXT_ZICSR)
+    GTEST_SKIP() << "V or Zicsr extension is disabled";
+
+  using rv32i_sim::Register;
+  std::filesystem::path bstate_path = "../test/insn/trap/002.bstate";
+  rv32i_sim::DCacheObserver dcache{rv32i_sim::CacheConfig {4096, 2, 64}};
+
+  model.init(bstate_path);
+  model.setMemObserver(&dcache);
+  model.execute();
+
+  // load and store faults, then misaligned load
+  EXPECT_EQ(model.getReg(Register::X9), 0x574);
+  EXPECT_EQ(model.getReg(Register::X18), model.getReg(Register::X8) + 2);
+  EXPECT_EQ(model.getReg(Register::X10), 0x04030201);
+  EXPECT_EQ(model.getReg(Register::X11), 0x04030201);
+
+  // elements are seen by the cache one by one, the faulting ones are not
+  EXPECT_EQ(dcache.getCache().nAccesses(), 2 + 4 + 4 + 2);
+}
+
+class TestRV64Model : public TestRVModel {
+protected:
+  void SetUp() override {
+    if constexpr (rv32i_sim::XLEN != 64) GTEST_SKIP() << "RV64 test";
+    model = rv32i_sim::RVModel{};
+  }
+};
+
+TEST_F(TestRV64Model, RV64I) {
+  std::filesystem::path test_dir = "../test/insn/rv64i";
+  for (auto const &dir_entry :
+                      std::filesystem::directory_iterator(test_dir)) {
+    if (!dir_entry.is_regular_file()) continue;
+    if (dir_entry.path().extension() != ".bstate") continue;
+    auto fpath = dir_entry.path();
+
+    EXPECT_EQ(TestAnsBstate(fpath), true);
+  }
+}
+
+TEST_F(TestRV64Model, RETURN_FROM_MAIN) {
+  // main returns to the environment code, it stops the model by ebreak
+  std::filesystem::path elf_path = "../test/elf64/ret_main.elf";
+  model = rv32i_sim::RVModel(elf_path);
+  ASSERT_TRUE(model.isValid());
+
+  model.execute();
+  EXPECT_TRUE(model.isValid());
+  EXPECT_EQ(model.getReg(rv32i_sim::Register::X10), 0x123450789);
+}
+
+TEST_F(TestRVModel, CSR) {
+  if constexpr (!rv32i_sim::EXT_ZICSR) GTEST_SKIP() << "Zicsr extension is disabled";
+
+  std::filesystem::path test_dir = "../test/insn/csr";
+  for (auto const &dir_entry :
+                      std::filesystem::directory_iterator(test_dir)) {
+    if (!dir_entry.is_regular_file()) continue;
+    if (dir_entry.path().extension() != ".bstate") continue;
+    auto fpath = dir_entry.path();
+
+    EXPECT_EQ(TestAnsBstate(fpath), true);
+  }
+}
+
+TEST_F(TestRVModel, PROFILE) {
+  rv32i_sim::SamplingProfiler profiler{rv32i_sim::ProfileMode::INSN, 1};
+  std::filesystem::path bstate_path = "../test/insn/sll/002.bstate";
+
+  model.init(bstate_path);
+  model.addObserver(&profiler);
+  model.execute();
+
+  // sampling every insn must catch each of them exactly once
+  EXPECT_EQ(profiler.nSamples(), model.getInstret());
+  EXPECT_EQ(profiler.getSamples().size(), model.getInstret());
+}
+
+TEST_F(TestRVModel, CALLSTACK) {
+  std::filesystem::path bstate_path = "../test/prof/calls.bstate";
+
+  model.init(bstate_path);
+  rv32i_sim::CallStackProfiler callstack{model.getSymbols()};
+  model.addObserver(&callstack);
+  model.execute();
+
+  // _start -> f -> g, _start -> g, first insn of every callee is executed
+  EXPECT_EQ(model.getReg(rv32i_sim::Register::X10), 1);
+  EXPECT_EQ(model.getReg(rv32i_sim::Register::X11), 2);
+  EXPECT_EQ(callstack.maxDepth(), 3);
+  EXPECT_EQ(callstack.depth(), 1);
+
+  uint64_t total_exclusive = 0;
+  std::vector<uint64_t> calls;
+  for (auto&& [func, stats] : callstack.getFuncs()) {
+    total_exclusive += stats.exclusive;
+    calls.push_back(stats.calls);
+  }
+
+  std::sort(calls.begin(), calls.end());
+  EXPECT_EQ(calls, (std::vector<uint64_t> {1, 1, 2}));
+  EXPECT_EQ(total_exclusive, model.getInstret());
+}
+
+TEST_F(TestRVModel, CACHE) {
+  // direct mapped, 2 sets of 16 bytes: 0x0 and 0x20 conflict
+  rv32i_sim::CacheModel direct{rv32i_sim::CacheConfig {32, 1, 16}};
+  EXPECT_FALSE(direct.access(0x0));
+  EXPECT_TRUE(direct.access(0xC));
+  EXPECT_FALSE(direct.access(0x20));
+  EXPECT_FALSE(direct.access(0x0));
+
+  // 2 way LRU, single set: least recently used line is evicted
+  rv32i_sim::CacheModel lru{rv32i_sim::CacheConfig {32, 2, 16}};
+  EXPECT_FALSE(lru.access(0x0));
+  EXPECT_FALSE(lru.access(0x10));
+  EXPECT_TRUE(lru.access(0x0));
+  EXPECT_FALSE(lru.access(0x20));
+  EXPECT_TRUE(lru.access(0x0));
+  EXPECT_FALSE(lru.access(0x10));
+
+  EXPECT_FALSE(rv32i_sim::CacheConfig::parse("32K:3:64"));
+  EXPECT_FALSE(rv32i_sim::CacheConfig::parse("32K:4:64:fifo"));
+  EXPECT_TRUE(rv32i_sim::CacheConfig::parse("4K:2:32:random"));
+  EXPECT_FALSE(rv32i_sim::CacheConfig::parse("99999999999999999999:2:64"));
+  EXPECT_FALSE(rv32i_sim::CacheConfig::parse("4194304K:2:64"));
+
+  std::filesystem::path bstate_path = "../test/prof/cache.bstate";
+  rv32i_sim::ICacheObserver icache{rv32i_sim::CacheConfig {4096, 2, 64}};
+  rv32i_sim::DCacheObserver dcache{rv32i_sim::CacheConfig {4096, 2, 64}};
+
+  model.init(bstate_path);
+  model.addObserver(&icache);
+  model.setMemObserver(&dcache);
+  model.execute();
+
+  EXPECT_EQ(icache.getCache().nAccesses(), model.getInstret());
+
+  // two passes over 128 bytes
+  EXPECT_EQ(dcache.getCache().nAccesses(), 64);
+  EXPECT_EQ(dcache.getCache().nMisses(), 2);
+}
+
+TEST_F(TestRVModel, BPRED) {
+  std::filesystem::path loop_path = "../test/prof/cache.bstate";
+
+  // two passes of 32 iterations of inner loop, 2 iterations of outer loop
+  rv32i_sim::BranchPredictor static_pred{rv32i_sim::BPredConfig {rv32i_sim::BPredKind::STATIC}};
+  model.init(loop_path);
+  model.addObserver(&static_pred);
+  model.execute();
+
+  EXPECT_EQ(static_pred.getBranches().size(), 2);
+  EXPECT_EQ(static_pred.nBranches(), 66);
+  EXPECT_EQ(static_pred.nMispredicted(), 3); // loop exits
+
+  // weakly not taken counters also miss the first taken branch of each loop
+  rv32i_sim::BranchPredictor bimodal{rv32i_sim::BPredConfig {rv32i_sim::BPredKind::BIMODAL}};
+  model.init(loop_path);
+  model.addObserver(&bimodal);
+  model.execute();
+
+  EXPECT_EQ(bimodal.nBranches(), 66);
+  EXPECT_EQ(bimodal.nMispredicted(), 5);
+
+  std::filesystem::path calls_path = "../test/prof/calls.bstate";
+  rv32i_sim::BranchPredictor gshare{};
+  model.init(calls_path);
+  model.addObserver(&gshare);
+  model.execute();
+
+  EXPECT_EQ(gshare.nReturns(), 3);
+  EXPECT_EQ(gshare.nRASMisses(), 0);
+}
+
+TEST_F(TestRVModel, PIPELINE) {
+  std::filesystem::path bstate_path = "../test/prof/pipeline.bstate";
+
+  rv32i_sim::RVModel functional{};
+  functional.init(bstate_path);
+  functional.execute();
+
+  rv32i_sim::PipelineModel pipeline{rv32i_sim::PipelineConfig {3, 2, 1}};
+  model.init(bstate_path);
+  model.addObserver(&pipeline);
+  model.execute();
+
+  // timing must not change architectural state
+  EXPECT_TRUE(model == functional);
+  EXPECT_EQ(model.getReg(rv32i_sim::Register::X11), 42);
+  EXPECT_EQ(model.readWord(model.getReg(rv32i_sim::Register::X5) + 8), 1);
+
+  EXPECT_EQ(pipeline.nInsns(), model.getInstret());
+  EXPECT_EQ(pipeline.nLoadUseStalls(), 1);
+  EXPECT_EQ(pipeline.nMemStalls(), 6); // 3 accesses, 2 extra cycles each
+  EXPECT_EQ(pipeline.nControlStalls(), 1); // jal
+  EXPECT_EQ(pipeline.nCycles(), model.getInstret() + 4 + 8);
+
+  rv32i_sim::PipelineModel slow_jump{rv32i_sim::PipelineConfig {1, 2, 3}};
+  model.init(bstate_path);
+  model.addObserver(&slow_jump);
+  model.execute();
+
+  EXPECT_EQ(slow_jump.nControlStalls(), 3);
+  EXPECT_EQ(slow_jump.nMemStalls(), 0);
+}
+
+TEST_F(TestRVModel, FAST_FORWARD) {
+  std::filesystem::path bstate_path = "../test/prof/cache.bstate";
+
+  rv32i_sim::RVModel functional{};
+  functional.init(bstate_path);
+  functional.execute();
+
+  model.init(bstate_path);
+  model.setTrace(false);
+
+  // stop in the middle of a block: entry block is 6 insns long
+  rv32i_sim::addr_t entry = model.getPC();
+  EXPECT_TRUE(model.run(2));
+  EXPECT_EQ(model.getInstret(), 2);
+  EXPECT_EQ(model.getPC(), entry + 8);
+
+  EXPECT_TRUE(model.run(100, entry + 12));
+  EXPECT_EQ(model.getInstret(), 3);
+  EXPECT_EQ(model.getPC(), entry + 12);
+
+  rv32i_sim::PipelineModel pipeline{};
+  model.addObserver(&pipeline);
+  EXPECT_TRUE(model.run(model.getInstret() + 50));
+  model.removeObserver(&pipeline);
+
+  EXPECT_EQ(pipeline.nInsns(), 50);
+
+  EXPECT_FALSE(model.run(std::numeric_limits<uint64_t>::max()));
+  EXPECT_TRUE(model == functional);
+  EXPECT_EQ(model.getInstret(), functional.getInstret());
+}
+
+TEST_F(TestRVModel, SIMPOINT) {
+  std::filesystem::path bstate_path = "../test/prof/cache.bstate";
+  constexpr uint64_t INTERVAL = 50;
+
+  rv32i_sim::RVModel functional{};
+  functional.init(bstate_path);
+  functional.execute();
+
+  std::filesystem::path ckpt_dir = std::filesystem::temp_directory_path() / "rvsim_simpoint";
+  std::filesystem::create_directories(ckpt_dir);
+
+  rv32i_sim::BBVProfiler bbv;
+  rv32i_sim::CheckpointManifest manifest;
+  manifest.interval_len = INTERVAL;
+  std::ostringstream bb_file;
+
+  model.init(bstate_path);
+  model.setTrace(false);
+  model.addObserver(&bbv);
+
+  bool running = true;
+  while (running) {
+    running = model.run(model.getInstret() + INTERVAL);
+    if (running || !bbv.intervalEmpty()) bbv.endInterval(bb_file);
+
+    // checkpoint at the start of interval 2
+    if (model.getInstret() == 2 * INTERVAL) {
+      rv32i_sim::Checkpoint ckpt {2, model.getInstret(), model.getCycle(),
+                                  rv32i_sim::CheckpointManifest::bstateName(2)};
+      ASSERT_TRUE(model.saveCheckpoint(ckpt_dir / ckpt.path));
+      manifest.checkpoints.push_back(ckpt);
+    }
+  }
+
+  // every full interval has exactly INTERVAL insns
+  std::istringstream bb_lines{bb_file.str()};
+  std::vector<uint64_t> sums;
+  for (std::string line; std::getline(bb_lines, line); ) {
+    ASSERT_EQ(line[0], 'T');
+
+    uint64_t sum = 0;
+    std::istringstream entries{line.substr(1)};
+    for (std::string entry; entries >> entry; )
+      sum += std::stoull(entry.substr(entry.rfind(':') + 1));
+
+    sums.push_back(sum);
+  }
+
+  uint64_t n_full = model.getInstret() / INTERVAL;
+  ASSERT_EQ(sums.size(), n_full + 1);
+  for (uint64_t i = 0; i != n_full; ++i) EXPECT_EQ(sums[i], INTERVAL);
+  EXPECT_EQ(sums.back(), model.getInstret() % INTERVAL);
+
+  ASSERT_TRUE(manifest.save(ckpt_dir));
+  auto loaded = rv32i_sim::CheckpointManifest::load(ckpt_dir);
+  ASSERT_TRUE(loaded);
+  ASSERT_EQ(loaded->checkpoints.size(), 1);
+  EXPECT_EQ(loaded->interval_len, INTERVAL);
+
+  // resuming from checkpoint ends in the same state as the whole run
+  const rv32i_sim::Checkpoint& ckpt = loaded->checkpoints[0];
+  std::filesystem::path resume_path = ckpt_dir / ckpt.path;
+
+  rv32i_sim::RVModel resumed{};
+  resumed.initCheckpoint(resume_path);
+  resumed.setCounters(ckpt.instret, ckpt.cycle);
+  resumed.setTrace(false);
+  resumed.execute();
+
+  EXPECT_TRUE(resumed == functional);
+  EXPECT_EQ(resumed.getInstret(), functional.getInstret());
+
+  std::filesystem::remove_all(ckpt_dir);
+}
+
+TEST_F(TestRVModel, REPLAY) {
+  std::filesystem::path bstate_path = "../test/prof/cache.bstate";
+  constexpr uint64_t INTERVAL = 50;
+
+  std::filesystem::path ckpt_dir = std::filesystem::temp_directory_path() / "rvsim_replay";
+  std::filesystem::create_directories(ckpt_dir);
+
+  rv32i_sim::CheckpointManifest manifest;
+  manifest.interval_len = INTERVAL;
+
+  // checkpoint every interval
+  model.init(bstate_path);
+  model.setTrace(false);
+  for (bool running = true; running; running = model.run(model.getInstret() + INTERVAL)) {
+    uint64_t interval = model.getInstret() / INTERVAL;
+    rv32i_sim::Checkpoint ckpt {interval, model.getInstret(), model.getCycle(),
+                                rv32i_sim::CheckpointManifest::bstateName(interval)};
+    ASSERT_TRUE(model.saveCheckpoint(ckpt_dir / ckpt.path));
+    manifest.checkpoints.push_back(ckpt);
+  }
+
+  rv32i_sim::ReplayConfig config;
+  config.dcache = rv32i_sim::CacheConfig {4096, 2, 64};
+  config.pipeline = rv32i_sim::PipelineConfig {};
+
+  rv32i_sim::IntervalReplay replay{ckpt_dir, manifest, config};
+  replay.run(2);
+
+  EXPECT_TRUE(replay.allMatch());
+  EXPECT_EQ(replay.nInsns(), model.getInstret());
+  EXPECT_EQ(replay.mergedPipeline()->nInsns(), model.getInstret());
+  EXPECT_EQ(replay.mergedDCache()->getCache().nAccesses(), 64);
+  EXPECT_FALSE(replay.mergedICache());
+
+  // every interval but the last one is checked against the next checkpoint
+  auto&& results = replay.getResults();
+  ASSERT_EQ(results.size(), manifest.checkpoints.size());
+  for (std::size_t i = 0; i + 1 < results.size(); ++i)
+    EXPECT_EQ(results[i].check, rv32i_sim::IntervalCheck::MATCH);
+  EXPECT_EQ(results.back().check, rv32i_sim::IntervalCheck::NO_NEXT);
+
+  std::filesystem::remove_all(ckpt_dir);
+}
+
+// intervals ending with the same x registers and memory, but other f or v registers
+// than the next checkpoint holds, do not match it
+TEST_F(TestRVModel, REPLAY_MISMATCH) {
+  using rv32i_sim::Register;
+  if constexpr (!rv32i_sim::EXT_F && !rv32i_sim::EXT_V)
+    GTEST_SKIP() << "F and V extensions are disabled";
+
+  std::filesystem::path bstate_path = "../test/prof/cache.bstate";
+  constexpr uint64_t INTERVAL = 50;
+
+  std::filesystem::path ckpt_dir = std::filesystem::temp_directory_path() / "rvsim_replay_mismatch";
+  std::filesystem::create_directories(ckpt_dir);
+
+  rv32i_sim::CheckpointManifest manifest;
+  manifest.interval_len = INTERVAL;
+
+  model.init(bstate_path);
+  model.setTrace(false);
+  for (bool running = true; running; running = model.run(model.getInstret() + INTERVAL)) {
+    uint64_t interval = model.getInstret() / INTERVAL;
+    rv32i_sim::Checkpoint ckpt {interval, model.getInstret(), model.getCycle(),
+                                rv32i_sim::CheckpointManifest::bstateName(interval)};
+    ASSERT_TRUE(model.saveCheckpoint(ckpt_dir / ckpt.path));
+    manifest.checkpoints.push_back(ckpt);
+  }
+  ASSERT_GE(manifest.checkpoints.size(), 2);
+
+  // only the last checkpoint is changed, so only the interval before it ends elsewhere;
+  // f and v registers are kept in context, it is restored after each replay
+  std::filesystem::path last_path = ckpt_dir / manifest.checkpoints.back().path;
+  std::filesystem::path ctx_path = std::filesystem::path{last_path}.replace_extension(".ctx");
+  std::filesystem::path orig_ctx_path = ckpt_dir / "orig.ctx";
+  std::filesystem::copy_file(ctx_path, orig_ctx_path);
+
+  auto expectMismatch = [&](auto&& change) {
+    rv32i_sim::RVModel next{};
+    next.initCheckpoint(last_path);
+    ASSERT_TRUE(next.isValid());
+    change(next);
+    ASSERT_TRUE(next.saveCheckpoint(last_path));
+
+    rv32i_sim::IntervalReplay replay{ckpt_dir, manifest, rv32i_sim::ReplayConfig{}};
+    replay.run(2);
+
+    auto&& results = replay.getResults();
+    ASSERT_EQ(results.size(), manifest.checkpoints.size());
+    for (std::size_t i = 0; i + 2 < results.size(); ++i)
+      EXPECT_EQ(results[i].check, rv32i_sim::IntervalCheck::MATCH);
+    EXPECT_EQ(results[results.size() - 2].check, rv32i_sim::IntervalCheck::MISMATCH);
+    EXPECT_FALSE(replay.allMatch());
+
+    std::filesystem::copy_file(orig_ctx_path, ctx_path,
+                               std::filesystem::copy_options::overwrite_existing);
+  };
+
+  if constexpr (rv32i_sim::EXT_F)
+    expectMismatch([](auto& next) { next.setFReg(Register::X1, 0x3f800000); });
+  if constexpr (rv32i_sim::EXT_V)
+    expectMismatch([](auto& next) { next.getVRegs().reg(Register::X2)[0] = 42; });
+
+  std::filesystem::remove_all(ckpt_dir);
+}
+
+// checkpoint context keeps what bstate does not: segments and heap,
+// f and v registers, trap CSRs
+TEST_F(TestRVModel, CHECKPOINT) {
+  using rv32i_sim::Register;
+
+  std::filesystem::path ckpt_dir = std::filesystem::temp_directory_path() / "rvsim_checkpoint";
+  std::filesystem::create_directories(ckpt_dir);
+  std::filesystem::path ckpt_path = ckpt_dir / rv32i_sim::CheckpointManifest::bstateName(0);
+
+  std::filesystem::path elf_path = "../test/elf/plus.elf";
+  model = rv32i_sim::RVModel(elf_path);
+  ASSERT_TRUE(model.isValid());
+
+  rv32i_sim::addr_t brk = model.setBrk(0);
+  ASSERT_EQ(model.setBrk(brk + 4096), brk + 4096);
+  model.setFReg(Register::X1, 0x3f800000);
+  model.getVRegs().setConfig(4, 0x10); // e32, m1
+  model.getVRegs().reg(Register::X2)[0] = 42;
+  if constexpr (rv32i_sim::EXT_ZICSR) {
+    model.writeCSR(rv32i_sim::CSR_MTVEC, 0x100);
+    model.writeCSR(rv32i_sim::CSR_MSCRATCH, 7);
+  }
+
+  ASSERT_TRUE(model.saveCheckpoint(ckpt_path));
+
+  rv32i_sim::RVModel restored{};
+  restored.initCheckpoint(ckpt_path);
+  ASSERT_TRUE(restored.isValid());
+  EXPECT_TRUE(restored == model);
+
+  // heap grows on from the same break, code is still not writable
+  EXPECT_EQ(restored.setBrk(0), brk + 4096);
+  EXPECT_EQ(restored.setBrk(brk + 8192), brk + 8192);
+  EXPECT_FALSE(restored.hostPtr(0x10094, 4, rv32i_sim::RIGHTS_W));
+
+  if constexpr (rv32i_sim::EXT_F) {
+    EXPECT_EQ(restored.getFReg(Register::X1), 0x3f800000);
+  }
+  if constexpr (rv32i_sim::EXT_V) {
+    EXPECT_EQ(restored.getVRegs().getVL(), 4);
+    EXPECT_EQ(restored.getVRegs().reg(Register::X2)[0], 42);
+  }
+  if constexpr (rv32i_sim::EXT_ZICSR) {
+    EXPECT_EQ(restored.getTrapCSRs().mtvec, 0x100);
+    EXPECT_EQ(restored.getTrapCSRs().mscratch, 7);
+  }
+
+  // state of devices is not a part of the model
+  rv32i_sim::Clint clint{[] { return uint64_t{0}; }};
+  ASSERT_TRUE(restored.attachDevice(rv32i_sim::CLINT_BASE, rv32i_sim::CLINT_SIZE, &clint));
+  EXPECT_FALSE(restored.saveCheckpoint(ckpt_path));
+
+  std::filesystem::remove_all(ckpt_dir);
+}
+
+TEST_F(TestRVModel, LOAD) {
+  // byte loads at any address, half loads at 2 byte aligned ones
+  std::filesystem::path test_path = "../test/insn/load/001.bstate";
+  ASSERT_TRUE(RunTest(test_path));
+  EXPECT_EQ(model.getReg(rv32i_sim::Register::X6), 0xffffff82);
+  EXPECT_EQ(model.getReg(rv32i_sim::Register::X7), 0x04);
+  EXPECT_EQ(model.getReg(rv32i_sim::Register::X8), 0x0483);
+  EXPECT_EQ(model.getReg(rv32i_sim::Register::X9), 0x8201);
+}
+
+TEST_F(TestRVModel, JUMP) {
+  std::filesystem::path test_dir = "../test/insn/jump";
+
+  // j . stops the model on the jump, insns after it are never executed
+  std::filesystem::path halt_path = test_dir / "001.bstate";
+  ASSERT_TRUE(RunTest(halt_path));
+  EXPECT_EQ(model.getReg(rv32i_sim::Register::X5), 1);
+  EXPECT_EQ(model.getReg(rv32i_sim::Register::X6), 0);
+  EXPECT_EQ(model.getPC(), 0x38);
+
+  // jal, taken branch and jalr land on their targets and link pc + 4
+  std::filesystem::path land_path = test_dir / "002.bstate";
+  ASSERT_TRUE(RunTest(land_path));
+  EXPECT_EQ(model.getReg(rv32i_sim::Register::X5), 7);
+  EXPECT_EQ(model.getReg(rv32i_sim::Register::X1), 0x3c);
+  EXPECT_EQ(model.getReg(rv32i_sim::Register::X7), 0x5c);
+  EXPECT_EQ(model.getPC(), 0x64);
+}
+
+TEST_F(TestRVModel, ELF_RIGHTS) {
+  namespace elf = rv32i_sim::elf;
+
+  // only loadable segments are mapped, with rights of their p_flags
+  for (auto&& elf_name : {"plus.elf", "ecall_read.elf"}) {
+    std::filesystem::path elf_path = std::filesystem::path{"../test/elf"} / elf_name;
+    elf::elfio elf_reader;
+    ASSERT_TRUE(elf_reader.load(elf_path));
+
+    auto mem = rv32i_sim::MemoryModel::fromELF(elf_reader);
+    ASSERT_TRUE(mem.isValid());
+    EXPECT_TRUE(mem.checkRights(elf_reader.get_entry(), rv32i_sim::RIGHTS_X));
+
+    for (auto&& seg : elf_reader.segments) {
+      if (seg->get_type() != elf::PT_LOAD) continue;
+
+      rv32i_sim::addr_t vaddr = seg->get_virtual_address();
+      EXPECT_TRUE(mem.checkRights(vaddr, rv32i_sim::RIGHTS_R)) << elf_path;
+      EXPECT_EQ(mem.checkRights(vaddr, rv32i_sim::RIGHTS_W),
+                static_cast<bool>(seg->get_flags() & elf::PF_W)) << elf_path;
+      EXPECT_EQ(mem.checkRights(vaddr, rv32i_sim::RIGHTS_X),
+                static_cast<bool>(seg->get_flags() & elf::PF_X)) << elf_path;
+    }
+  }
+}
+
+TEST_F(TestRVModel, ELF_STACK) {
+  // newlib printf alone takes more than 4K of stack
+  constexpr rv32i_sim::addr_t printf_stack = 16 << 10;
+
+  std::filesystem::path elf_path = "../test/elf/plus.elf";
+  auto mem = rv32i_sim::MemoryModel::fromELF(elf_path);
+  ASSERT_TRUE(mem.isValid());
+
+  rv32i_sim::addr_t sp = mem.setUpStack();
+  EXPECT_TRUE(mem.checkRights(sp, rv32i_sim::RIGHTS_R | rv32i_sim::RIGHTS_W));
+  EXPECT_TRUE(mem.checkRights(sp - printf_stack, rv32i_sim::RIGHTS_R | rv32i_sim::RIGHTS_W));
+}
+
+TEST_F(TestRVModel, SYSCALL) {
+  std::filesystem::path bstate_path = "../test/env/syscall.bstate";
+  std::filesystem::path out_path = "syscall.out";
+  std::filesystem::remove(out_path);
+
+  // openat, write, lseek, close and exit with file size as status
+  model.init(bstate_path);
+  model.execute();
+
+  ASSERT_TRUE(model.isValid());
+  ASSERT_TRUE(model.getExitCode());
+  EXPECT_EQ(*model.getExitCode(), 6);
+
+  std::ifstream out_file{out_path};
+  std::string line;
+  std::getline(out_file, line);
+  EXPECT_EQ(line, "hello");
+  std::filesystem::remove(out_path);
+
+  // program break of ELF starts right after loaded memory and grows up to the limit
+  std::filesystem::path elf_path = "../test/elf/plus.elf";
+  model = rv32i_sim::RVModel(elf_path);
+
+  rv32i_sim::addr_t brk = model.setBrk(0);
+  EXPECT_NE(brk, 0);
+  EXPECT_EQ(model.setBrk(brk + 4096), brk + 4096);
+  EXPECT_TRUE(model.hostPtr(brk, 4096, rv32i_sim::RIGHTS_W));
+  EXPECT_FALSE(model.hostPtr(brk + 4096, 1, rv32i_sim::RIGHTS_R));
+  EXPECT_EQ(model.setBrk(brk + rv32i_sim::MAX_HEAP_SIZE + 4), brk + 4096);
+
+  // heap grows in place: memory is not moved, released part comes back zeroed
+  rv32i_sim::byte_t* heap = model.hostPtr(brk, 4096, rv32i_sim::RIGHTS_W);
+  heap[4095] = 0xAB;
+  EXPECT_EQ(model.setBrk(brk + 4000), brk + 4000);
+  EXPECT_EQ(model.setBrk(brk + rv32i_sim::MAX_HEAP_SIZE), brk + rv32i_sim::MAX_HEAP_SIZE);
+  EXPECT_EQ(model.hostPtr(brk, 4096, rv32i_sim::RIGHTS_W), heap);
+  EXPECT_EQ(heap[4095], 0);
+}
+
+TEST_F(TestRVModel, GUEST_OUTPUT) {
+  // full buffer is written out only when threshold is reached
+  rv32i_sim::GuestOutput full = rv32i_sim::GuestOutput::capture(
+                                  rv32i_sim::OutputConfig {rv32i_sim::FlushPolicy::FULL, 4});
+  const rv32i_sim::byte_t data[] = {'a', 'b', '\n'};
+  EXPECT_EQ(full.write(data, 3), 3);
+  EXPECT_EQ(full.getCaptured(), "");
+  EXPECT_EQ(full.write(data, 3), 3);
+  EXPECT_EQ(full.getCaptured(), "ab\nab\n");
+
+  rv32i_sim::GuestOutput line = rv32i_sim::GuestOutput::capture(
+                                  rv32i_sim::OutputConfig {rv32i_sim::FlushPolicy::LINE, 64});
+  line.write(data, 2);
+  EXPECT_EQ(line.getCaptured(), "");
+  line.write(data + 2, 1);
+  EXPECT_EQ(line.getCaptured(), "ab\n");
+
+  // with exit policy nothing is written until guest stops
+  std::filesystem::path bstate_path = "../test/env/output.bstate";
+  model.init(bstate_path);
+  model.getEnv().setOutputConfig(rv32i_sim::OutputConfig {rv32i_sim::FlushPolicy::EXIT});
+  model.getEnv().captureOutputs();
+  model.setTrace(false);
+
+  model.run(20);
+  EXPECT_EQ(model.getEnv().getOutput(1).getCaptured(), "");
+
+  model.execute();
+  EXPECT_EQ(model.getEnv().getOutput(1).getCaptured(), "ab\nab\nab\n");
+  EXPECT_EQ(model.getEnv().getOutput(2).getCaptured(), "err");
+  EXPECT_EQ(model.getExitCode(), 0u);
+}
+
+// file is mapped in whole pages and read at their ends, writes go to
+// private copies of pages and never reach the file
+TEST_F(TestRVModel, HOST_MEMORY) {
+  constexpr std::size_t PAGE = 4096; // on hosts with larger pages more is read
+  std::filesystem::path file_path = "host_memory.bin";
+
+  std::vector<rv32i_sim::byte_t> bytes(5 * PAGE + 123);
+  for (std::size_t i = 0; i != bytes.size(); ++i) bytes[i] = i * 7 + 1;
+
+  {
+    std::ofstream file{file_path, std::ios::binary};
+    file.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+  }
+
+  int fd = open(file_path.c_str(), O_RDONLY);
+  ASSERT_GE(fd, 0);
+
+  // offset is congruent with address modulo page size, then it is not
+  rv32i_sim::HostMemory memory(16 * PAGE);
+  EXPECT_TRUE(memory.mapFile(fd, 100, PAGE + 100, bytes.size() - 100));
+  EXPECT_TRUE(memory.mapFile(fd, 0, 10 * PAGE + 1, PAGE));
+  EXPECT_FALSE(memory.mapFile(fd, 0, 16 * PAGE - 1, 2));
+  close(fd);
+
+  EXPECT_TRUE(std::equal(bytes.begin() + 100, bytes.end(), memory.data() + PAGE + 100));
+  EXPECT_TRUE(std::equal(bytes.begin(), bytes.begin() + PAGE, memory.data() + 10 * PAGE + 1));
+  EXPECT_EQ(memory[PAGE + 99], 0);
+  EXPECT_EQ(memory[PAGE + bytes.size()], 0);
+
+  memory[3 * PAGE] = 0;
+  rv32i_sim::HostMemory copy = memory;
+  EXPECT_TRUE(copy == memory);
+
+  std::ifstream file{file_path, std::ios::binary};
+  std::vector<rv32i_sim::byte_t> file_bytes(bytes.size());
+  file.read(reinterpret_cast<char *>(file_bytes.data()), file_bytes.size());
+  EXPECT_EQ(file_bytes, bytes);
+
+  // bytes dropped by shrinking come back zeroed, growth past capacity moves data
+  memory.resize(2 * PAGE);
+  memory.resize(4 * PAGE);
+  EXPECT_EQ(memory[2 * PAGE + 1], 0);
+  EXPECT_EQ(memory[2 * PAGE - 1], bytes[PAGE - 1]);
+
+  memory.resize(64 * PAGE);
+  EXPECT_EQ(memory[2 * PAGE - 1], bytes[PAGE - 1]);
+  EXPECT_EQ(memory[64 * PAGE - 1], 0);
+
+  std::filesystem::remove(file_path);
+}
+
+// whole pages of ELF data stay mapped from the file after stack, environment and heap
+// are set up
+TEST_F(TestRVModel, ELF_MAPPING) {
+  std::filesystem::path elf_path = "../test/elf/mapped.elf";
+  std::string mapped_path = std::filesystem::canonical(elf_path).string();
+
+  // path of the mapping /proc/self/maps lists for host address
+  auto mappedFile = [](const void* ptr) {
+    auto addr = reinterpret_cast<uintptr_t>(ptr);
+    std::ifstream maps{"/proc/self/maps"};
+    for (std::string line; std::getline(maps, line);) {
+      std::istringstream fields{line};
+      std::string range, perms, offset, dev, inode, path;
+      fields >> range >> perms >> offset >> dev >> inode >> path;
+
+      std::size_t dash = range.find('-');
+      uintptr_t start = std::stoull(range.substr(0, dash), nullptr, 16);
+      uintptr_t end = std::stoull(range.substr(dash + 1), nullptr, 16);
+      if (addr >= start && addr < end) return path;
+    }
+
+    return std::string{};
+  };
+
+  auto checkMapping = [&](auto&& elf_model) {
+    ASSERT_TRUE(elf_model.isValid());
+    rv32i_sim::byte_t* table = elf_model.hostPtr(0x13000, 4, rv32i_sim::RIGHTS_R);
+    ASSERT_TRUE(table);
+    EXPECT_EQ(mappedFile(table), mapped_path);
+
+    elf_model.execute();
+    EXPECT_EQ(elf_model.getReg(rv32i_sim::Register::X10), 0x11111111);
+  };
+
+  checkMapping(rv32i_sim::BasicRVModel<rv32i_sim::UncheckedMem>(elf_path));
+  checkMapping(rv32i_sim::BasicRVModel<rv32i_sim::CheckedMem>(elf_path));
+  checkMapping(rv32i_sim::RVModel(elf_path));
+}
+
 TEST_F(TestRVModel, ELF_FILE) {
   std::filesystem::path test_dir = "../test/elf";
   for (auto const &dir_entry :
@@ -0,0 +1,320 @@
+#include "vector.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define RVSIM_HOST_X86
+#endif
+
+namespace rv32i_sim {
+
+VType VType::fromBits(word_t bits) {
+  VType vtype;
+
+  word_t vlmul = bits & 0x7;
+  word_t vsew = (bits >> 3) & 0x7;
+
+  // bits above vma are reserved, vsew > 2 is SEW 64 wider than ELEN,
+  // vlmul 4 is reserved and 5-7 are fractional LMUL not supported here
+  if ((bits >> 8) != 0 || vsew > 2 || vlmul > 3) return vtype;
+
+  vtype.bits = bits;
+  vtype.sew = 8u << vsew;
+  vtype.lmul = 1u << vlmul;
+  vtype.vill = false;
+
+  return vtype;
+}
+
+bool VectorRegisterFile::operator==(const VectorRegisterFile& other) const {
+  return vl_ == other.vl_ && vtype_.bits == other.vtype_.bits && data_ == other.data_;
+}
+
+word_t VectorRegisterFile::setConfig(word_t avl, word_t vtype_bits) {
+  vtype_ = VType::fromBits(vtype_bits);
+  vl_ = std::min(avl, vtype_.vlmax());
+
+  return vl_;
+}
+
+namespace {
+
+template <typename T>
+T load(const byte_t* ptr) {
+  T val;
+  std::memcpy(&val, ptr, sizeof(T));
+  return val;
+}
+
+template <typename T>
+void store(byte_t* ptr, T val) {
+  std::memcpy(ptr, &val, sizeof(T));
+}
+
+template <typename T>
+T applyScalar(VecOp op, T a, T b) {
+  switch (op)
+  {
+  case VecOp::ADD: return T(a + b);
+  case VecOp::SUB: return T(a - b);
+  case VecOp::AND: return T(a & b);
+  case VecOp::OR:  return T(a | b);
+  case VecOp::XOR: return T(a ^ b);
+  case VecOp::MUL: return T(word_t(a) * word_t(b)); // no int promotion overflow
+  }
+
+  return 0;
+}
+
+template <typename T>
+T reduceScalar(VecRed op, T acc, T val) {
+  using S = std::make_signed_t<T>;
+
+  switch (op)
+  {
+  case VecRed::SUM:  return T(acc + val);
+  case VecRed::AND:  return T(acc & val);
+  case VecRed::OR:   return T(acc | val);
+  case VecRed::XOR:  return T(acc ^ val);
+  case VecRed::MINU: return std::min(acc, val);
+  case VecRed::MIN:  return T(std::min(S(acc), S(val)));
+  case VecRed::MAXU: return std::max(acc, val);
+  case VecRed::MAX:  return T(std::max(S(acc), S(val)));
+  }
+
+  return acc;
+}
+
+// value that does not change the result of reduction
+template <typename T>
+T identity(VecRed op) {
+  using S = std::make_signed_t<T>;
+
+  switch (op)
+  {
+  case VecRed::AND:
+  case VecRed::MINU: return std::numeric_limits<T>::max();
+  case VecRed::MIN:  return T(std::numeric_limits<S>::max());
+  case VecRed::MAX:  return T(std::numeric_limits<S>::min());
+  default:           return 0;
+  }
+}
+
+template <typename T>
+void binaryScalar(VecOp op, byte_t* dst, const byte_t* a, const byte_t* b, std::size_t n) {
+  for (std::size_t i = 0; i < n * sizeof(T); i += sizeof(T))
+    store<T>(dst + i, applyScalar<T>(op, load<T>(a + i), load<T>(b + i)));
+}
+
+template <typename T>
+T reduceBytes(VecRed op, T acc, const byte_t* src, std::size_t size) {
+  for (std::size_t i = 0; i < size; i += sizeof(T))
+    acc = reduceScalar<T>(op, acc, load<T>(src + i));
+
+  return acc;
+}
+
+#ifdef RVSIM_HOST_X86
+
+bool hostHasAVX2() {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+
+// kernels below return the number of bytes done, they stop at the last
+// full host register or do nothing if host has no such op (8-bit mul),
+// the rest is left to scalar loop
+
+__attribute__((target("avx2")))
+std::size_t binaryAVX2(VecOp op, unsigned sew, byte_t* dst, const byte_t* a,
+                       const byte_t* b, std::size_t size) {
+  if (op == VecOp::MUL && sew == 8) return 0;
+
+  std::size_t i = 0;
+  for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    __m256i res;
+
+    switch (op)
+    {
+    case VecOp::ADD:
+      res = sew == 8  ? _mm256_add_epi8(x, y) :
+            sew == 16 ? _mm256_add_epi16(x, y) : _mm256_add_epi32(x, y);
+      break;
+    case VecOp::SUB:
+      res = sew == 8  ? _mm256_sub_epi8(x, y) :
+            sew == 16 ? _mm256_sub_epi16(x, y) : _mm256_sub_epi32(x, y);
+      break;
+    case VecOp::AND: res = _mm256_and_si256(x, y); break;
+    case VecOp::OR:  res = _mm256_or_si256(x, y); break;
+    case VecOp::XOR: res = _mm256_xor_si256(x, y); break;
+    case VecOp::MUL:
+      res = sew == 16 ? _mm256_mullo_epi16(x, y) : _mm256_mullo_epi32(x, y);
+      break;
+    default: return i;
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), res);
+  }
+
+  return i;
+}
+
+// SSE2 is a part of x86-64, it lacks 8-bit and 32-bit low multiply
+std::size_t binarySSE2(VecOp op, unsigned sew, byte_t* dst, const byte_t* a,
+                       const byte_t* b, std::size_t size) {
+  if (op == VecOp::MUL && sew != 16) return 0;
+
+  std::size_t i = 0;
+  for (; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    __m128i res;
+
+    switch (op)
+    {
+    case VecOp::ADD:
+      res = sew == 8  ? _mm_add_epi8(x, y) :
+            sew == 16 ? _mm_add_epi16(x, y) : _mm_add_epi32(x, y);
+      break;
+    case VecOp::SUB:
+      res = sew == 8  ? _mm_sub_epi8(x, y) :
+            sew == 16 ? _mm_sub_epi16(x, y) : _mm_sub_epi32(x, y);
+      break;
+    case VecOp::AND: res = _mm_and_si128(x, y); break;
+    case VecOp::OR:  res = _mm_or_si128(x, y); break;
+    case VecOp::XOR: res = _mm_xor_si128(x, y); break;
+    case VecOp::MUL: res = _mm_mullo_epi16(x, y); break;
+    default: return i;
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), res);
+  }
+
+  return i;
+}
+
+__attribute__((target("avx2")))
+__m256i reduceStepAVX2(VecRed op, unsigned sew, __m256i acc, __m256i x) {
+  switch (op)
+  {
+  case VecRed::SUM:
+    return sew == 8  ? _mm256_add_epi8(acc, x) :
+           sew == 16 ? _mm256_add_epi16(acc, x) : _mm256_add_epi32(acc, x);
+  case VecRed::AND: return _mm256_and_si256(acc, x);
+  case VecRed::OR:  return _mm256_or_si256(acc, x);
+  case VecRed::XOR: return _mm256_xor_si256(acc, x);
+  case VecRed::MINU:
+    return sew == 8  ? _mm256_min_epu8(acc, x) :
+           sew == 16 ? _mm256_min_epu16(acc, x) : _mm256_min_epu32(acc, x);
+  case VecRed::MIN:
+    return sew == 8  ? _mm256_min_epi8(acc, x) :
+           sew == 16 ? _mm256_min_epi16(acc, x) : _mm256_min_epi32(acc, x);
+  case VecRed::MAXU:
+    return sew == 8  ? _mm256_max_epu8(acc, x) :
+           sew == 16 ? _mm256_max_epu16(acc, x) : _mm256_max_epu32(acc, x);
+  case VecRed::MAX:
+    return sew == 8  ? _mm256_max_epi8(acc, x) :
+           sew == 16 ? _mm256_max_epi16(acc, x) : _mm256_max_epi32(acc, x);
+  }
+
+  return acc;
+}
+
+/// @brief fold full host registers of src lane-wise into acc
+/// @return bytes done, acc gets lanes folded
+template <typename T>
+__attribute__((target("avx2")))
+std::size_t reduceAVX2(VecRed op, T& acc, const byte_t* src, std::size_t size) {
+  if (size < sizeof(__m256i)) return 0;
+
+  byte_t lanes[sizeof(__m256i)];
+  for (std::size_t i = 0; i < sizeof(lanes); i += sizeof(T))
+    store<T>(lanes + i, identity<T>(op));
+
+  __m256i vacc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes));
+
+  std::size_t i = 0;
+  for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    vacc = reduceStepAVX2(op, sizeof(T) * BITS_BYTE, vacc, x);
+  }
+
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), vacc);
+  acc = reduceBytes<T>(op, acc, lanes, sizeof(lanes));
+
+  return i;
+}
+
+#endif // RVSIM_HOST_X86
+
+template <typename T>
+void binaryTyped(VecOp op, byte_t* dst, const byte_t* a, const byte_t* b, std::size_t n) {
+  std::size_t size = n * sizeof(T);
+  std::size_t done = 0;
+
+#ifdef RVSIM_HOST_X86
+  constexpr unsigned sew = sizeof(T) * BITS_BYTE;
+  done = hostHasAVX2() ? binaryAVX2(op, sew, dst, a, b, size) :
+                         binarySSE2(op, sew, dst, a, b, size);
+#endif
+
+  binaryScalar<T>(op, dst + done, a + done, b + done, (size - done) / sizeof(T));
+}
+
+template <typename T>
+word_t reduceTyped(VecRed op, const byte_t* src, word_t init, std::size_t n) {
+  std::size_t size = n * sizeof(T);
+  std::size_t done = 0;
+  T acc = T(init);
+
+#ifdef RVSIM_HOST_X86
+  if (hostHasAVX2()) done = reduceAVX2<T>(op, acc, src, size);
+#endif
+
+  return reduceBytes<T>(op, acc, src + done, size - done);
+}
+
+} // namespace
+
+void vecBinary(VecOp op, unsigned sew, byte_t* dst, const byte_t* a, const byte_t* b,
+               std::size_t n) {
+  switch (sew)
+  {
+  case 8:  binaryTyped<uint8_t>(op, dst, a, b, n); break;
+  case 16: binaryTyped<uint16_t>(op, dst, a, b, n); break;
+  case 32: binaryTyped<uint32_t>(op, dst, a, b, n); break;
+  default: break;
+  }
+}
+
+word_t vecReduce(VecRed op, unsigned sew, const byte_t* src, word_t init, std::size_t n) {
+  switch (sew)
+  {
+  case 8:  return reduceTyped<uint8_t>(op, src, init, n);
+  case 16: return reduceTyped<uint16_t>(op, src, init, n);
+  case 32: return reduceTyped<uint32_t>(op, src, init, n);
+  default: return 0;
+  }
+}
+
+void vecSplat(unsigned sew, byte_t* dst, word_t val, std::size_t n) {
+  switch (sew)
+  {
+  case 8:  std::memset(dst, int(val & 0xFF), n); break;
+  case 16:
+    for (std::size_t i = 0; i < n; ++i) store<uint16_t>(dst + 2 * i, uint16_t(val));
+    break;
+  case 32:
+    for (std::size_t i = 0; i < n; ++i) store<uint32_t>(dst + 4 * i, val);
+    break;
+  default: break;
+  }
+}
+
+} // rv32i_sim
@@ -0,0 +1,15 @@
+.global _start
+
+# table spans whole pages, they are mapped from the file rather than read
+
+.section .data
+table: .fill 3072, 4, 0x11111111
+
+.section .text
+_start:
+  la a1, table
+  lui a2, 1
+  add a1, a1, a2
+  lw a0, 0(a1)             # a0 = 0x11111111
+
+  ebreak
@@ -0,0 +1,12 @@
+.global main
+
+.text
+
+# main returns to the environment code, which must stop the model with ebreak,
+# a0 = 0x123450789 checks the whole 64-bit result is kept
+
+main:
+  li a0, 0x12345
+  slli a0, a0, 16
+  addi a0, a0, 0x789
+  ret
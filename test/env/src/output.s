@@ -0,0 +1,42 @@
+.option norelax
+.global _start
+
+.section .text
+
+# writes a line to stdout three times and a word to stderr
+
+_start:
+  jal x0, main
+
+line:
+  .ascii "ab\n"
+word:
+  .ascii "err"
+  .byte 0, 0  # pad to insn alignment
+
+main:
+  auipc s0, 0
+  addi s1, x0, 3
+
+loop:
+  # write(1, line, 3)
+  addi a0, x0, 1
+  addi a1, s0, -8    # line - main
+  addi a2, x0, 3
+  addi a7, x0, 64
+  ecall
+
+  addi s1, s1, -1
+  bne s1, x0, loop
+
+  # write(2, word, 3)
+  addi a0, x0, 2
+  addi a1, s0, -5    # word - main
+  addi a2, x0, 3
+  addi a7, x0, 64
+  ecall
+
+  # exit(0)
+  addi a0, x0, 0
+  addi a7, x0, 93
+  ecall
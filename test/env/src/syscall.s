@@ -0,0 +1,53 @@
+.option norelax
+.global _start
+
+.section .text
+
+# writes a message to a new file and exits with its size as status
+
+_start:
+  jal x0, main
+
+path:
+  .asciz "syscall.out"
+msg:
+  .ascii "hello\n"
+  .byte 0, 0  # pad to insn alignment
+
+main:
+  auipc s0, 0
+
+  # fd = openat(AT_FDCWD, path, O_WRONLY | O_CREAT | O_TRUNC, 0644)
+  addi a0, x0, -100
+  addi a1, s0, -20   # path - main
+  addi a2, x0, 0x601
+  addi a3, x0, 0x1a4
+  addi a7, x0, 56
+  ecall
+  add s1, x0, a0
+
+  # write(fd, msg, 6)
+  add a0, x0, s1
+  addi a1, s0, -8    # msg - main
+  addi a2, x0, 6
+  addi a7, x0, 64
+  ecall
+
+  # size = lseek(fd, 0, SEEK_END)
+  add a0, x0, s1
+  addi a1, x0, 0
+  addi a2, x0, 2
+  addi a7, x0, 62
+  ecall
+  add s2, x0, a0
+
+  # close(fd)
+  add a0, x0, s1
+  addi a7, x0, 57
+  ecall
+
+  # exit(size)
+  add a0, x0, s2
+  addi a7, x0, 93
+  ecall
+
@@ -0,0 +1,21 @@
+.global _start
+
+.section .text
+
+_start:
+  addi x5, x0, 5
+  addi x6, x0, 6
+
+  rdinstret x10 # 2 insns retired before
+  rdcycle x11   # 3 cycles, functional model is 1 CPI
+  rdtime x12
+  rdinstreth x13
+
+  addi x7, x0, 7
+  csrrw x14, minstret, x7  # x14 = 7 (insns before), minstret = 7
+  rdinstret x15            # 7, write overrides csrrw own increment
+
+  csrrsi x16, mcycle, 0    # rs1 = 0: read only
+  csrrci x17, mcycleh, 0
+
+  ebreak
@@ -0,0 +1,24 @@
+.global _start
+
+.text
+
+_start:
+  addi x11, x0, -7    # x11 = -7
+  addi x12, x0, 2     # x12 = 2
+  lui x13, 0x80000    # x13 = INT_MIN
+  addi x14, x0, -1    # x14 = -1
+
+  div x15, x11, x12   # x15 = -3 (rounds towards zero)
+  rem x16, x11, x12   # x16 = -1 (sign of dividend)
+  divu x17, x11, x12  # x17 = 0x7ffffffc
+  remu x18, x11, x12  # x18 = 1
+
+  div x19, x11, x0    # x19 = -1 (by zero)
+  rem x20, x11, x0    # x20 = -7
+  divu x21, x11, x0   # x21 = 0xffffffff
+  remu x22, x11, x0   # x22 = -7
+
+  div x23, x13, x14   # x23 = INT_MIN (overflow)
+  rem x24, x13, x14   # x24 = 0
+
+  ebreak
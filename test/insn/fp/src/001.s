@@ -0,0 +1,63 @@
+.global _start
+
+.text
+
+# RV32F: results are moved to x registers, as f ones are not a part of bstate
+
+_start:
+  addi x5, x0, 3
+  addi x6, x0, -2
+  fcvt.s.w f1, x5         # f1 = 3.0
+  fcvt.s.w f2, x6         # f2 = -2.0
+
+  fadd.s f3, f1, f2       # 1.0
+  fmv.x.w x10, f3         # x10 = 0x3f800000
+  fmul.s f4, f1, f2       # -6.0
+  fcvt.w.s x11, f4        # x11 = -6
+  fdiv.s f5, f1, f2       # -1.5
+  fmv.x.w x12, f5         # x12 = 0xbfc00000
+  fsub.s f6, f2, f1       # -5.0
+  fmadd.s f7, f1, f1, f2  # 3 * 3 - 2 = 7.0
+  fcvt.w.s x13, f7        # x13 = 7
+  fnmsub.s f8, f1, f1, f2 # -(3 * 3) + (-2) = -11.0
+  fcvt.w.s x14, f8        # x14 = -11
+
+  csrrw x0, fflags, x0    # clear
+  fsqrt.s f9, f1          # sqrt(3), inexact
+  csrrs x15, fflags, x0   # x15 = NX = 1
+
+  # rounding of conversions: -1.5
+  fcvt.w.s x16, f5, rtz   # x16 = -1
+  fcvt.w.s x17, f5, rdn   # x17 = -2
+  fcvt.w.s x18, f5, rup   # x18 = -1
+  fcvt.w.s x19, f5, rne   # x19 = -2
+  fcvt.w.s x20, f5, rmm   # x20 = -2
+  csrrwi x0, frm, 1       # dynamic mode is rtz
+  fcvt.w.s x21, f9        # x21 = 1 (sqrt(3) towards zero)
+  csrrs x22, fcsr, x0     # x22 = rtz << 5 | NX = 0x21
+
+  # invalid: 0 / 0 gives canonical NaN
+  fcvt.s.w f10, x0
+  csrrw x0, fcsr, x0      # back to rne, flags cleared
+  fdiv.s f11, f10, f10
+  fmv.x.w x23, f11        # x23 = 0x7fc00000
+  fcvt.w.s x24, f11       # x24 = 0x7fffffff
+  fcvt.wu.s x25, f2       # x25 = 0 (negative)
+  csrrs x26, fflags, x0   # x26 = NV = 0x10
+
+  # compare, min/max, sign injection, class
+  flt.s x27, f2, f1       # x27 = 1
+  fmin.s f12, f11, f2     # NaN is ignored: -2.0
+  fsgnjn.s f13, f12, f12  # 2.0
+  fmv.x.w x28, f13        # x28 = 0x40000000
+  fclass.s x29, f2        # x29 = 0x2 (negative normal)
+
+  # memory
+  auipc x8, 0
+  addi x8, x8, 256        # scratch area past the code
+  fsw f7, 4(x8)
+  lw x30, 4(x8)           # x30 = 0x40e00000 (7.0)
+  flw f14, 4(x8)
+  feq.s x31, f14, f7      # x31 = 1
+
+  ebreak
@@ -0,0 +1,24 @@
+.global _start
+
+.text
+
+# one insn of every optional extension, each writes its own register,
+# the core built without an extension stops at its insn as at illegal one
+
+.option norvc
+
+_start:
+  li x5, 6
+  mul x6, x5, x5                 # M: x6 = 36
+  sh1add x7, x5, x5              # Zba: x7 = 18
+  clz x28, x5                    # Zbb: x28 = 29
+  csrr x29, instret              # Zicsr: x29 = 4
+  fmv.w.x f1, x5                 # F
+  fmv.x.w x30, f1                # x30 = 6
+  vsetivli x31, 4, e32, m1, ta, ma # V: x31 = 4
+
+.option rvc
+  c.li x9, 1                     # C: x9 = 1
+.option norvc
+
+  ebreak
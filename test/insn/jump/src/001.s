@@ -0,0 +1,9 @@
+.global _start
+
+.text
+
+_start:
+  addi x5, x0, 1
+  j .              # halts the model, pc stays here
+  addi x6, x0, 1   # never executed
+  ebreak
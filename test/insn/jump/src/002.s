@@ -0,0 +1,21 @@
+.global _start
+
+.text
+
+_start:
+  addi x5, x0, 0
+  jal x1, 1f         # x1 = 0x3c, address of the next insn
+  addi x5, x5, 16    # skipped
+1:
+  addi x5, x5, 1     # target of a jump is executed
+  beq x0, x0, 2f
+  addi x5, x5, 16    # skipped
+2:
+  addi x5, x5, 2     # target of a branch is executed
+  auipc x7, 0
+  addi x7, x7, 16    # x7 = 3f
+  jalr x7, 0(x7)     # rd is rs1: jumps to 3f, x7 = 0x5c
+  addi x5, x5, 16    # skipped
+3:
+  addi x5, x5, 4     # x5 = 7
+  ebreak
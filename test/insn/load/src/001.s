@@ -0,0 +1,18 @@
+.global _start
+
+.text
+
+_start:
+  j main
+
+data:
+  .word 0x04838201
+
+main:
+  auipc x5, 0
+  addi x5, x5, -4          # x5 = data = 0x38
+  lb x6, 1(x5)             # byte loads need no alignment, x6 = 0xffffff82
+  lbu x7, 3(x5)            # x7 = 0x04
+  lh x8, 2(x5)             # half loads are 2 byte aligned, x8 = 0x0483
+  lhu x9, 0(x5)            # x9 = 0x8201
+  ebreak
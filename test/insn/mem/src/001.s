@@ -0,0 +1,11 @@
+.global _start
+
+.text
+
+# misaligned load: checked model stops at it, x7 is left untouched
+
+_start:
+  li x5, 2
+  lw x6, 0(x5)
+  li x7, 1
+  ebreak
@@ -0,0 +1,11 @@
+.global _start
+
+.text
+
+# store past the end of memory: checked model stops at it, x7 is left untouched
+
+_start:
+  li x5, 0x7fff0000
+  sw x5, 0(x5)
+  li x7, 1
+  ebreak
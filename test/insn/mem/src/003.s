@@ -0,0 +1,12 @@
+.global _start
+
+.text
+
+# pushes until stack is over: with no stack the first push is out of bounds,
+# with stack set up the model stops at its canary
+
+_start:
+push:
+  addi sp, sp, -16
+  sw x0, 0(sp)
+  j push
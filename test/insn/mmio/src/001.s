@@ -0,0 +1,32 @@
+.global _start
+
+.text
+
+# devices of QEMU virt: UART prints, CLINT keeps mtimecmp and counts mtime
+# in retired insns, syscon stops the model with exit status 3
+
+_start:
+  lui x5, 0x10000          # UART
+  li x6, 'H'
+  sb x6, 0(x5)
+  li x6, 'i'
+  sb x6, 0(x5)
+  lbu x10, 5(x5)           # x10 = 0x60, transmitter is idle
+
+  lui x7, 0x2004           # CLINT mtimecmp
+  li x6, 1000
+  sw x6, 0(x7)
+  sw x0, 4(x7)
+  lw x11, 0(x7)            # x11 = 1000
+  lw x12, 4(x7)            # x12 = 0
+  j time                   # block ends, so its insns are counted by mtime
+
+time:
+  lui x7, 0x200c
+  lw x13, -8(x7)           # x13 = mtime = 13 retired insns
+
+  lui x5, 0x100            # syscon
+  li x6, 0x33333           # fail with status 3
+  sw x6, 0(x5)
+  li x14, 1                # not executed
+  ebreak
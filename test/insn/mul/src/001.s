@@ -0,0 +1,18 @@
+.global _start
+
+.text
+
+_start:
+  addi x11, x0, -3    # x11 = -3
+  addi x12, x0, 7     # x12 = 7
+  lui x13, 0x80000    # x13 = INT_MIN
+
+  mul x10, x11, x12   # x10 = -21
+  mulh x14, x11, x12  # x14 = -1 (sign of -21)
+  mulhu x15, x11, x12 # x15 = 6 (0xfffffffd * 7 >> 32)
+  mulhsu x16, x11, x12 # x16 = -1
+  mulhsu x17, x12, x11 # x17 = 6 (7 * 0xfffffffd >> 32)
+  mulh x18, x13, x13  # x18 = 0x40000000
+  mul x19, x13, x13   # x19 = 0
+
+  ebreak
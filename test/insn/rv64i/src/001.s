@@ -0,0 +1,59 @@
+.global _start
+
+.text
+
+# RV64I and RV64M: 64-bit ops, 32-bit *w ops with sign extended results,
+# doubleword loads and stores, RV64C forms
+
+_start:
+  auipc x8, 0
+  addi x8, x8, 512        # scratch area past the code
+  addi x2, x8, 256        # sp for c.ldsp and c.sdsp
+
+  li x5, 0x7fffffff
+  addiw x10, x5, 1        # x10 = 0xffffffff80000000
+  addi x11, x5, 1         # x11 = 0x0000000080000000
+  lui x12, 0x80000        # x12 = 0xffffffff80000000
+  slli x13, x11, 31       # x13 = 0x4000000000000000
+  srai x14, x12, 40       # x14 = -1
+  srli x6, x12, 32        # x6 = 0x00000000ffffffff
+
+  sd x12, 0(x8)
+  lw x16, 0(x8)           # x16 = 0xffffffff80000000
+  lwu x17, 0(x8)          # x17 = 0x0000000080000000
+  ld x18, 0(x8)           # x18 = 0xffffffff80000000
+
+  addw x19, x5, x5        # x19 = -2
+  subw x20, x12, x5       # x20 = 1
+  sllw x21, x5, x5        # shamt 31: x21 = 0xffffffff80000000
+  srlw x22, x12, x5       # x22 = 1
+  sraw x23, x12, x5       # x23 = -1
+  sraiw x24, x11, 4       # x24 = 0xfffffffff8000000
+
+  mul x25, x13, x13       # x25 = 0
+  mulhu x26, x13, x13     # x26 = 0x1000000000000000
+  mulh x27, x12, x13      # x27 = 0xffffffffe0000000
+  mulw x28, x5, x5        # x28 = 1
+  divw x29, x12, x14      # overflow: x29 = 0xffffffff80000000
+  remuw x30, x14, x0      # by zero: x30 = -1 (dividend sign extended)
+  divu x31, x6, x0        # by zero: x31 = -1
+
+  # compressed forms
+  li x9, 3
+  c.addiw x9, -4          # x9 = -1
+  c.sd x9, 8(x8)
+  c.ld x15, 8(x8)         # -1
+  c.subw x15, x9          # 0
+  c.addw x15, x14         # x15 = -1
+  c.sdsp x13, 16(sp)
+  c.ldsp x1, 16(sp)       # x1 = 0x4000000000000000
+  c.ldsp x9, 16(sp)
+  c.srai x9, 33           # x9 = 0x20000000
+  li x7, -1
+  c.slli x7, 40           # x7 = 0xffffff0000000000
+
+  sltiu x3, x12, -1       # x3 = 1
+  csrr x4, instret        # x4 = 41, full 64 bits
+  sd x4, 24(x8)
+
+  ebreak
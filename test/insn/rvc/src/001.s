@@ -0,0 +1,57 @@
+.option norelax
+.global _start
+
+.text
+
+# compressed insns mixed with 32-bit ones, which then lie at 2-aligned addresses
+
+_start:
+  c.li a0, 5          # a0 = 5
+  c.addi a0, -2       # a0 = 3
+  c.lui a1, 0x1       # a1 = 0x1000
+  c.mv a2, a0         # a2 = 3
+  c.add a2, a0        # a2 = 6
+  c.slli a2, 4        # a2 = 96
+  c.srli a2, 2        # a2 = 24
+  c.li a3, -16        # a3 = -16
+  c.srai a3, 2        # a3 = -4
+  c.andi a3, 7        # a3 = 4
+  c.sub a2, a3        # a2 = 20
+  c.xor a3, a0        # a3 = 7
+  c.or a3, a2         # a3 = 23
+  c.and a3, a0        # a3 = 3
+  c.nop
+  c.nop               # word accesses below must be aligned
+
+  # memory
+  auipc sp, 0
+  c.addi16sp sp, 128  # sp = scratch area past the code
+  c.swsp a2, 4(sp)
+  c.lwsp a4, 4(sp)    # a4 = 20
+  c.addi4spn s0, sp, 4
+  c.lw s1, 0(s0)      # s1 = 20
+  c.sw a0, 4(s0)
+  c.lw a1, 4(s0)      # a1 = 3
+
+  # control transfer
+  c.jal func          # ra = pc + 2
+  c.beqz a5, 1f       # a5 = 0, taken
+  c.li a4, 1          # skipped
+1:
+  c.bnez a0, 2f       # taken
+  c.li a4, 2          # skipped
+2:
+  addi t0, x0, 7      # t0 = 7
+  c.j 3f
+  c.li a4, 3          # skipped
+
+func:
+  c.li a5, 0          # a5 = 0
+  c.jr ra
+
+3:
+  auipc t1, 0         # 32-bit, 2-aligned
+  addi t1, t1, 10     # t1 = address of c.ebreak (addi is compressed too)
+  c.jalr t1           # ra = pc + 2
+  c.li a4, 4          # skipped
+  c.ebreak
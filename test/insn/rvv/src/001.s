@@ -0,0 +1,84 @@
+.global _start
+
+.text
+
+# RVV subset: results are moved to x registers and stored to memory,
+# as v registers are not a part of bstate
+
+_start:
+  auipc x8, 0
+  addi x8, x8, 512        # scratch area past the code
+  addi x9, x8, 128        # store area
+
+  # bytes 1..64 at x8
+  li x5, 0x04030201
+  li x6, 0x04040404
+  addi x7, x8, 0
+  addi x29, x8, 64
+fill:
+  sw x5, 0(x7)
+  add x5, x5, x6
+  addi x7, x7, 4
+  bne x7, x29, fill
+
+  # SEW 8, LMUL 1
+  vsetvli x10, x0, e8, m1, ta, ma  # x10 = VLMAX = 32
+  vle8.v v1, (x8)                  # 1..32
+  vadd.vv v2, v1, v1               # 2..64
+  vredsum.vs v3, v2, v0            # 1056 mod 256 = 32
+  vmv.x.s x11, v3                  # x11 = 32
+  li x12, 3
+  vmul.vx v4, v1, x12              # 3..96
+  vredmaxu.vs v5, v4, v0
+  vmv.x.s x13, v5                  # x13 = 96
+  vxor.vi v6, v1, -1               # ~1..~32
+  vredminu.vs v7, v6, v6           # ~32 = 0xdf
+  vmv.x.s x14, v7                  # x14 = -33 (sign extended)
+  vredmax.vs v7, v6, v6
+  vmv.x.s x15, v7                  # x15 = -2
+  vse8.v v6, (x9)
+
+  # SEW 16, LMUL 2, vl < VLMAX
+  li x5, 20
+  vsetvli x16, x5, e16, m2, ta, ma # x16 = 20
+  vle16.v v8, (x8)
+  vsub.vx v10, v8, x12
+  vredsum.vs v12, v10, v0
+  vmv.x.s x17, v12                 # x17 = 0xffffa554 (sign extended from 16 bits)
+  vse16.v v10, (x9)                # overwrites first 40 bytes only
+  lw x18, 0(x9)                    # x18 = 0x040001fe
+  lw x19, 40(x9)                   # x19 = 0, past both stores
+
+  # SEW 32, LMUL 1
+  vsetivli x20, 5, e32, m1, ta, ma # x20 = 5
+  vle32.v v16, (x8)
+  vand.vi v17, v16, 15             # 1, 5, 9, 13, 1
+  vredor.vs v18, v17, v0
+  vmv.x.s x21, v18                 # x21 = 13
+  vmv.v.i v19, 7
+  vor.vv v20, v16, v19
+  vredand.vs v21, v20, v19
+  vmv.x.s x22, v21                 # x22 = 7 & (words | 7) = 7
+  vmul.vv v22, v16, v17
+  vredsum.vs v23, v22, v0
+  vmv.x.s x23, v22                 # x23 = 0x04030201
+  vmv.x.s x30, v23                 # x30 = 0x7d604325
+  vmv.v.x v24, x12
+  vadd.vv v25, v24, v17            # 4, 8, 12, 16, 4
+  vredminu.vs v26, v25, v24
+  vmv.x.s x31, v26                 # x31 = 3
+  vmv.v.v v27, v25
+  vxor.vx v27, v27, x12
+  vor.vi v27, v27, 1
+  vse32.v v27, (x9)                # 7, 11, 15, 19, 7
+
+  csrr x24, vl                     # x24 = 5
+  csrr x25, vtype                  # x25 = 0xd0
+  csrr x26, vlenb                  # x26 = 32
+
+  # SEW 64 is wider than ELEN: vill
+  li x6, 0x18
+  vsetvl x27, x5, x6               # x27 = 0
+  csrr x28, vtype                  # x28 = 0x80000000
+
+  ebreak
@@ -0,0 +1,13 @@
+.global _start
+
+.text
+
+# counts forever in blocks of 4 insns, events stop the model in the middle
+# of a block, so x5..x7 show how many insns have been retired
+
+_start:
+1:
+  addi x5, x5, 1
+  addi x6, x6, 2
+  addi x7, x7, 3
+  j 1b
@@ -0,0 +1,77 @@
+.global _start
+
+.text
+
+# M-mode traps with CLINT: exceptions are logged by cause in nibbles of s1,
+# interrupts in s2, the handler skips the trapped insn or the waiting loop
+
+_start:
+  j main
+
+handler:
+  csrr t0, mcause
+  bltz t0, 4f
+
+  slli s1, s1, 4
+  or s1, s1, t0
+  li t1, 5
+  bne t0, t1, 6f
+  csrr s3, mtval
+  j 6f
+
+4:
+  andi t0, t0, 0xf
+  slli s2, s2, 4
+  or s2, s2, t0
+  li t1, 7
+  bne t0, t1, 5f
+  li t1, -1                # timer is silenced by mtimecmp = -1
+  sw t1, 0(t4)
+  sw t1, 4(t4)
+  j 6f
+5:
+  sw x0, 0(t6)             # software one by msip = 0
+
+6:
+  csrr t1, mepc
+  addi t1, t1, 4
+  csrw mepc, t1
+  mret
+
+main:
+  li t0, 0x38              # handler, .text is loaded at 0x34
+  csrw mtvec, t0
+
+  li a0, 42
+  csrr a0, 0x7c0           # no such CSR: illegal, a0 is kept
+  .word 0                  # illegal
+  li a1, 7
+  lui t1, 0x40000
+  lw a1, 0(t1)             # access fault, a1 is kept, s3 = mtval
+  ecall
+  ebreak
+
+  lui t2, 0x200c           # CLINT mtime is at 0x200bff8
+  lw t3, -8(t2)
+  addi t3, t3, 20
+  lui t4, 0x2004           # mtimecmp = mtime + 20
+  sw t3, 0(t4)
+  sw x0, 4(t4)
+  li t5, 0x80              # MTIE
+  csrs mie, t5
+  csrsi mstatus, 8         # MIE
+1:
+  j 1b                     # waits for timer interrupt
+  csrr s5, mstatus         # s5 = 0x1888, mret has enabled interrupts again
+
+  lui t6, 0x2000           # CLINT msip
+  li t5, 8                 # MSIE
+  csrs mie, t5
+  li t3, 1
+  sw t3, 0(t6)
+2:
+  j 2b                     # waits for software interrupt
+
+  csrci mstatus, 8
+3:
+  j 3b                     # nothing can come, model stops
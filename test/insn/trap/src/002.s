@@ -0,0 +1,45 @@
+.global _start
+
+.text
+
+# vector loads and stores access memory element by element: faults are
+# logged by cause in nibbles of s1, mtval of the last one is in s2
+
+_start:
+  j main
+
+handler:
+  csrr t0, mcause
+  slli s1, s1, 4
+  or s1, s1, t0
+  csrr s2, mtval
+  csrr t1, mepc
+  addi t1, t1, 4
+  csrw mepc, t1
+  mret
+
+main:
+  li t0, 0x38              # handler, .text is loaded at 0x34
+  csrw mtvec, t0
+
+  auipc x8, 0
+  addi x8, x8, 256         # scratch area past the code
+  li t1, 0x04030201
+  sw t1, 0(x8)
+  sw t1, 12(x8)
+
+  vsetivli x0, 4, e32, m1, ta, ma
+  addi a2, x8, 16
+  vle32.v v1, (x8)         # 4 reads
+  vse32.v v1, (a2)         # 4 writes
+  lw a0, 0(a2)             # a0 = 0x04030201
+  lw a1, 12(a2)            # a1 = 0x04030201
+
+  lui t2, 0x40000
+  vle32.v v2, (t2)         # load access fault
+  vse32.v v1, (t2)         # store access fault
+  addi t3, x8, 2
+  vle32.v v2, (t3)         # misaligned, s2 = x8 + 2
+
+1:
+  j 1b                     # model stops
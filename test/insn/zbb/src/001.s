@@ -0,0 +1,48 @@
+.global _start
+
+.text
+
+# Zba and Zbb
+
+_start:
+  lui x11, 0x00f00    # x11 = 0x00f00000
+  addi x11, x11, 0x12 # x11 = 0x00f00012
+  addi x12, x0, -5    # x12 = 0xfffffffb
+  addi x13, x0, 3     # x13 = 3
+
+  # Zba
+  sh1add x5, x13, x12 # x5 = 1
+  sh2add x6, x13, x13 # x6 = 15
+  sh3add x7, x13, x12 # x7 = 19
+
+  # Zbb logic with negate
+  andn x14, x11, x13  # x14 = 0x00f00010
+  orn x15, x0, x13    # x15 = 0xfffffffc
+  xnor x16, x12, x13  # x16 = 7
+
+  # min/max
+  min x17, x12, x13   # x17 = -5
+  minu x18, x12, x13  # x18 = 3
+  max x19, x12, x13   # x19 = 3
+  maxu x20, x12, x13  # x20 = 0xfffffffb
+
+  # bit counts
+  clz x21, x11        # x21 = 8
+  ctz x22, x11        # x22 = 1
+  cpop x23, x11       # x23 = 6
+  clz x24, x0         # x24 = 32
+  ctz x25, x0         # x25 = 32
+
+  # rotates
+  rol x26, x11, x13   # x26 = 0x07800090
+  ror x27, x11, x13   # x27 = 0x401e0002
+  rori x28, x12, 4    # x28 = 0xbfffffff
+
+  # byte and extension ops
+  orc.b x29, x11      # x29 = 0x00ff00ff
+  rev8 x30, x11       # x30 = 0x1200f000
+  sext.b x31, x12     # x31 = -5
+  sext.h x8, x11      # x8 = 0x00000012
+  zext.h x9, x12      # x9 = 0x0000fffb
+
+  ebreak
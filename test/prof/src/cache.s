@@ -0,0 +1,23 @@
+.option norelax
+.global _start
+
+.section .text
+
+# two passes over 128 bytes: 2 lines of 64 bytes are missed once
+
+_start:
+  addi x7, x0, 2
+
+outer:
+  addi x5, x0, 0
+  addi x6, x0, 128
+
+inner:
+  lw x10, 0(x5)
+  addi x5, x5, 4
+  bne x5, x6, inner
+
+  addi x7, x7, -1
+  bne x7, x0, outer
+
+  ebreak
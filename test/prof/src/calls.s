@@ -0,0 +1,23 @@
+.option norelax
+.global _start
+
+.section .text
+
+_start:
+  jal ra, f  # _start -> f -> g
+  jal ra, g  # _start -> g
+
+  ebreak
+
+f:
+  addi x10, x10, 1
+  add x5, x0, ra
+
+  jal ra, g
+
+  add ra, x0, x5
+  ret
+
+g:
+  addi x11, x11, 1
+  ret
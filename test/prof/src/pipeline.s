@@ -0,0 +1,21 @@
+.option norelax
+.global _start
+
+.section .text
+
+_start:
+  auipc x5, 0
+  addi x5, x5, 36    # x5 = buf
+  lw x10, 0(x5)
+  add x11, x10, x10  # load-use
+  lw x12, 4(x5)
+  addi x13, x0, 1    # independent of x12
+  sw x13, 8(x5)
+
+  jal x0, next       # jump penalty
+
+next:
+  ebreak
+
+buf:
+  .word 21, 5, 0
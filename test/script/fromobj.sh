@@ -3,10 +3,13 @@
 # usage
 # ./fromobj.sh $MODEL_SIGN $INPUT_REG $MEM_SIGN $INPUT_ASM.o > somewhere 
 #               const      registers   const     OBJECT  
+# XLEN=64 ./fromobj.sh ... for RV64 model (8-byte pc)
+
+XLEN=${XLEN:-32}
 
 START_PC=$(riscv32-elf-objdump $4 -h | grep .text | awk '{print $6}')
 echo "# start pc = $START_PC" 1>&2
 
 wait 
-cat $1 <(printf "%08x" "0x$START_PC" | tac -rs .. | tr -d '\n' | xxd -r -p) $2 $3 $4
+cat $1 <(printf "%0$((XLEN / 4))x" "0x$START_PC" | tac -rs .. | tr -d '\n' | xxd -r -p) $2 $3 $4
 
@@ -2,10 +2,13 @@
 
 # usage
 # ./mkelf.sh <asm file> <output destination>
+# XLEN=64 ./mkelf.sh ... for RV64 model
 
 set -e
 
-riscv32-elf-as $1 -o $1.o -fno-pic
-riscv32-elf-ld $1.o -o $2 -static --no-relax
+XLEN=${XLEN:-32}
+
+riscv$XLEN-elf-as $1 -o $1.o -fno-pic
+riscv$XLEN-elf-ld $1.o -o $2 -static --no-relax
 
 rm -fv $1.o 1>&2
@@ -2,6 +2,7 @@
 
 # usage:
 # ./testgen.sh ../insn/add/src/001.s > ../insn/add/001.bstate
+# XLEN=64 ./testgen.sh ../insn/rv64i/src/001.s > ../insn/rv64i/001.bstate
 
 echoerr() { echo "$@" 1>&2; }
 
@@ -11,10 +12,19 @@ set -e # exit on error
 INPUT_ASM=$1
 N_ARGS=$#
 
+export XLEN=${XLEN:-32}
+
 INPUT_REG="regs_zero.bin"
 
 MODEL_SIGN="MODEL_SIGN.bin"
 MEM_SIGN="MEM_SIGN.bin"
+AS="riscv32-elf-as"
+
+if [ $XLEN -eq 64 ]; then
+  INPUT_REG="regs_zero64.bin"
+  MODEL_SIGN="MODEL_SIGN64.bin"
+  AS="riscv64-elf-as"
+fi
 
 if [ $N_ARGS -ge 2 ]; then
   INPUT_REG=$2
@@ -29,7 +39,7 @@ echoerr "# memory sign = \"$MEM_SIGN\""
 
 OUTPUT_ELF=$INPUT_ASM.elf
 
-riscv32-elf-as $INPUT_ASM -o $INPUT_ASM.o
+$AS $INPUT_ASM -o $INPUT_ASM.o
 wait
 START_PC=$(objdump $INPUT_ASM.o -h | grep .text | awk '{print $6}')
 # riscv32-elf-ld $INPUT_ASM.o -o $OUTPUT_ELF